@@ -1,6 +1,10 @@
 #include "SuqsObjectiveState.h"
+
+#include <algorithm>
+#include "Suqs.h"
 #include "SuqsProgression.h"
 #include "SuqsTaskState.h"
+#include "SuqsTaskStateStore.h"
 
 void USuqsObjectiveState::Initialise(const FSuqsObjective* ObjDef, USuqsQuestState* QuestState,
 	USuqsProgression* Root)
@@ -10,39 +14,525 @@ void USuqsObjectiveState::Initialise(const FSuqsObjective* ObjDef, USuqsQuestSta
 	Progression = Root;
 
 	Status = ESuqsObjectiveStatus::NotStarted;
-	MandatoryTasksNeededToComplete = AreAllMandatoryTasksRequired() ? 0 : ObjDef->NumberOfMandatoryTasksRequired;
+	TaskCounts.Reset();
+	UncountedTasks.Reset();
+
+	const auto CQ = QuestState->GetCompiledDefinition();
+	const bool bCompiled = CQ && FirstCompiledTask >= 0;
+	if (bCompiled)
+		MandatoryTasksNeededToComplete = CQ->ObjectiveMandatoryTasksNeeded[ObjectiveIndex];
+	else
+		MandatoryTasksNeededToComplete = AreAllMandatoryTasksRequired() ? 0 : ObjDef->NumberOfMandatoryTasksRequired;
 
-	for (const auto& TaskDef : ObjDef->Tasks)
+	// Task slots & any task objects are re-used like objectives, see USuqsQuestState::Initialise
+	const int NumTasks = ObjDef->Tasks.Num();
+	if (TaskSlots.Num() != NumTasks)
 	{
-		auto Task = NewObject<USuqsTaskState>(GetOuter());
-		Task->Initialise(&TaskDef, this, Root);
-		Tasks.Add(Task);
+		// Task objects made for the old tasks mustn't go on viewing the new ones
+		for (auto Task : Tasks)
+		{
+			if (Task)
+				Task->Detach();
+		}
+		Tasks.Reset();
+		ReleaseTaskSlots();
+		AllocateTaskSlots(NumTasks);
+	}
+
+	FSuqsTaskStateStore& Store = Root->GetTaskStateStore();
+	const auto Instance = Root->GetQuestInstance(QuestState->GetIdentifier());
+	for (int i = 0; i < NumTasks; ++i)
+	{
+		const FSuqsTask& TaskDef = ObjDef->Tasks[i];
+		const int32 Slot = TaskSlots[i];
+		// May be re-used, so back to the initial state without raising any events
+		Store.ResetSlot(Slot);
+		Store.TargetNumber[Slot] = TaskDef.TargetNumber;
+		if (Instance)
+		{
+			if (const int* pTarget = Instance->TaskTargetNumbers.Find(TaskDef.Identifier))
+				Store.TargetNumber[Slot] = FMath::Max(1, *pTarget);
+		}
+		if (HasTaskObject(i))
+			Tasks[i]->Initialise(&TaskDef, GetCompiledTask(i), this, Root);
 
-		if (AreAllMandatoryTasksRequired() && TaskDef.bMandatory)
+		if (!bCompiled && AreAllMandatoryTasksRequired() && TaskDef.bMandatory)
 			++MandatoryTasksNeededToComplete;
 	}
+	for (int i = 0; i < NumTasks; ++i)
+	{
+		ResetTask(i);
+	}
 
-	NotifyTaskStatusChanged(nullptr);
+	NotifyTaskStatusChanged(INDEX_NONE);
 	
 }
 
-void USuqsObjectiveState::FinishLoad()
+void USuqsObjectiveState::RebindDefinition(const FSuqsObjective* ObjDef)
+{
+	ObjectiveDefinition = ObjDef;
+	for (int i = 0; i < Tasks.Num(); ++i)
+	{
+		if (Tasks[i])
+			Tasks[i]->TaskDefinition = &ObjDef->Tasks[i];
+	}
+}
+
+void USuqsObjectiveState::AllocateTaskSlots(int NumTasks)
+{
+	FSuqsTaskStateStore& Store = GetTaskStore();
+	TaskSlots.SetNumUninitialized(NumTasks);
+	for (int i = 0; i < NumTasks; ++i)
+	{
+		TaskSlots[i] = Store.Allocate();
+	}
+}
+
+void USuqsObjectiveState::ReleaseTaskSlots()
+{
+	// If the progression has gone, so has the store
+	if (Progression.IsValid())
+	{
+		FSuqsTaskStateStore& Store = GetTaskStore();
+		for (const int32 Slot : TaskSlots)
+		{
+			Store.Release(Slot);
+		}
+	}
+	TaskSlots.Reset();
+}
+
+void USuqsObjectiveState::BeginDestroy()
+{
+	ReleaseTaskSlots();
+	Super::BeginDestroy();
+}
+
+FSuqsTaskStateStore& USuqsObjectiveState::GetTaskStore() const
+{
+	return Progression->GetTaskStateStore();
+}
+
+const FSuqsCompiledTask* USuqsObjectiveState::GetCompiledTask(int TaskIndex) const
+{
+	if (FirstCompiledTask < 0 || !ParentQuest.IsValid() || !ParentQuest->IsCompiledDefinitionCurrent())
+		return nullptr;
+	return Progression->GetCompiledTask(Progression->GetTaskHandleByIndex(FirstCompiledTask + TaskIndex));
+}
+
+FText USuqsObjectiveState::GetTaskTitle(int TaskIndex) const
+{
+	if (HasTaskObject(TaskIndex))
+		return Tasks[TaskIndex]->GetTitle();
+
+	const FSuqsTask& TaskDef = GetTaskDefinition(TaskIndex);
+	const auto CompiledTask = GetCompiledTask(TaskIndex);
+	const bool bNeedsFormatting = CompiledTask ?
+		CompiledTask->bTitleNeedsFormatting : USuqsProgression::GetTextNeedsFormatting(TaskDef.Title);
+	if (bNeedsFormatting && Progression.IsValid() && ParentQuest.IsValid())
+		return Progression->FormatTaskText(ParentQuest->GetIdentifier(), TaskDef.Identifier, TaskDef.Title);
+	return TaskDef.Title;
+}
+
+USuqsTaskState* USuqsObjectiveState::GetTask(int TaskIndex) const
+{
+	if (!TaskSlots.IsValidIndex(TaskIndex))
+		return nullptr;
+
+	if (!HasTaskObject(TaskIndex))
+	{
+		// Only a view of the task's state, so creating it doesn't change this objective as far as callers can tell
+		const auto MutableThis = const_cast<USuqsObjectiveState*>(this);
+		// Not even the list is kept until a task is needed
+		MutableThis->Tasks.SetNumZeroed(TaskSlots.Num());
+		auto Task = NewObject<USuqsTaskState>(GetOuter());
+		Task->TaskIndex = TaskIndex;
+		Task->Initialise(&ObjectiveDefinition->Tasks[TaskIndex], GetCompiledTask(TaskIndex), MutableThis, Progression.Get());
+		MutableThis->Tasks[TaskIndex] = Task;
+	}
+	return Tasks[TaskIndex];
+}
+
+const TArray<USuqsTaskState*>& USuqsObjectiveState::GetTasks() const
+{
+	for (int i = 0; i < TaskSlots.Num(); ++i)
+	{
+		GetTask(i);
+	}
+	return Tasks;
+}
+
+TArrayView<USuqsTaskState* const> USuqsObjectiveState::GetTasksView() const
+{
+	return GetTasks();
+}
+
+int USuqsObjectiveState::GetTaskNumber(int TaskIndex) const
+{
+	return GetTaskStore().Number[TaskSlots[TaskIndex]];
+}
+
+int USuqsObjectiveState::GetTaskTargetNumber(int TaskIndex) const
+{
+	return GetTaskStore().TargetNumber[TaskSlots[TaskIndex]];
+}
+
+float USuqsObjectiveState::GetTaskTimeRemaining(int TaskIndex) const
+{
+	return GetTaskStore().TimeRemaining[TaskSlots[TaskIndex]];
+}
+
+ESuqsTaskStatus USuqsObjectiveState::GetTaskStatus(int TaskIndex) const
+{
+	return GetTaskStore().Status[TaskSlots[TaskIndex]];
+}
+
+bool USuqsObjectiveState::GetTaskHidden(int TaskIndex) const
+{
+	return GetTaskStore().Hidden[TaskSlots[TaskIndex]];
+}
+
+const FSuqsResolveBarrier& USuqsObjectiveState::GetTaskResolveBarrier(int TaskIndex) const
+{
+	return GetTaskStore().ResolveBarrier[TaskSlots[TaskIndex]];
+}
+
+bool USuqsObjectiveState::IsTaskIncomplete(int TaskIndex) const
+{
+	const ESuqsTaskStatus TaskStatus = GetTaskStatus(TaskIndex);
+	return TaskStatus != ESuqsTaskStatus::Completed && TaskStatus != ESuqsTaskStatus::Failed;
+}
+
+bool USuqsObjectiveState::IsTaskRelevant(int TaskIndex) const
+{
+	return
+		IsTaskIncomplete(TaskIndex) &&
+		!GetTaskHidden(TaskIndex) &&
+		ParentQuest->GetCurrentObjective() == this &&
+		ParentQuest->IsIncomplete();
+}
+
+bool USuqsObjectiveState::IsTaskResolveBlocked(int TaskIndex) const
+{
+	const FSuqsResolveBarrier& Barrier = GetTaskResolveBarrier(TaskIndex);
+	return !IsTaskIncomplete(TaskIndex) &&
+		Barrier.Conditions > 0 &&
+		Barrier.bPending;
+}
+
+bool USuqsObjectiveState::IsTaskHiddenOnCompleteOrFail(int TaskIndex) const
+{
+	const FSuqsTask& TaskDef = GetTaskDefinition(TaskIndex);
+	return !TaskDef.bAlwaysVisible && TaskDef.bMandatory && AreTasksSequential();
+}
+
+void USuqsObjectiveState::TickTask(int TaskIndex, float DeltaTime)
+{
+	FSuqsTaskStateStore& Store = GetTaskStore();
+	const int32 Slot = TaskSlots[TaskIndex];
+	// Don't reduce time when task is hidden (e.g. not the next in sequence)
+	// Also not when also completed / failed
+	if (!Store.Hidden[Slot] &&
+		IsTaskIncomplete(TaskIndex) &&
+		GetTaskDefinition(TaskIndex).TimeLimit > 0 &&
+		Store.TimeRemaining[Slot] > 0)
+	{
+		SetTaskTimeRemaining(TaskIndex, Store.TimeRemaining[Slot] - DeltaTime);
+	}
+
+	if (IsTaskResolveBlockedOn(TaskIndex, ESuqsResolveBarrierCondition::Time))
+	{
+		FSuqsResolveBarrier& Barrier = Store.ResolveBarrier[Slot];
+		Barrier.TimeRemaining = FMath::Max(Barrier.TimeRemaining - DeltaTime, 0.f);
+		MaybeNotifyTaskStatusChange(TaskIndex);
+	}
+}
+
+bool USuqsObjectiveState::IsTaskTickRequired(int TaskIndex) const
+{
+	// Only tasks on the current objective tick
+	if (!ParentQuest.IsValid() || ParentQuest->GetCurrentObjective() != this)
+		return false;
+
+	// Same conditions as TickTask
+	const FSuqsTaskStateStore& Store = GetTaskStore();
+	const int32 Slot = TaskSlots[TaskIndex];
+	const bool bTimeLimitRunning = !Store.Hidden[Slot] && IsTaskIncomplete(TaskIndex) &&
+		GetTaskDefinition(TaskIndex).TimeLimit > 0 && Store.TimeRemaining[Slot] > 0;
+	const bool bBarrierRunning = IsTaskResolveBlockedOn(TaskIndex, ESuqsResolveBarrierCondition::Time) &&
+		Store.ResolveBarrier[Slot].TimeRemaining > 0;
+	return bTimeLimitRunning || bBarrierRunning;
+}
+
+void USuqsObjectiveState::SetTaskTimeRemaining(int TaskIndex, float T)
+{
+	FSuqsTaskStateStore& Store = GetTaskStore();
+	const int32 Slot = TaskSlots[TaskIndex];
+	const FSuqsTask& TaskDef = GetTaskDefinition(TaskIndex);
+	const float PrevTime = Store.TimeRemaining[Slot];
+	// Clamp to 0, but allow higher than taskdef time limit if desired
+	Store.TimeRemaining[Slot] = std::max(0.f, T);
+
+	if (TaskDef.TimeLimit > 0 && Store.TimeRemaining[Slot] < PrevTime)
+	{
+		Progression->RaiseTaskUpdated(this, TaskIndex);
+		if (Store.TimeRemaining[Slot] <= 0)
+		{
+			Store.TimeRemaining[Slot] = 0;
+			if (TaskDef.TimeLimitCompleteOnExpiry)
+			{
+				CompleteTask(TaskIndex);
+			}
+			else
+			{
+				FailTask(TaskIndex);
+			}
+		}
+	}
+	else if (Store.TimeRemaining[Slot] > PrevTime)
+	{
+		// Time may have been added back, so the countdown needs to run again
+		Progression->ScheduleTick(this, TaskIndex);
+	}
+}
+
+void USuqsObjectiveState::SetTaskResolveBarrier(int TaskIndex, const FSuqsResolveBarrier& Barrier)
+{
+	GetTaskStore().ResolveBarrier[TaskSlots[TaskIndex]] = Barrier;
+	MarkTaskUncounted(TaskIndex);
+	// In case manually changing to free up
+	MaybeNotifyTaskStatusChange(TaskIndex);
+	Progression->ScheduleTick(this, TaskIndex);
+	Progression->WaitForGate(this, TaskIndex);
+}
+
+void USuqsObjectiveState::ChangeTaskStatus(int TaskIndex, ESuqsTaskStatus NewStatus, bool bIgnoreResolveBarriers)
+{
+	FSuqsTaskStateStore& Store = GetTaskStore();
+	const int32 Slot = TaskSlots[TaskIndex];
+	if (Store.Status[Slot] != NewStatus)
+	{
+		Store.Status[Slot] = NewStatus;
+		// We only re-count this when notified, which may not be until barriers are resolved
+		MarkTaskUncounted(TaskIndex);
+
+		switch(NewStatus)
+		{
+		case ESuqsTaskStatus::Completed: 
+			Progression->RaiseTaskCompleted(this, TaskIndex);
+			break;
+		case ESuqsTaskStatus::Failed:
+			Progression->RaiseTaskFailed(this, TaskIndex);
+			break;
+		default:
+			Progression->RaiseTaskUpdated(this, TaskIndex);
+			break;
+		}
+
+		QueueTaskStatusChangeNotification(TaskIndex, bIgnoreResolveBarriers);
+
+	}
+}
+
+void USuqsObjectiveState::QueueTaskStatusChangeNotification(int TaskIndex, bool bIgnoreBarriers)
+{
+	FSuqsTaskStateStore& Store = GetTaskStore();
+	const int32 Slot = TaskSlots[TaskIndex];
+	if (bIgnoreBarriers)
+	{
+		Store.ResolveBarrier[Slot] = FSuqsResolveBarrier();
+		Store.ResolveBarrier[Slot].bPending = true;
+	}
+	else
+	{
+		Store.ResolveBarrier[Slot] = Progression->GetResolveBarrierForTask(&GetTaskDefinition(TaskIndex), Store.Status[Slot]);
+	}
+
+	MaybeNotifyTaskStatusChange(TaskIndex);
+	Progression->ScheduleTick(this, TaskIndex);
+	Progression->WaitForGate(this, TaskIndex);
+	
+}
+
+bool USuqsObjectiveState::IsTaskResolveBlockedOn(int TaskIndex, ESuqsResolveBarrierCondition Barrier) const
+{
+	const FSuqsResolveBarrier& ResolveBarrier = GetTaskResolveBarrier(TaskIndex);
+	return ResolveBarrier.bPending &&
+	   (ResolveBarrier.Conditions & static_cast<uint32>(Barrier)) > 0;
+}
+
+void USuqsObjectiveState::MaybeNotifyTaskStatusChange(int TaskIndex)
+{
+	FSuqsResolveBarrier& ResolveBarrier = GetTaskStore().ResolveBarrier[TaskSlots[TaskIndex]];
+	// Early-out if barrier has already been processed so we only do this once per status change
+	if (!ResolveBarrier.bPending)
+		return;
+
+	// Assume cleared
+	bool bCleared = true;
+
+	// All conditions have to be fulfilled
+	if (IsTaskResolveBlockedOn(TaskIndex, ESuqsResolveBarrierCondition::Time))
+	{
+		if (ResolveBarrier.TimeRemaining > 0)
+		{
+			bCleared = false;
+		}
+	}
+	if (IsTaskResolveBlockedOn(TaskIndex, ESuqsResolveBarrierCondition::Gate))
+	{
+		if (!Progression->IsGateOpen(ResolveBarrier.Gate))
+		{
+			bCleared = false;
+		}
+	}
+	if (IsTaskResolveBlockedOn(TaskIndex, ESuqsResolveBarrierCondition::Explicit))
+	{
+		bCleared = ResolveBarrier.bGrantedExplicitly;
+	}
+	
+	if (bCleared)
+	{
+		ResolveBarrier.bPending = false;
+		// We may process this later if we're in a batch
+		if (!Progression->DeferObjectiveUpdate(this))
+			NotifyTaskStatusChanged(TaskIndex);
+	}
+}
+
+void USuqsObjectiveState::FailTask(int TaskIndex, bool bIgnoreResolveBarriers)
 {
-	for (auto T : Tasks)
+	ChangeTaskStatus(TaskIndex, ESuqsTaskStatus::Failed, bIgnoreResolveBarriers);
+}
+
+bool USuqsObjectiveState::CompleteTask(int TaskIndex, bool bIgnoreResolveBarriers)
+{
+	if (GetTaskStatus(TaskIndex) != ESuqsTaskStatus::Completed)
 	{
-		T->FinishLoad();
+		const FSuqsTask& TaskDef = GetTaskDefinition(TaskIndex);
+		// Skip validation when loading
+		if (!ParentQuest->IsLoading())
+		{
+			// Check sequencing
+			if (ParentQuest->GetCurrentObjective() != this)
+			{
+				UE_LOG(LogSUQS, Verbose, TEXT("Tried to complete task %s but parent objective %s is not current, ignoring"),
+					*TaskDef.Identifier.ToString(), *GetIdentifier().ToString())
+				return false;
+			}
+			if (AreTasksSequential())
+			{
+				// Only allowed if optional or next in sequence
+				if (TaskDef.bMandatory && GetNextMandatoryTaskIndex() != TaskIndex)
+				{
+					UE_LOG(LogSUQS, Warning, TEXT("Tried to complete mandatory task %s out of order, ignoring"), *TaskDef.Identifier.ToString())
+					return false;
+				}
+			}
+		}
+		FSuqsTaskStateStore& Store = GetTaskStore();
+		const int32 Slot = TaskSlots[TaskIndex];
+		Store.Number[Slot] = Store.TargetNumber[Slot];
+		ChangeTaskStatus(TaskIndex, ESuqsTaskStatus::Completed, bIgnoreResolveBarriers);
+	}
+	// Already completed
+	return true;
+}
+
+void USuqsObjectiveState::ResolveTask(int TaskIndex)
+{
+	GetTaskStore().ResolveBarrier[TaskSlots[TaskIndex]].bGrantedExplicitly = true;
+	MaybeNotifyTaskStatusChange(TaskIndex);
+}
+
+int USuqsObjectiveState::ProgressTask(int TaskIndex, int Delta)
+{
+	SetTaskNumber(TaskIndex, GetTaskNumber(TaskIndex) + Delta);
+
+	// Number should be limited already so don't waste time clamping
+	return GetTaskTargetNumber(TaskIndex) - GetTaskNumber(TaskIndex);
+}
+
+void USuqsObjectiveState::SetTaskNumber(int TaskIndex, int N)
+{
+	FSuqsTaskStateStore& Store = GetTaskStore();
+	const int32 Slot = TaskSlots[TaskIndex];
+	const int PrevNumber = Store.Number[Slot];
+	// Clamp
+	Store.Number[Slot] = std::min(std::max(0, N), Store.TargetNumber[Slot]);
+
+	if (PrevNumber != Store.Number[Slot])
+	{
+		Progression->RaiseTaskUpdated(this, TaskIndex);
+
+		if (Store.Number[Slot] == Store.TargetNumber[Slot])
+			CompleteTask(TaskIndex);
+		else
+			ChangeTaskStatus(TaskIndex, Store.Number[Slot] > 0 ? ESuqsTaskStatus::InProgress : ESuqsTaskStatus::NotStarted);
+		
 	}
 	
-	NotifyTaskStatusChanged(nullptr);
 }
 
-void USuqsObjectiveState::Tick(float DeltaTime)
+void USuqsObjectiveState::ResetTask(int TaskIndex)
 {
-	for (auto& Task : Tasks)
+	FSuqsTaskStateStore& Store = GetTaskStore();
+	const int32 Slot = TaskSlots[TaskIndex];
+	const float TimeLimit = GetTaskDefinition(TaskIndex).TimeLimit;
+	const bool bRaiseUpdate = Store.Number[Slot] > 0 || Store.TimeRemaining[Slot] < TimeLimit;
+	Store.Number[Slot] = 0;
+	Store.TimeRemaining[Slot] = TimeLimit;
+	ChangeTaskStatus(TaskIndex, ESuqsTaskStatus::NotStarted);
+
+	// There isn't an event for change status back to not started
+	if (bRaiseUpdate)
+		Progression->RaiseTaskUpdated(this, TaskIndex);
+
+	Progression->ScheduleTick(this, TaskIndex);
+
+}
+
+void USuqsObjectiveState::NotifyTaskGateOpened(int TaskIndex, const FName& GateName)
+{
+	if (IsTaskResolveBlockedOn(TaskIndex, ESuqsResolveBarrierCondition::Gate) &&
+		GetTaskResolveBarrier(TaskIndex).Gate == GateName)
+		MaybeNotifyTaskStatusChange(TaskIndex);
+}
+
+void USuqsObjectiveState::FinishTaskLoad(int TaskIndex)
+{
+	// Derive hidden from other state, since it's not saved
+	bool bHidden = false;
+	if (GetTaskDefinition(TaskIndex).bMandatory)
 	{
-		Task->Tick(DeltaTime);
+		if (IsTaskHiddenOnCompleteOrFail(TaskIndex) && !IsTaskIncomplete(TaskIndex))
+		{
+			bHidden = true;
+		}
+		else
+		{
+			// If incomplete, then this is hidden if we're set to sequential tasks and this isn't the next one
+			if (AreTasksSequential() && GetNextMandatoryTaskIndex() != TaskIndex)
+			{
+				bHidden = true;
+			}
+		}
 	}
+	GetTaskStore().Hidden[TaskSlots[TaskIndex]] = bHidden;
+
+	Progression->ScheduleTick(this, TaskIndex);
+}
 
+void USuqsObjectiveState::FinishLoad()
+{
+	// Tasks derive their hidden state from the next mandatory task, so get counts up to date first
+	RecountTasks();
+	for (int i = 0; i < TaskSlots.Num(); ++i)
+	{
+		FinishTaskLoad(i);
+	}
+	
+	NotifyTaskStatusChanged(INDEX_NONE);
 }
 
 
@@ -63,158 +553,308 @@ const FText& USuqsObjectiveState::GetDescription() const
 
 void USuqsObjectiveState::Reset()
 {
-	for (auto Task : Tasks)
+	for (int i = 0; i < TaskSlots.Num(); ++i)
 	{
 		// This will cause notifications
-		Task->Reset();
+		ResetTask(i);
 	}
 }
 
 void USuqsObjectiveState::FailOutstandingTasks()
 {
-	for (auto Task : Tasks)
+	for (int i = 0; i < TaskSlots.Num(); ++i)
 	{
-		if (Task->IsIncomplete() && !Task->bHidden)
+		if (IsTaskIncomplete(i) && !GetTaskHidden(i))
 		{
 			// Don't wait to resolve
-			Task->Fail(true);
+			FailTask(i, true);
 		}
 	}
 }
 
 void USuqsObjectiveState::CompleteAllMandatoryTasks()
 {
-	for (auto Task : Tasks)
+	for (int i = 0; i < TaskSlots.Num(); ++i)
 	{
-		if (Task->IsMandatory())
+		if (GetTaskDefinition(i).bMandatory)
 		{
 			// Override failed as well
 			// Immediately resolve, don't wait for barriers
-			Task->Complete(true);
+			CompleteTask(i, true);
 			if (!AreAllMandatoryTasksRequired())
 				break;
 		}
 	}	
 }
 
-USuqsTaskState* USuqsObjectiveState::GetNextMandatoryTask() const
+int USuqsObjectiveState::GetNextMandatoryTaskIndex() const
 {
-	for (auto Task : Tasks)
+	// Tasks before the next counted one can only have become incomplete again if they're uncounted
+	const int NumTasks = TaskSlots.Num();
+	int NextIndex = NumTasks;
+	const int StartIndex = TaskCounts.Num() == NumTasks ? NextMandatoryTaskIndex : 0;
+	for (int i = StartIndex; i < NumTasks; ++i)
+	{
+		if (IsTaskIncomplete(i) && GetTaskDefinition(i).bMandatory)
+		{
+			NextIndex = i;
+			break;
+		}
+	}
+	for (const int i : UncountedTasks)
 	{
-		if (Task->IsIncomplete() && Task->IsMandatory())
+		if (i < NextIndex && IsTaskIncomplete(i) && GetTaskDefinition(i).bMandatory)
 		{
-			return Task;
+			NextIndex = i;
 		}
 	}
-	return nullptr;
+	return NextIndex < NumTasks ? NextIndex : INDEX_NONE;
+}
+
+USuqsTaskState* USuqsObjectiveState::GetNextMandatoryTask() const
+{
+	const int NextIndex = GetNextMandatoryTaskIndex();
+	return NextIndex != INDEX_NONE ? GetTask(NextIndex) : nullptr;
+}
+
+USuqsObjectiveState::FTaskRange USuqsObjectiveState::GetRelevantTasksRange() const
+{
+	return FTaskRange(GetTasks(), [](USuqsTaskState* const& Task) { return !Task->GetHidden(); });
+}
+
+USuqsObjectiveState::FTaskRange USuqsObjectiveState::GetIncompleteTasksRange() const
+{
+	return FTaskRange(GetTasks(), [](USuqsTaskState* const& Task) { return Task->IsIncomplete(); });
+}
+
+USuqsObjectiveState::FTaskRange USuqsObjectiveState::GetCompletedTasksRange() const
+{
+	return FTaskRange(GetTasks(), [](USuqsTaskState* const& Task) { return Task->GetStatus() == ESuqsTaskStatus::Completed; });
+}
+
+USuqsObjectiveState::FTaskRange USuqsObjectiveState::GetFailedTasksRange() const
+{
+	return FTaskRange(GetTasks(), [](USuqsTaskState* const& Task) { return Task->GetStatus() == ESuqsTaskStatus::Failed; });
 }
 
 void USuqsObjectiveState::GetAllRelevantTasks(TArray<USuqsTaskState*>& RelevantTasksOut) const
 {
-	RelevantTasksOut.Empty();
-	for (auto Task : Tasks)
-	{
-		if (!Task->bHidden)
-			RelevantTasksOut.Add(Task);
-	}
+	RelevantTasksOut.Reset();
+	GetRelevantTasksRange().AppendTo(RelevantTasksOut);
 }
 
 
 void USuqsObjectiveState::GetIncompleteTasks(TArray<USuqsTaskState*>& IncompleteTasksOut) const
 {
-	IncompleteTasksOut.Empty();
-	for (auto Task : Tasks)
+	IncompleteTasksOut.Reset();
+	GetIncompleteTasksRange().AppendTo(IncompleteTasksOut);
+}
+
+void USuqsObjectiveState::GetCompletedTasks(TArray<USuqsTaskState*>& CompletedTasksOut) const
+{
+	CompletedTasksOut.Reset();
+	GetCompletedTasksRange().AppendTo(CompletedTasksOut);
+}
+
+void USuqsObjectiveState::GetFailedTasks(TArray<USuqsTaskState*>& FailedTasksOut) const
+{
+	FailedTasksOut.Reset();
+	GetFailedTasksRange().AppendTo(FailedTasksOut);
+}
+
+bool USuqsObjectiveState::IsOnActiveBranch() const
+{
+	return ParentQuest->IsObjectiveOnActiveBranch(this);
+}
+
+void USuqsObjectiveState::NotifyTaskStatusChanged(int ChangedTaskIndex)
+{
+	if (!TaskSlots.IsValidIndex(ChangedTaskIndex) || TaskCounts.Num() != TaskSlots.Num())
 	{
-		if (Task->IsIncomplete())
-			IncompleteTasksOut.Add(Task);
+		// Re-scan all our tasks
+		RecountTasks();
+		for (int i = 0; i < TaskSlots.Num(); ++i)
+		{
+			UpdateTaskHidden(i);
+		}
 	}
+	else
+	{
+		// Re-count the changed task, plus any others which changed but haven't resolved yet, so that the result
+		// is the same as re-scanning everything
+		const int PrevNextIndex = NextMandatoryTaskIndex;
+		TArray<int, TInlineAllocator<8>> ChangedIndexes(UncountedTasks);
+		UncountedTasks.Reset();
+		ChangedIndexes.AddUnique(ChangedTaskIndex);
+		for (const int i : ChangedIndexes)
+		{
+			UpdateTaskCount(i);
+		}
+
+		// Visibility can only change for those tasks and the next mandatory task, before & after
+		ChangedIndexes.AddUnique(PrevNextIndex);
+		ChangedIndexes.AddUnique(NextMandatoryTaskIndex);
+		// Raise events in task order
+		ChangedIndexes.Sort();
+		for (const int i : ChangedIndexes)
+		{
+			if (TaskSlots.IsValidIndex(i))
+				UpdateTaskHidden(i);
+		}
+	}
+
+	UpdateStatusFromTaskCounts();
 }
 
-void USuqsObjectiveState::GetCompletedTasks(TArray<USuqsTaskState*>& CompletedTasksOut) const
+ESuqsTaskCount USuqsObjectiveState::GetTaskCount(int TaskIndex) const
 {
-	CompletedTasksOut.Empty();
-	for (auto Task : Tasks)
+	if (!GetTaskDefinition(TaskIndex).bMandatory)
+		return ESuqsTaskCount::NotMandatory;
+
+	switch(GetTaskStatus(TaskIndex))
 	{
-		if (Task->GetStatus() == ESuqsTaskStatus::Completed)
-			CompletedTasksOut.Add(Task);
+	case ESuqsTaskStatus::Completed:
+		return GetTaskResolveBarrier(TaskIndex).bPending ? ESuqsTaskCount::CompletedPending : ESuqsTaskCount::Completed;
+	case ESuqsTaskStatus::Failed:
+		return ESuqsTaskCount::Failed;
+	default:
+		return ESuqsTaskCount::Incomplete;
 	}
 }
 
-void USuqsObjectiveState::GetFailedTasks(TArray<USuqsTaskState*>& FailedTasksOut) const
+void USuqsObjectiveState::AddTaskCount(ESuqsTaskCount Count, int Delta)
 {
-	FailedTasksOut.Empty();
-	for (auto Task : Tasks)
+	switch(Count)
 	{
-		if (Task->GetStatus() == ESuqsTaskStatus::Failed)
-			FailedTasksOut.Add(Task);
+	case ESuqsTaskCount::Incomplete:
+		MandatoryTasksIncomplete += Delta;
+		break;
+	case ESuqsTaskCount::Completed:
+		MandatoryTasksComplete += Delta;
+		break;
+	case ESuqsTaskCount::Failed:
+		MandatoryTasksFailed += Delta;
+		break;
+	default:
+		break;
 	}
 }
 
-bool USuqsObjectiveState::IsOnActiveBranch() const
+void USuqsObjectiveState::RecountTasks()
 {
-	return ParentQuest->IsBranchActive(GetBranch());
+	const int NumTasks = TaskSlots.Num();
+	TaskCounts.SetNumUninitialized(NumTasks);
+	UncountedTasks.Reset();
+	MandatoryTasksComplete = MandatoryTasksFailed = MandatoryTasksIncomplete = 0;
+	MandatoryTasksFailedBeforeNext = 0;
+	NextMandatoryTaskIndex = NumTasks;
+
+	for (int i = 0; i < NumTasks; ++i)
+	{
+		const ESuqsTaskCount Count = GetTaskCount(i);
+		TaskCounts[i] = Count;
+		AddTaskCount(Count, 1);
+
+		if (NextMandatoryTaskIndex == NumTasks)
+		{
+			if (Count == ESuqsTaskCount::Incomplete)
+				NextMandatoryTaskIndex = i;
+			else if (Count == ESuqsTaskCount::Failed)
+				++MandatoryTasksFailedBeforeNext;
+		}
+	}
 }
 
-void USuqsObjectiveState::NotifyTaskStatusChanged(const USuqsTaskState* ChangedTaskOrNull)
+void USuqsObjectiveState::UpdateTaskCount(int TaskIndex)
 {
-	// Re-scan our tasks and decide what this means for our own state
-	int MandatoryTasksFailed = 0;
-	int MandatoryTasksComplete = 0;
-	int IncompleteMandatoryTasks = 0;
-	for (auto& Task : Tasks)
+	const ESuqsTaskCount OldCount = TaskCounts[TaskIndex];
+	const ESuqsTaskCount NewCount = GetTaskCount(TaskIndex);
+	if (OldCount == NewCount)
+		return;
+
+	TaskCounts[TaskIndex] = NewCount;
+	AddTaskCount(OldCount, -1);
+	AddTaskCount(NewCount, 1);
+
+	if (TaskIndex < NextMandatoryTaskIndex)
 	{
-		const bool bPreviouslyHidden = Task->bHidden;
-		Task->bHidden = false;
-		if (Task->IsMandatory())
+		if (OldCount == ESuqsTaskCount::Failed)
+			--MandatoryTasksFailedBeforeNext;
+		if (NewCount == ESuqsTaskCount::Failed)
+			++MandatoryTasksFailedBeforeNext;
+
+		if (NewCount == ESuqsTaskCount::Incomplete)
 		{
-			switch(Task->Status)
+			// Gone backwards (e.g. reset), failures between here and the old next task no longer count
+			for (int i = TaskIndex + 1; i < NextMandatoryTaskIndex; ++i)
 			{
-			case ESuqsTaskStatus::Completed:
-				if (!Task->GetResolveBarrier().bPending)
-					++MandatoryTasksComplete;
-				if (Task->IsHiddenOnCompleteOrFail())
-					Task->bHidden = true;
-				break;
-			case ESuqsTaskStatus::Failed:
-				++MandatoryTasksFailed;
-				if (Task->IsHiddenOnCompleteOrFail())
-					Task->bHidden = true;
-				break;
-			case ESuqsTaskStatus::NotStarted:
-			case ESuqsTaskStatus::InProgress:
-				if (ObjectiveDefinition->bSequentialTasks &&
-					(IncompleteMandatoryTasks > 0 || MandatoryTasksFailed > 0))
-				{
-					// If tasks are sequential, and either there have been incomplete mandatory tasks before,
-					// or a failed mandatory task before, this task should be hidden because it's not actionable
-					Task->bHidden = true;
-				}
-				++IncompleteMandatoryTasks;
-				break;
-			default:
-				break;
+				if (TaskCounts[i] == ESuqsTaskCount::Failed)
+					--MandatoryTasksFailedBeforeNext;
 			}
+			NextMandatoryTaskIndex = TaskIndex;
 		}
-		if (bPreviouslyHidden != Task->bHidden)
+	}
+	else if (TaskIndex == NextMandatoryTaskIndex && NewCount != ESuqsTaskCount::Incomplete)
+	{
+		// Move forward to the next incomplete mandatory task, counting failures on the way (this one included)
+		while (NextMandatoryTaskIndex < TaskSlots.Num() && TaskCounts[NextMandatoryTaskIndex] != ESuqsTaskCount::Incomplete)
 		{
-			if (Task->bHidden)
-			{
-				// This task was hidden during this update
-				if (Progression.IsValid())
-					Progression->RaiseTaskRemoved(Task);
-				
-			}
-			else
+			if (TaskCounts[NextMandatoryTaskIndex] == ESuqsTaskCount::Failed)
+				++MandatoryTasksFailedBeforeNext;
+			++NextMandatoryTaskIndex;
+		}
+	}
+}
+
+void USuqsObjectiveState::UpdateTaskHidden(int TaskIndex)
+{
+	FSuqsTaskStateStore& Store = GetTaskStore();
+	const int32 Slot = TaskSlots[TaskIndex];
+	const bool bPreviouslyHidden = Store.Hidden[Slot];
+	bool bHidden;
+	switch(TaskCounts[TaskIndex])
+	{
+	case ESuqsTaskCount::NotMandatory:
+		bHidden = false;
+		break;
+	case ESuqsTaskCount::Incomplete:
+		// If tasks are sequential, and either there have been incomplete mandatory tasks before,
+		// or a failed mandatory task before, this task should be hidden because it's not actionable
+		bHidden = ObjectiveDefinition->bSequentialTasks &&
+			(TaskIndex != NextMandatoryTaskIndex || MandatoryTasksFailedBeforeNext > 0);
+		break;
+	default:
+		bHidden = IsTaskHiddenOnCompleteOrFail(TaskIndex);
+		break;
+	}
+
+	if (bPreviouslyHidden != bHidden)
+	{
+		Store.Hidden[Slot] = bHidden;
+		if (bHidden)
+		{
+			// This task was hidden during this update
+			if (Progression.IsValid())
+				Progression->RaiseTaskRemoved(this, TaskIndex);
+			
+		}
+		else
+		{
+			// This task became visible during this update
+			if (Progression.IsValid())
 			{
-				// This task became visible during this update
-				if (Progression.IsValid())
-					Progression->RaiseTaskAdded(Task);
+				Progression->RaiseTaskAdded(this, TaskIndex);
+				// Time limits only count down when visible
+				Progression->ScheduleTick(this, TaskIndex);
 			}
 		}
 	}
-	
+}
+
+void USuqsObjectiveState::UpdateStatusFromTaskCounts()
+{
 	if (MandatoryTasksFailed > 0 &&
-		(IncompleteMandatoryTasks + MandatoryTasksComplete) < MandatoryTasksNeededToComplete)
+		(MandatoryTasksIncomplete + MandatoryTasksComplete) < MandatoryTasksNeededToComplete)
 	{
 		ChangeStatus(ESuqsObjectiveStatus::Failed);
 	}
@@ -226,15 +866,20 @@ void USuqsObjectiveState::NotifyTaskStatusChanged(const USuqsTaskState* ChangedT
 	{
 		ChangeStatus(MandatoryTasksComplete > 0 ? ESuqsObjectiveStatus::InProgress : ESuqsObjectiveStatus::NotStarted);
 	}
+}
 
+void USuqsObjectiveState::MarkTaskUncounted(int TaskIndex)
+{
+	if (TaskCounts.IsValidIndex(TaskIndex))
+		UncountedTasks.AddUnique(TaskIndex);
 }
 
 void USuqsObjectiveState::NotifyGateOpened(const FName& GateName)
 {
 	// This one proceeds downards to children
-	for (auto Task : Tasks)
+	for (int i = 0; i < TaskSlots.Num(); ++i)
 	{
-		Task->NotifyGateOpened(GateName);
+		NotifyTaskGateOpened(i, GateName);
 	}
 	
 }
@@ -258,7 +903,9 @@ void USuqsObjectiveState::ChangeStatus(ESuqsObjectiveStatus NewStatus)
 
 		// No barriers on objectives, just tasks and quests
 		// Objectives are just groupings and inherit their behaviour from task
-		ParentQuest->NotifyObjectiveStatusChanged();
+		// Quest may process this later if we're in a batch
+		if (!Progression->DeferQuestUpdate(ParentQuest.Get()))
+			ParentQuest->NotifyObjectiveStatusChanged(this);
 		
 	}
 }
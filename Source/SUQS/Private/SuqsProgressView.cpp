@@ -20,6 +20,19 @@ void FSuqsTaskStateView::FromUObject(USuqsTaskState* State)
 	
 }
 
+void FSuqsTaskStateView::FromState(const USuqsObjectiveState* Objective, int TaskIndex)
+{
+	const FSuqsTask& TaskDef = Objective->GetTaskDefinition(TaskIndex);
+	Identifier = TaskDef.Identifier;
+	Title = Objective->GetTaskTitle(TaskIndex);
+	bMandatory = TaskDef.bMandatory;
+	TargetNumber = Objective->GetTaskTargetNumber(TaskIndex);
+	CompletedNumber = Objective->GetTaskNumber(TaskIndex);
+	TimeRemaining = Objective->GetTaskTimeRemaining(TaskIndex);
+	Status = Objective->GetTaskStatus(TaskIndex);
+	bHidden = Objective->GetTaskHidden(TaskIndex);
+}
+
 FSuqsQuestStateView::FSuqsQuestStateView()
 {
 }
@@ -58,16 +71,18 @@ void FSuqsQuestStateView::FromUObject(USuqsQuestState* State, bool bIncludeCompl
 	}
 	
 	CurrentTasks.Reset();
-	TArray<USuqsTaskState*> RelevantTasks;
 	for (auto& Obj : ObjectivesOfInterest)
 	{
 		if (Obj == CurrObj || (bIncludeCompletedObjectives && !Obj->IsIncomplete()))
 		{
-			Obj->GetAllRelevantTasks(RelevantTasks);
-			for (USuqsTaskState* TaskState : RelevantTasks)
+			// By index, so building a view doesn't create task states nothing else needs
+			for (int i = 0; i < Obj->GetNumTasks(); ++i)
 			{
-				auto& Task = CurrentTasks.AddDefaulted_GetRef();
-				Task.FromUObject(TaskState);
+				if (!Obj->GetTaskHidden(i))
+				{
+					auto& Task = CurrentTasks.AddDefaulted_GetRef();
+					Task.FromState(Obj, i);
+				}
 			}
 		}
 	}
@@ -80,12 +95,12 @@ FSuqsProgressView::FSuqsProgressView()
 
 void FSuqsProgressView::FromUObject(USuqsProgression* State, bool bIncludeCompletedObjectives)
 {
-	TArray<USuqsQuestState*> QuestStates;
-	State->GetAcceptedQuests(QuestStates);
+	const auto& QuestStates = State->GetAcceptedQuestMap();
 	ActiveQuests.Reset(QuestStates.Num());
 
-	for (USuqsQuestState* QuestState : QuestStates)
+	for (const auto& Pair : QuestStates)
 	{
+		USuqsQuestState* QuestState = Pair.Value;
 		if (QuestState->IsPlayerVisible())
 		{
 			auto& Quest = ActiveQuests.AddDefaulted_GetRef();
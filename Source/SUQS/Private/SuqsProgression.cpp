@@ -4,13 +4,20 @@
 
 
 #include "EngineUtils.h"
+#include "AssetRegistry/AssetRegistryModule.h"
+#include "Engine/AssetManager.h"
 #include "Suqs.h"
 #include "SuqsObjectiveState.h"
+#include "SuqsQuestCatalog.h"
+#include "SuqsQuestJsonImporter.h"
 #include "SuqsQuestState.h"
 #include "SuqsTaskState.h"
 #include "SuqsWaypointComponent.h"
 #include "SuqsWaypointSubsystem.h"
+#include "Algo/BinarySearch.h"
+#include "Async/ParallelFor.h"
 #include "Kismet/GameplayStatics.h"
+#include "Misc/FileHelper.h"
 
 #define SuqsCurrentDataVersion 1
 
@@ -18,6 +25,7 @@
 void USuqsProgression::InitWithQuestDataTables(TArray<UDataTable*> Tables)
 {
 	QuestDataTables = Tables;
+	QuestCatalogData.Empty();
 	RebuildAllQuestData();
 }
 
@@ -49,1013 +57,3099 @@ void USuqsProgression::InitWithQuestDataTablesInPaths(const TArray<FString>& Pat
 	InitWithQuestDataTables(DataTables);
 }
 
-bool USuqsProgression::GetQuestDefinitionCopy(FName QuestID, FSuqsQuest& OutQuest)
+void USuqsProgression::InitWithQuestDataTablesInPathsAsync(const TArray<FString>& Paths)
 {
-	auto QDef = QuestDefinitions.Find(QuestID);
-	if (QDef)
+	CancelQuestDataLoad();
+
+	// Existing quest data stays as it is until the new tables have loaded, but anything which would change
+	// progress is held until then (see CallWhenQuestDataReady)
+	bQuestDataLoading = true;
+	QuestDataLoadPaths = Paths;
+
+	IAssetRegistry& AssetRegistry = FModuleManager::LoadModuleChecked<FAssetRegistryModule>("AssetRegistry").Get();
+	if (AssetRegistry.IsLoadingAssets())
 	{
-		OutQuest = *QDef;
-		return true;
+		// Initial scan hasn't finished yet (editor), wait for it rather than blocking to scan these paths
+		AssetRegistryFilesLoadedHandle = AssetRegistry.OnFilesLoaded().AddUObject(this, &USuqsProgression::OnAssetRegistryFilesLoaded);
+	}
+	else
+	{
+		RequestQuestDataTables();
 	}
-
-	return false;
 }
 
-bool USuqsProgression::CreateQuestDefinition(const FSuqsQuest& NewQuest, bool bOverwriteIfExists)
+void USuqsProgression::CancelQuestDataLoad()
 {
-	if (NewQuest.Identifier.IsNone())
+	if (QuestDataLoadHandle.IsValid())
 	{
-		UE_LOG(LogSUQS, Error, TEXT("CreateQuestDefinition: Identifier is None"));
-		return false;
+		QuestDataLoadHandle->CancelHandle();
+		QuestDataLoadHandle.Reset();
 	}
-
-	auto QDef = QuestDefinitions.Find(NewQuest.Identifier);
-	if (QDef)
+	if (AssetRegistryFilesLoadedHandle.IsValid())
 	{
-		if (!bOverwriteIfExists)
+		if (FAssetRegistryModule* AssetRegistryModule = FModuleManager::GetModulePtr<FAssetRegistryModule>("AssetRegistry"))
 		{
-			UE_LOG(LogSUQS, Warning, TEXT("CreateQuestDefinition: Identifier '%s' exists, not overwriting"), *NewQuest.Identifier.ToString());
-			return false;
+			AssetRegistryModule->Get().OnFilesLoaded().Remove(AssetRegistryFilesLoadedHandle);
 		}
-		// Delete to re-use add impl
-		DeleteQuestDefinition(NewQuest.Identifier);
+		AssetRegistryFilesLoadedHandle.Reset();
 	}
-
-	// Add new
-	AddQuestDefinitionInternal(NewQuest);
-	return true;
+	// Held calls are kept, they'll run when whichever load replaces this one finishes
 }
 
-bool USuqsProgression::DeleteQuestDefinition(FName QuestID)
+void USuqsProgression::OnAssetRegistryFilesLoaded()
 {
-	// Remove quest status first, since that holds raw pointers to quest defs
-	RemoveQuest(QuestID, true, true);
-	// Remove definition
-	return QuestDefinitions.Remove(QuestID) > 0;
+	if (AssetRegistryFilesLoadedHandle.IsValid())
+	{
+		FModuleManager::GetModuleChecked<FAssetRegistryModule>("AssetRegistry").Get().OnFilesLoaded().Remove(AssetRegistryFilesLoadedHandle);
+		AssetRegistryFilesLoadedHandle.Reset();
+	}
+	RequestQuestDataTables();
 }
 
-void USuqsProgression::SetDefaultProgressionTimeDelays(float QuestDelay, float TaskDelay)
+void USuqsProgression::RequestQuestDataTables()
 {
-	DefaultQuestResolveTimeDelay = QuestDelay;
-	DefaultTaskResolveTimeDelay = TaskDelay;
-}
+	IAssetRegistry& AssetRegistry = FModuleManager::GetModuleChecked<FAssetRegistryModule>("AssetRegistry").Get();
 
+	FARFilter Filter;
+	Filter.ClassPaths.Add(UDataTable::StaticClass()->GetClassPathName());
+	Filter.bRecursivePaths = true;
+	for (const FString& Path : QuestDataLoadPaths)
+	{
+		Filter.PackagePaths.Add(FName(*Path));
+	}
+	TArray<FAssetData> Assets;
+	AssetRegistry.GetAssets(Filter, Assets);
 
-void USuqsProgression::RebuildAllQuestData()
-{
-	QuestDefinitions.Empty();
-	QuestCompletionDeps.Empty();
-	QuestFailureDeps.Empty();
-	ActiveQuests.Empty();
-	QuestArchive.Empty();
-	GlobalActiveBranches.Empty();
-	
-	// Build unified quest table
-	if (QuestDataTables.Num() > 0)
+	// Use the row struct tag so that we never load tables which aren't quests
+	const FString RowStructName = FSuqsQuest::StaticStruct()->GetName();
+	TArray<FSoftObjectPath> TablePaths;
+	for (const auto& Asset : Assets)
 	{
-		for (auto Table : QuestDataTables)
+		FString RowStruct;
+		if (Asset.GetTagValue("RowStructure", RowStruct) &&
+			(RowStruct == RowStructName || RowStruct.EndsWith("." + RowStructName)))
 		{
-			UE_LOG(LogSUQS, Verbose, TEXT("Loading quest definitions from %s"), *Table->GetName());
-			Table->ForeachRow<FSuqsQuest>("", [this, Table](const FName& Key, const FSuqsQuest& Quest)
-            {
-				if (QuestDefinitions.Contains(Quest.Identifier))
-				{
-					UE_LOG(LogSUQS, Error, TEXT("Quest ID '%s' has been used more than once! Duplicate entry was in %s"), *Quest.Identifier.ToString(), *Table->GetName());
-				}
-				else
-				{
-					AddQuestDefinitionInternal(Quest);
-				}
-            });
+			TablePaths.Add(Asset.ToSoftObjectPath());
 		}
 	}
 
-	const auto GI = UGameplayStatics::GetGameInstance(this);
-	if (IsValid(GI))
+	if (TablePaths.Num() == 0)
 	{
-		auto WaypointsSubSys = GI->GetSubsystem<USuqsWaypointSubsystem>();
-		WaypointsSubSys->SetProgression(this);
+		UE_LOG(LogSUQS, Warning, TEXT("No quest datatables found in %s"), *FString::Join(QuestDataLoadPaths, TEXT(", ")));
 	}
-	
+	LoadQuestDataTablesAsync(TablePaths);
 }
 
-void USuqsProgression::AddQuestDefinitionInternal(const FSuqsQuest& Quest)
+void USuqsProgression::InitWithQuestDataTablesAsync(const TArray<TSoftObjectPtr<UDataTable>>& Tables)
 {
-	// Check task IDs are unique
-	TSet<FName> TaskIDSet;
-	for (auto& Objective : Quest.Objectives)
+	CancelQuestDataLoad();
+	bQuestDataLoading = true;
+
+	TArray<FSoftObjectPath> TablePaths;
+	for (const auto& Table : Tables)
 	{
-		for (auto& Task : Objective.Tasks)
-		{
-			bool bDuplicate;
-			TaskIDSet.Add(Task.Identifier, &bDuplicate);
-			if (bDuplicate)
-				UE_LOG(LogSUQS, Error, TEXT("Task ID '%s' has been used more than once! Duplicate entry title: %s"), *Task.Identifier.ToString(), *Task.Title.ToString());
-		}
+		TablePaths.Add(Table.ToSoftObjectPath());
 	}
-				
-	QuestDefinitions.Add(Quest.Identifier, Quest);
+	LoadQuestDataTablesAsync(TablePaths);
+}
+
+void USuqsProgression::LoadQuestDataTablesAsync(const TArray<FSoftObjectPath>& TablePaths)
+{
+	if (TablePaths.Num() == 0)
+	{
+		OnQuestDataTablesLoaded(TablePaths);
+		return;
+	}
+
+	QuestDataLoadHandle = UAssetManager::GetStreamableManager().RequestAsyncLoad(TablePaths,
+		FStreamableDelegate::CreateUObject(this, &USuqsProgression::OnQuestDataTablesLoaded, TablePaths));
+}
 
-	// Record dependencies
-	if (Quest.AutoAccept)
+void USuqsProgression::OnQuestDataTablesLoaded(TArray<FSoftObjectPath> TablePaths)
+{
+	QuestDataLoadHandle.Reset();
+	QuestDataLoadPaths.Empty();
+
+	TArray<UDataTable*> DataTables;
+	for (const auto& Path : TablePaths)
 	{
-		for (auto& CompletedQuest : Quest.PrerequisiteQuests)
+		if (auto DataTable = Cast<UDataTable>(Path.ResolveObject()))
 		{
-			QuestCompletionDeps.Add(CompletedQuest, Quest.Identifier);
+			DataTables.Add(DataTable);
 		}
-		for (auto& FailedQuest : Quest.PrerequisiteQuestFailures)
+		else
 		{
-			QuestFailureDeps.Add(FailedQuest, Quest.Identifier);
+			UE_LOG(LogSUQS, Error, TEXT("Failed to load quest datatable %s"), *Path.ToString());
 		}
 	}
-}
+	// Nothing is rebuilt until now, so quest data is never left empty while loading
+	bQuestDataLoading = false;
+	InitWithQuestDataTables(DataTables);
 
-const TMap<FName, FSuqsQuest>& USuqsProgression::GetQuestDefinitions(bool bForceRebuild)
-{
-	if (bForceRebuild)
+	// Run calls which were held, in the order they were made
+	auto Calls = MoveTemp(CallsWaitingForQuestData);
+	for (auto& Call : Calls)
 	{
-		RebuildAllQuestData();
+		Call();
 	}
-	return QuestDefinitions;
+
+	OnQuestDataReady.Broadcast(this);
 }
 
-ESuqsQuestStatus USuqsProgression::GetQuestStatus(FName QuestID) const
+void USuqsProgression::CallWhenQuestDataReady(TFunction<void()> Func)
 {
-	// Could make a lookup for this, but we'd need to post-load call to re-populate it, leave for now
-	const auto State = FindQuestState(QuestID);
-
-	if (State)
-		return State->GetStatus();
+	if (IsQuestDataLoading())
+	{
+		CallsWaitingForQuestData.Add(MoveTemp(Func));
+	}
 	else
-		return ESuqsQuestStatus::Unavailable;
-	
+	{
+		Func();
+	}
 }
 
-USuqsQuestState* USuqsProgression::GetQuest(FName QuestID)
+bool USuqsProgression::InitWithQuestCatalog(const TArray<uint8>& CatalogData)
 {
-	auto Status = FindQuestState(QuestID);
-	return Status;
+	QuestDataTables.Empty();
+	QuestCatalogData = CatalogData;
+	RebuildAllQuestData();
+	// Rebuild discards invalid catalogs
+	return QuestCatalogData.Num() > 0;
 }
 
-
-USuqsQuestState* USuqsProgression::FindQuestState(const FName& QuestID)
+bool USuqsProgression::InitWithQuestCatalogFile(const FString& Filename)
 {
-	auto PQ = ActiveQuests.Find(QuestID);
-	if (PQ)
-		return *PQ;
-	PQ = QuestArchive.Find(QuestID);
-	if (PQ)
-		return *PQ;
+	TArray<uint8> Data;
+	if (!FFileHelper::LoadFileToArray(Data, *Filename))
+	{
+		UE_LOG(LogSUQS, Error, TEXT("Unable to read quest catalog file %s"), *Filename);
+		return false;
+	}
+	return InitWithQuestCatalog(Data);
+}
 
-	return nullptr;
-	
+void USuqsProgression::WriteQuestCatalog(TArray<uint8>& OutData) const
+{
+	// Instances of templates are written out in full, with their template's objectives
+	TArray<FSuqsQuest> InstanceCopies;
+	InstanceCopies.Reserve(QuestTemplates.Num());
+	TArray<const FSuqsQuest*> Quests;
+	Quests.Reserve(QuestDefinitions.Num());
+	for (const auto& Pair : QuestDefinitions)
+	{
+		if (const FSuqsQuest* Template = GetQuestTemplate(Pair.Key))
+		{
+			FSuqsQuest& Copy = InstanceCopies.Add_GetRef(*Pair.Value);
+			Copy.Objectives = Template->Objectives;
+			Quests.Add(&Copy);
+		}
+		else
+		{
+			Quests.Add(Pair.Value);
+		}
+	}
+	FSuqsQuestCatalog::Write(Quests, OutData);
 }
 
-const USuqsQuestState* USuqsProgression::FindQuestState(const FName& QuestID) const
+bool USuqsProgression::SaveQuestCatalogFile(const FString& Filename) const
 {
-	return const_cast<USuqsProgression*>(this)->FindQuestState(QuestID);
+	TArray<uint8> Data;
+	WriteQuestCatalog(Data);
+	return FFileHelper::SaveArrayToFile(Data, *Filename);
 }
 
-USuqsTaskState* USuqsProgression::FindTaskStatus(const FName& QuestID, const FName& TaskID)
+bool USuqsProgression::GetQuestDefinitionCopy(FName QuestID, FSuqsQuest& OutQuest)
 {
-	auto Q = FindQuestState(QuestID);
-	if (Q)
+	auto QDef = GetQuestDefinition(QuestID);
+	if (QDef)
 	{
-		return Q->GetTask(TaskID);
+		OutQuest = *QDef;
+		// Copies are independent of any template
+		if (const FSuqsQuest* Template = GetQuestTemplate(QuestID))
+			OutQuest.Objectives = Template->Objectives;
+		return true;
 	}
-	
-	return nullptr;
-}
-
 
-void USuqsProgression::GetAcceptedQuestIdentifiers(TArray<FName>& AcceptedQuestIDsOut) const
-{
-	ActiveQuests.GenerateKeyArray(AcceptedQuestIDsOut);
+	return false;
 }
 
-void USuqsProgression::GetArchivedQuestIdentifiers(TArray<FName>& ArchivedQuestIDsOut) const
+bool USuqsProgression::CreateQuestDefinition(const FSuqsQuest& NewQuest, bool bOverwriteIfExists)
 {
-	QuestArchive.GenerateKeyArray(ArchivedQuestIDsOut);
-}
+	// Definitions are held too, since loading rebuilds them and states being loaded refer to them
+	if (IsQuestDataLoading())
+	{
+		CallWhenQuestDataReady([this, NewQuest, bOverwriteIfExists]() { CreateQuestDefinition(NewQuest, bOverwriteIfExists); });
+		return true;
+	}
 
+	if (NewQuest.Identifier.IsNone())
+	{
+		UE_LOG(LogSUQS, Error, TEXT("CreateQuestDefinition: Identifier is None"));
+		return false;
+	}
 
-void USuqsProgression::GetAcceptedQuests(TArray<USuqsQuestState*>& AcceptedQuestsOut) const
-{
-	ActiveQuests.GenerateValueArray(AcceptedQuestsOut);
-}
+	auto QDef = QuestDefinitions.Find(NewQuest.Identifier);
+	if (QDef)
+	{
+		if (!bOverwriteIfExists)
+		{
+			UE_LOG(LogSUQS, Warning, TEXT("CreateQuestDefinition: Identifier '%s' exists, not overwriting"), *NewQuest.Identifier.ToString());
+			return false;
+		}
+		return OverwriteQuestDefinition(FSuqsQuest(NewQuest));
+	}
 
-void USuqsProgression::GetArchivedQuests(TArray<USuqsQuestState*>& ArchivedQuestsOut) const
-{
-	QuestArchive.GenerateValueArray(ArchivedQuestsOut);
+	// Add new
+	AddQuestDefinitionInternal(NewQuest);
+	return true;
 }
 
-bool USuqsProgression::AcceptQuest(FName QuestID, bool bResetIfFailed, bool bResetIfComplete, bool bResetIfInProgress)
+bool USuqsProgression::CreateQuestDefinitionsFromJSON(const FString& JsonString, bool bOverwriteIfExists)
 {
-	auto QDef = QuestDefinitions.Find(QuestID);
-	if (QDef)
+	if (IsQuestDataLoading())
 	{
-		// Check that we don't already have this quest
-		auto Quest = FindQuestState(QuestID);
-		if (Quest)
-		{
-			bool bReset;
-			switch(Quest->Status)
-			{
-			case ESuqsQuestStatus::Incomplete:
-				bReset = bResetIfInProgress;
-				break;
-			case ESuqsQuestStatus::Completed: 
-				bReset = bResetIfComplete;
-				break;
-			case ESuqsQuestStatus::Failed: 
-				bReset = bResetIfFailed;
-				break;
-			default:
-				bReset = true;
-				break;
-			}
+		CallWhenQuestDataReady([this, JsonString, bOverwriteIfExists]() { CreateQuestDefinitionsFromJSON(JsonString, bOverwriteIfExists); });
+		return true;
+	}
 
-			if (!bReset)
-			{
-				UE_LOG(LogSUQS, Warning, TEXT("Ignoring request to accept quest %s because it has status %d"), *QuestID.ToString(), Quest->Status);
-				return false;
-			}
+	TArray<FSuqsQuest> Quests;
+	FString Error;
+	if (!FSuqsQuestJsonImporter::Import(JsonString, Quests, Error))
+	{
+		UE_LOG(LogSUQS, Error, TEXT("CreateQuestDefinitionsFromJSON: %s"), *Error);
+		return false;
+	}
 
-			// Quest reset will raise all the necessary events
-			Quest->Reset();
+	TArray<const FSuqsQuest*> NewQuests;
+	NewQuests.Reserve(Quests.Num());
+	OwnedQuestDefinitions.Reserve(Quests.Num());
+	TSet<FName> NewQuestIDs;
+	int32 NumSkipped = 0;
+	for (auto& Quest : Quests)
+	{
+		bool bDuplicate;
+		NewQuestIDs.Add(Quest.Identifier, &bDuplicate);
+		if (bDuplicate)
+		{
+			UE_LOG(LogSUQS, Error, TEXT("Quest ID '%s' has been used more than once! Duplicate entry was in JSON"), *Quest.Identifier.ToString());
+			++NumSkipped;
+			continue;
 		}
-		else
+		if (QuestDefinitions.Contains(Quest.Identifier))
 		{
-			// New quest
-			Quest = NewObject<USuqsQuestState>(GetOuter());
-			// The problem is that initialisation could trigger detail events while it sorts itself out, out of order
-			// Let's suppress that
-			const bool bPrevSuppressed = bSuppressEvents;
-			bSuppressEvents = true;
-			Quest->Initialise(QDef, this);
-			bSuppressEvents = bPrevSuppressed;
-			
-			ActiveQuests.Add(QuestID, Quest);
-			
-			if (!bSuppressEvents)
+			if (!bOverwriteIfExists)
 			{
-				// Manually raise all the initialisation events since these will have been suppressed
-				OnQuestAccepted.Broadcast(Quest);
-				OnProgressionEvent.Broadcast(FSuqsProgressionEventDetails(ESuqsProgressionEventType::QuestAccepted, Quest));
-				OnActiveQuestsListChanged.Broadcast();
-				OnProgressionEvent.Broadcast(FSuqsProgressionEventDetails(ESuqsProgressionEventType::ActiveQuestsChanged));
-
-				RaiseCurrentObjectiveChanged(Quest);
+				UE_LOG(LogSUQS, Error, TEXT("CreateQuestDefinitionsFromJSON: Identifier '%s' exists, not overwriting"), *Quest.Identifier.ToString());
+				++NumSkipped;
 			}
-
-			// Propagate global quest branches
-			for (auto& Branch : GlobalActiveBranches)
+			else if (!OverwriteQuestDefinition(MoveTemp(Quest)))
 			{
-				Quest->SetBranchActive(Branch, true);
+				++NumSkipped;
 			}
+			continue;
 		}
+		NewQuests.Add(OwnedQuestDefinitions.Add(MoveTemp(Quest)));
+	}
+	AddQuestDefinitionsInternal(NewQuests);
+	if (NumSkipped > 0)
+	{
+		UE_LOG(LogSUQS, Warning, TEXT("CreateQuestDefinitionsFromJSON: %d of %d quests were skipped"), NumSkipped, Quests.Num());
+	}
+	return NumSkipped == 0;
+}
 
+bool USuqsProgression::CreateQuestInstance(FName TemplateQuestID, const FSuqsQuestInstance& Instance, bool bOverwriteIfExists)
+{
+	if (IsQuestDataLoading())
+	{
+		CallWhenQuestDataReady([this, TemplateQuestID, Instance, bOverwriteIfExists]() { CreateQuestInstance(TemplateQuestID, Instance, bOverwriteIfExists); });
 		return true;
 	}
-	else
+
+	if (Instance.Identifier.IsNone())
 	{
-		UE_LOG(LogSUQS, Error , TEXT("Attempted to accept a non-existent quest %s"), *QuestID.ToString());
+		UE_LOG(LogSUQS, Error, TEXT("CreateQuestInstance: Identifier is None"));
 		return false;
 	}
-	
-}
 
+	const FSuqsQuest* Template = GetQuestDefinition(TemplateQuestID);
+	if (!Template)
+	{
+		UE_LOG(LogSUQS, Error, TEXT("CreateQuestInstance: Template quest '%s' does not exist"), *TemplateQuestID.ToString());
+		return false;
+	}
+	// Instances of instances share the original template
+	if (const FSuqsQuest* OriginalTemplate = GetQuestTemplate(TemplateQuestID))
+		Template = OriginalTemplate;
 
-bool USuqsProgression::AutoAcceptQuests(const FName& FinishedQuestID, bool bFailed)
-{
-	bool bAnyAccepted = false;
-	TArray<FName> DependentQuestIDs;
-	if (bFailed)
-		QuestFailureDeps.MultiFind(FinishedQuestID, DependentQuestIDs);
-	else
-		QuestCompletionDeps.MultiFind(FinishedQuestID, DependentQuestIDs);
-	
-	for (const auto& DepQuestID : DependentQuestIDs)
+	const bool bExists = QuestDefinitions.Contains(Instance.Identifier);
+	if (bExists && (!bOverwriteIfExists || Instance.Identifier == Template->Identifier))
 	{
-		if (!IsQuestAccepted(DepQuestID) && QuestDependenciesMet(DepQuestID))
-		{
-			bAnyAccepted = AcceptQuest(DepQuestID) || bAnyAccepted;
-		}
+		UE_LOG(LogSUQS, Warning, TEXT("CreateQuestInstance: Identifier '%s' exists, not overwriting"), *Instance.Identifier.ToString());
+		return false;
 	}
 
-	return bAnyAccepted;
+	// Copy only the top-level quest details, objectives & tasks stay in the template
+	FSuqsQuest Quest;
+	Quest.Identifier = Instance.Identifier;
+	Quest.Labels = Template->Labels;
+	Quest.bPlayerVisible = Template->bPlayerVisible;
+	Quest.Title = Template->Title;
+	Quest.DescriptionWhenActive = Template->DescriptionWhenActive;
+	Quest.DescriptionWhenCompleted = Template->DescriptionWhenCompleted;
+	Quest.AutoAccept = Template->AutoAccept;
+	Quest.PrerequisiteQuests = Template->PrerequisiteQuests;
+	Quest.PrerequisiteQuestFailures = Template->PrerequisiteQuestFailures;
+	Quest.DefaultActiveBranches = Instance.bOverrideDefaultActiveBranches ? Instance.DefaultActiveBranches : Template->DefaultActiveBranches;
+	Quest.bResolveAutomatically = Template->bResolveAutomatically;
+	Quest.ResolveDelay = Template->ResolveDelay;
+	Quest.ResolveGate = Template->ResolveGate;
+
+	// Same as overwriting any other quest, so the handle & matching progress are kept
+	if (bExists)
+		return OverwriteQuestDefinition(MoveTemp(Quest), &Instance, Template);
+
+	// Instance overrides & template must be registered before the definition is compiled or any state is created
+	QuestInstances.Add(Instance.Identifier, Instance);
+	QuestTemplates.Add(Instance.Identifier, Template);
+	AddQuestDefinitionInternal(MoveTemp(Quest));
+	return true;
 }
 
-void USuqsProgression::ResetQuest(FName QuestID)
+const FSuqsQuestInstance* USuqsProgression::GetQuestInstance(const FName& QuestID) const
 {
-	auto Q = FindQuestState(QuestID);
-	if (Q)
-		Q->Reset();
+	return QuestInstances.Num() > 0 ? QuestInstances.Find(QuestID) : nullptr;
+}
 
-	// note we don't update quest lists here, but we rely on callbacks since you could reset or re-activate using the quest itself
-	
+const FSuqsQuest* USuqsProgression::GetQuestTemplate(const FName& QuestID) const
+{
+	return QuestTemplates.Num() > 0 ? QuestTemplates.FindRef(QuestID) : nullptr;
+}
+
+FName USuqsProgression::GetQuestTemplateIdentifier(FName QuestID) const
+{
+	const FSuqsQuest* Template = GetQuestTemplate(QuestID);
+	return Template ? Template->Identifier : NAME_None;
+}
+
+const TArray<FSuqsObjective>& USuqsProgression::GetQuestObjectives(const FSuqsQuest& Quest) const
+{
+	const FSuqsQuest* Template = GetQuestTemplate(Quest.Identifier);
+	return Template ? Template->Objectives : Quest.Objectives;
+}
+
+bool USuqsProgression::GetQuestDefinitionObjectives(FName QuestID, TArray<FSuqsObjective>& OutObjectives) const
+{
+	if (const FSuqsQuest* QDef = GetQuestDefinition(QuestID))
+	{
+		OutObjectives = GetQuestObjectives(*QDef);
+		return true;
+	}
+	return false;
 }
 
-void USuqsProgression::RemoveQuest(FName QuestID, bool bRemoveActive, bool bRemoveArchived)
-{
-	if (bRemoveActive)
-		ActiveQuests.Remove(QuestID);
-	if (bRemoveArchived)
-		QuestArchive.Remove(QuestID);
+FName USuqsProgression::FindInstanceOfTemplate(const FSuqsQuest* Template) const
+{
+	for (const auto& Pair : QuestTemplates)
+	{
+		if (Pair.Value == Template)
+			return Pair.Key;
+	}
+	return NAME_None;
+}
+
+bool USuqsProgression::OverwriteQuestDefinition(FSuqsQuest&& NewQuest, const FSuqsQuestInstance* Instance, const FSuqsQuest* Template)
+{
+	const FName QuestID = NewQuest.Identifier;
+	const FSuqsQuest* OldDef = GetQuestDefinition(QuestID);
+	// Instances share objectives & tasks with their template so it must outlive them
+	const FName InstanceID = FindInstanceOfTemplate(OldDef);
+	if (!InstanceID.IsNone())
+	{
+		UE_LOG(LogSUQS, Error, TEXT("OverwriteQuestDefinition: Quest '%s' is the template for instance '%s', delete instances first"),
+			*QuestID.ToString(), *InstanceID.ToString());
+		return false;
+	}
+
+	// Same as a changed quest in ReloadQuestData: the handle stays, and progress is kept where task IDs still match
+	// The new definition has its own objectives unless it's an instance, even if it replaces one
+	// Instances must also have the same template & overrides to be unchanged, since e.g. task target numbers are
+	// applied to states. Compared first, since Instance may be the one we're about to replace
+	const FSuqsQuestInstance* OldInstance = GetQuestInstance(QuestID);
+	const bool bSameInstance = GetQuestTemplate(QuestID) == Template &&
+		(OldInstance != nullptr) == (Instance != nullptr) &&
+		(!Instance || FSuqsQuestInstance::StaticStruct()->CompareScriptStruct(OldInstance, Instance, PPF_None));
+	if (Instance)
+	{
+		QuestInstances.Add(QuestID, *Instance);
+		QuestTemplates.Add(QuestID, Template);
+		Instance = GetQuestInstance(QuestID);
+	}
+	else
+	{
+		QuestInstances.Remove(QuestID);
+		QuestTemplates.Remove(QuestID);
+	}
+	const int32 QuestIndex = QuestHandleLookup.FindChecked(QuestID);
+	const FSuqsQuest* NewDef = OwnedQuestDefinitions.Add(MoveTemp(NewQuest));
+	QuestDefinitions.Add(QuestID, NewDef);
+	const TArray<FSuqsObjective>& NewObjectives = GetQuestObjectives(*NewDef);
+
+	const bool bPrevSuppressed = bSuppressEvents;
+	bSuppressEvents = true;
+	bool bStateRebuilt = false;
+	// The hash is only a fast reject; rebinding finds objectives & tasks by position, so they must really be identical
+	if (GetQuestDefinitionHash(*NewDef, NewObjectives, Instance) == CompiledQuests[QuestIndex].DefinitionHash &&
+		bSameInstance &&
+		OldDef && FSuqsQuest::StaticStruct()->CompareScriptStruct(OldDef, NewDef, PPF_None) &&
+		MatchesCompiledStructure(QuestIndex, NewObjectives))
+	{
+		// Identical definition, so the existing state only needs to point at the new one
+		if (auto Q = QuestStatesByHandle[QuestIndex])
+			Q->RebindDefinition(NewDef);
+	}
+	else
+	{
+		FSuqsQuestStateData QuestData;
+		bStateRebuilt = DiscardQuestState(QuestIndex, &QuestData);
+		int32 NumErrors = RecompileQuestDefinition(QuestIndex, *NewDef);
+		NumErrors += CheckQuestDependencyCycles(TArray<int32> { QuestIndex });
+		ReportQuestDefinitionErrors(NumErrors);
+		if (bStateRebuilt)
+			LoadQuestFromData(NewDef, QuestData);
+	}
+	bSuppressEvents = bPrevSuppressed;
+
+	// Datatable rows aren't ours, so this only frees runtime created definitions
+	OwnedQuestDefinitions.Remove(OldDef);
+
+	if (bStateRebuilt)
+	{
+		QueueOrBroadcastEvent(FSuqsProgressionEventDetails(ESuqsProgressionEventType::ActiveQuestsChanged));
+	}
+	return true;
+}
+
+bool USuqsProgression::DeleteQuestDefinition(FName QuestID)
+{
+	// Removing the state would be held, so the definition must be too or held calls would refer to freed data
+	if (IsQuestDataLoading())
+	{
+		CallWhenQuestDataReady([this, QuestID]() { DeleteQuestDefinition(QuestID); });
+		return true;
+	}
+
+	if (const FSuqsQuest* QDef = GetQuestDefinition(QuestID))
+	{
+		// Instances share objectives & tasks with their template so it must outlive them
+		const FName InstanceID = FindInstanceOfTemplate(QDef);
+		if (!InstanceID.IsNone())
+		{
+			UE_LOG(LogSUQS, Error, TEXT("DeleteQuestDefinition: Quest '%s' is the template for instance '%s', delete instances first"),
+				*QuestID.ToString(), *InstanceID.ToString());
+			return false;
+		}
+	}
+	QuestInstances.Remove(QuestID);
+	QuestTemplates.Remove(QuestID);
+
+	// Remove quest status first, since that holds raw pointers to quest defs
+	RemoveQuest(QuestID, true, true);
+	// The handle slot is freed for re-use, with a new generation so existing handles to this quest stop resolving
+	int32 QuestIndex;
+	if (QuestHandleLookup.RemoveAndCopyValue(QuestID, QuestIndex))
+	{
+		UnlinkQuestDependencies(QuestIndex);
+		InvalidateCompiledQuest(QuestIndex);
+		ReleaseQuestIndex(QuestIndex);
+	}
+	// Remove definition
+	const FSuqsQuest* QDef;
+	if (QuestDefinitions.RemoveAndCopyValue(QuestID, QDef))
+	{
+		OwnedQuestDefinitions.Remove(QDef);
+		return true;
+	}
+	return false;
+}
+
+void USuqsProgression::SetDefaultProgressionTimeDelays(float QuestDelay, float TaskDelay)
+{
+	DefaultQuestResolveTimeDelay = QuestDelay;
+	DefaultTaskResolveTimeDelay = TaskDelay;
+}
+
+
+void USuqsProgression::RebuildAllQuestData()
+{
+	QuestDefinitions.Empty();
+	OwnedQuestDefinitions.Empty();
+	QuestInstances.Empty();
+	QuestTemplates.Empty();
+	UnmetPrerequisiteCounts.Empty();
+	UnresolvedCompletionPrerequisites.Empty();
+	UnresolvedFailurePrerequisites.Empty();
+	ActiveQuests.Empty();
+	QuestArchive.Empty();
+	ArchivedQuestRecords.Empty();
+	ActiveTasksByID.Empty();
+	QuestStatusLookup.Empty();
+	CompiledQuests.Empty();
+	CompiledTasks.Empty();
+	FreeQuestIndexes.Empty();
+	FreeTaskRanges.Empty();
+	QuestHandleLookup.Empty();
+	QuestStatesByHandle.Empty();
+	QuestStatePool.Empty();
+	PendingQuestStatePool.Empty();
+	QuestsByBranch.Empty();
+	TickingQuests.Empty();
+	TickingTasks.Empty();
+	GateWaiters.Empty();
+	GlobalActiveBranches.Empty();
+	
+	// Gather unified quest table, then validate & compile all of it in one batch
+	// Datatable rows are referenced in place rather than copied
+	TArray<const FSuqsQuest*> NewQuests;
+	TSet<FName> NewQuestIDs;
+	auto AddUniqueQuest = [&NewQuests, &NewQuestIDs](const FSuqsQuest& Quest, const FString& SourceName) -> bool
+	{
+		bool bDuplicate;
+		NewQuestIDs.Add(Quest.Identifier, &bDuplicate);
+		if (bDuplicate)
+		{
+			UE_LOG(LogSUQS, Error, TEXT("Quest ID '%s' has been used more than once! Duplicate entry was in %s"), *Quest.Identifier.ToString(), *SourceName);
+		}
+		return !bDuplicate;
+	};
+	for (auto Table : QuestDataTables)
+	{
+		UE_LOG(LogSUQS, Verbose, TEXT("Loading quest definitions from %s"), *Table->GetName());
+		const FString TableName = Table->GetName();
+		NewQuests.Reserve(NewQuests.Num() + Table->GetRowMap().Num());
+		Table->ForeachRow<FSuqsQuest>("", [&](const FName& Key, const FSuqsQuest& Quest)
+		{
+			if (AddUniqueQuest(Quest, TableName))
+			{
+				NewQuests.Add(&Quest);
+			}
+		});
+	}
+	if (QuestCatalogData.Num() > 0)
+	{
+		UE_LOG(LogSUQS, Verbose, TEXT("Loading quest definitions from quest catalog"));
+		TArray<FSuqsQuest> CatalogQuests;
+		if (FSuqsQuestCatalog::Read(QuestCatalogData, CatalogQuests))
+		{
+			NewQuests.Reserve(NewQuests.Num() + CatalogQuests.Num());
+			OwnedQuestDefinitions.Reserve(CatalogQuests.Num());
+			const FString CatalogName("quest catalog");
+			for (auto& Quest : CatalogQuests)
+			{
+				if (AddUniqueQuest(Quest, CatalogName))
+				{
+					NewQuests.Add(OwnedQuestDefinitions.Add(MoveTemp(Quest)));
+				}
+			}
+		}
+		else
+		{
+			QuestCatalogData.Empty();
+		}
+	}
+	AddQuestDefinitionsInternal(NewQuests);
+
+	const auto GI = UGameplayStatics::GetGameInstance(this);
+	if (IsValid(GI))
+	{
+		auto WaypointsSubSys = GI->GetSubsystem<USuqsWaypointSubsystem>();
+		WaypointsSubSys->SetProgression(this);
+	}
+	
+}
+
+void USuqsProgression::AddQuestDefinitionInternal(FSuqsQuest InQuest)
+{
+	// The arena only grows, so runtime creation never moves existing definitions or states
+	AddQuestDefinitionsInternal(TArray<const FSuqsQuest*> { OwnedQuestDefinitions.Add(MoveTemp(InQuest)) });
+}
+
+int32 USuqsProgression::AddQuestDefinitionsInternal(const TArray<const FSuqsQuest*>& Quests, bool bReportErrors)
+{
+	// Validation & compilation of each quest is independent, so do it in parallel
+	// Task indexes in the compiled quests are local to the quest until merged
+	TArray<FSuqsCompiledQuest> NewCompiledQuests;
+	TArray<TArray<FSuqsCompiledTask>> NewCompiledTasks;
+	TArray<TArray<const FSuqsTask*>> DuplicateTasks;
+	NewCompiledQuests.SetNum(Quests.Num());
+	NewCompiledTasks.SetNum(Quests.Num());
+	DuplicateTasks.SetNum(Quests.Num());
+	ParallelFor(Quests.Num(), [&](int32 i)
+	{
+		CompileQuestDefinition(*Quests[i], GetQuestObjectives(*Quests[i]), GetQuestInstance(Quests[i]->Identifier),
+			NewCompiledQuests[i], NewCompiledTasks[i], DuplicateTasks[i]);
+	});
+
+	// Merge serially in original order so that handles & logging are deterministic
+	int32 NumErrors = 0;
+	int32 NumNewTasks = 0;
+	for (const auto& CQ : NewCompiledQuests)
+	{
+		NumNewTasks += CQ.NumTasks;
+	}
+	if (Quests.Num() > 1)
+	{
+		// Only reserve for batches, exact reservations for single runtime additions would defeat geometric growth
+		// Freed slots are used first, so this can over-reserve a little after deletions, never under
+		QuestDefinitions.Reserve(QuestDefinitions.Num() + Quests.Num());
+		CompiledQuests.Reserve(CompiledQuests.Num() + Quests.Num());
+		UnmetPrerequisiteCounts.Reserve(UnmetPrerequisiteCounts.Num() + Quests.Num());
+		QuestStatesByHandle.Reserve(QuestStatesByHandle.Num() + Quests.Num());
+		QuestHandleLookup.Reserve(QuestHandleLookup.Num() + Quests.Num());
+		CompiledTasks.Reserve(CompiledTasks.Num() + NumNewTasks);
+	}
+	TArray<int32> NewQuestIndexes;
+	NewQuestIndexes.Reserve(Quests.Num());
+	for (int32 i = 0; i < Quests.Num(); ++i)
+	{
+		const FSuqsQuest& Quest = *Quests[i];
+		for (const auto Task : DuplicateTasks[i])
+		{
+			UE_LOG(LogSUQS, Error, TEXT("Task ID '%s' has been used more than once! Duplicate entry title: %s"), *Task->Identifier.ToString(), *Task->Title.ToString());
+			++NumErrors;
+		}
+
+		const int32 QuestIndex = AllocateQuestIndex();
+		StoreCompiledQuest(QuestIndex, MoveTemp(NewCompiledQuests[i]), NewCompiledTasks[i]);
+		QuestHandleLookup.Add(Quest.Identifier, QuestIndex);
+		NewQuestIndexes.Add(QuestIndex);
+
+		QuestDefinitions.Add(Quest.Identifier, &Quest);
+	}
+
+	// Dependencies are linked once every quest in the batch has a handle, so they can refer to each other in any order
+	for (const int32 QuestIndex : NewQuestIndexes)
+	{
+		LinkQuestDependencies(QuestIndex);
+	}
+	NumErrors += CheckQuestDependencyCycles(NewQuestIndexes);
+
+	if (bReportErrors)
+		ReportQuestDefinitionErrors(NumErrors);
+	return NumErrors;
+}
+
+void USuqsProgression::ReportQuestDefinitionErrors(int32 NumErrors) const
+{
+	if (NumErrors > 0)
+	{
+		UE_LOG(LogSUQS, Error, TEXT("%d errors found in quest definitions"), NumErrors);
+	}
+}
+
+void USuqsProgression::ReloadQuestDataTables(TArray<UDataTable*> Tables)
+{
+	QuestDataTables = Tables;
+	ReloadQuestData();
+}
+
+void USuqsProgression::ReloadQuestData()
+{
+	if (IsQuestDataLoading())
+	{
+		UE_LOG(LogSUQS, Warning, TEXT("ReloadQuestData: Quest data is still loading, ignoring reload"));
+		return;
+	}
+
+	int32 NumErrors = 0;
+	TMap<FName, const FSuqsQuest*> NewRows;
+	for (auto Table : QuestDataTables)
+	{
+		if (!IsValid(Table))
+			continue;
+
+		const FString TableName = Table->GetName();
+		Table->ForeachRow<FSuqsQuest>("", [&](const FName& Key, const FSuqsQuest& Quest)
+		{
+			if (NewRows.Contains(Quest.Identifier))
+			{
+				UE_LOG(LogSUQS, Error, TEXT("Quest ID '%s' has been used more than once! Duplicate entry was in %s"), *Quest.Identifier.ToString(), *TableName);
+				++NumErrors;
+			}
+			else
+			{
+				NewRows.Add(Quest.Identifier, &Quest);
+			}
+		});
+	}
+
+	// Datatable rows may have been freed by a reimport, so existing datatable definitions are only ever compared by
+	// address from here on, never dereferenced. Anything else needed about them comes from the compiled quests.
+	// Runtime-created, catalog & instance definitions are owned by us so they're always safe
+	TArray<TPair<int32, const FSuqsQuest*>> UnchangedQuests;
+	TArray<TPair<int32, const FSuqsQuest*>> ChangedQuests;
+	TArray<int32> RemovedQuests;
+	// Old datatable definition -> new definition (null if removed), and which ones changed, so instances can follow
+	TMap<const FSuqsQuest*, const FSuqsQuest*> MovedDefinitions;
+	TSet<const FSuqsQuest*> ChangedDefinitions;
+	for (const auto& Pair : QuestDefinitions)
+	{
+		if (OwnedQuestDefinitions.Contains(Pair.Value))
+			continue;
+
+		const int32 QuestIndex = QuestHandleLookup.FindChecked(Pair.Key);
+		const FSuqsQuest* NewDef = NewRows.FindRef(Pair.Key);
+		MovedDefinitions.Add(Pair.Value, NewDef);
+		if (!NewDef)
+		{
+			RemovedQuests.Add(QuestIndex);
+		}
+		else if (GetQuestDefinitionHash(*NewDef, NewDef->Objectives) == CompiledQuests[QuestIndex].DefinitionHash &&
+			MatchesCompiledStructure(QuestIndex, NewDef->Objectives))
+		{
+			// The hash is only a fast reject; unchanged states are rebound, which relies on the same structure
+			UnchangedQuests.Emplace(QuestIndex, NewDef);
+		}
+		else
+		{
+			ChangedQuests.Emplace(QuestIndex, NewDef);
+			ChangedDefinitions.Add(Pair.Value);
+		}
+	}
+	for (auto& Pair : QuestTemplates)
+	{
+		// Instance definitions themselves are always owned, only their template can move
+		const FSuqsQuest** pNewTemplate = MovedDefinitions.Find(Pair.Value);
+		if (!pNewTemplate)
+			continue;
+
+		const FSuqsQuest* InstanceDef = GetQuestDefinition(Pair.Key);
+		const int32 QuestIndex = QuestHandleLookup.FindChecked(Pair.Key);
+		if (!*pNewTemplate)
+		{
+			UE_LOG(LogSUQS, Warning, TEXT("ReloadQuestData: Removing quest instance '%s' because its template was removed"), *Pair.Key.ToString());
+			RemovedQuests.Add(QuestIndex);
+		}
+		else
+		{
+			const bool bTemplateChanged = ChangedDefinitions.Contains(Pair.Value);
+			Pair.Value = *pNewTemplate;
+			if (bTemplateChanged)
+				ChangedQuests.Emplace(QuestIndex, InstanceDef);
+			else
+				UnchangedQuests.Emplace(QuestIndex, InstanceDef);
+		}
+	}
+	TArray<const FSuqsQuest*> AddedQuests;
+	for (const auto& Pair : NewRows)
+	{
+		if (const FSuqsQuest* ExistingDef = GetQuestDefinition(Pair.Key))
+		{
+			if (OwnedQuestDefinitions.Contains(ExistingDef))
+			{
+				UE_LOG(LogSUQS, Warning, TEXT("ReloadQuestData: Ignoring quest '%s' from datatable since it's already defined elsewhere"), *Pair.Key.ToString());
+			}
+		}
+		else
+		{
+			AddedQuests.Add(Pair.Value);
+		}
+	}
+
+	UE_LOG(LogSUQS, Log, TEXT("Reloading quest data: %d changed, %d added, %d removed, %d unchanged"),
+		ChangedQuests.Num(), AddedQuests.Num(), RemovedQuests.Num(), UnchangedQuests.Num());
+
+	// Restored states are loaded, not progressed, so no events until everything is consistent
+	const bool bPrevSuppressed = bSuppressEvents;
+	bSuppressEvents = true;
+
+	// Every definition must be current before any state is rebuilt, since rebuilding can accept other quests
+	for (const auto& Pair : UnchangedQuests)
+	{
+		QuestDefinitions.Add(CompiledQuests[Pair.Key].Identifier, Pair.Value);
+		if (auto Q = QuestStatesByHandle[Pair.Key])
+			Q->RebindDefinition(Pair.Value);
+	}
+	TArray<FSuqsQuestStateData> ChangedQuestData;
+	TArray<bool> ChangedQuestHadState;
+	ChangedQuestData.SetNum(ChangedQuests.Num());
+	ChangedQuestHadState.SetNum(ChangedQuests.Num());
+	for (int32 i = 0; i < ChangedQuests.Num(); ++i)
+	{
+		ChangedQuestHadState[i] = DiscardQuestState(ChangedQuests[i].Key, &ChangedQuestData[i]);
+	}
+	for (const int32 QuestIndex : RemovedQuests)
+	{
+		const FName QuestID = CompiledQuests[QuestIndex].Identifier;
+		DiscardQuestState(QuestIndex, nullptr);
+		ArchivedQuestRecords.Remove(QuestID);
+		ESuqsQuestStatus OldStatus;
+		if (QuestStatusLookup.RemoveAndCopyValue(QuestID, OldStatus))
+			UpdateUnmetPrerequisites(QuestID, OldStatus, ESuqsQuestStatus::Unavailable);
+		UnlinkQuestDependencies(QuestIndex);
+		InvalidateCompiledQuest(QuestIndex);
+		ReleaseQuestIndex(QuestIndex);
+		QuestHandleLookup.Remove(QuestID);
+		QuestInstances.Remove(QuestID);
+		QuestTemplates.Remove(QuestID);
+		const FSuqsQuest* OldDef;
+		if (QuestDefinitions.RemoveAndCopyValue(QuestID, OldDef))
+			OwnedQuestDefinitions.Remove(OldDef);
+	}
+	for (const auto& Pair : ChangedQuests)
+	{
+		QuestDefinitions.Add(Pair.Value->Identifier, Pair.Value);
+		NumErrors += RecompileQuestDefinition(Pair.Key, *Pair.Value);
+	}
+	if (ChangedQuests.Num() > 0)
+	{
+		TArray<int32> ChangedQuestIndexes;
+		ChangedQuestIndexes.Reserve(ChangedQuests.Num());
+		for (const auto& Pair : ChangedQuests)
+		{
+			ChangedQuestIndexes.Add(Pair.Key);
+		}
+		NumErrors += CheckQuestDependencyCycles(ChangedQuestIndexes);
+	}
+	if (AddedQuests.Num() > 0)
+	{
+		NumErrors += AddQuestDefinitionsInternal(AddedQuests, false);
+	}
+	ReportQuestDefinitionErrors(NumErrors);
+
+	// Changed quests are restored just like loading saved data, so task state is kept where task IDs still match
+	for (int32 i = 0; i < ChangedQuests.Num(); ++i)
+	{
+		if (ChangedQuestHadState[i])
+			LoadQuestFromData(ChangedQuests[i].Value, ChangedQuestData[i]);
+	}
+
+	bSuppressEvents = bPrevSuppressed;
+
+	if (ChangedQuests.Num() > 0 || RemovedQuests.Num() > 0)
+	{
+		QueueOrBroadcastEvent(FSuqsProgressionEventDetails(ESuqsProgressionEventType::ActiveQuestsChanged));
+	}
+}
+
+const TMap<FName, const FSuqsQuest*>& USuqsProgression::GetQuestDefinitions(bool bForceRebuild)
+{
+	if (bForceRebuild)
+	{
+		RebuildAllQuestData();
+	}
+	return QuestDefinitions;
+}
+
+TMap<FName, FSuqsQuest> USuqsProgression::GetQuestDefinitionsCopy(bool bForceRebuild)
+{
+	TMap<FName, FSuqsQuest> Ret;
+	Ret.Reserve(GetQuestDefinitions(bForceRebuild).Num());
+	for (const auto& Pair : QuestDefinitions)
+	{
+		GetQuestDefinitionCopy(Pair.Key, Ret.Add(Pair.Key));
+	}
+	return Ret;
+}
+
+void USuqsProgression::GetQuestDefinitionIDs(TArray<FName>& OutQuestIDs) const
+{
+	QuestDefinitions.GenerateKeyArray(OutQuestIDs);
+}
+
+ESuqsQuestStatus USuqsProgression::GetQuestStatus(FName QuestID) const
+{
+	if (const auto pStatus = QuestStatusLookup.Find(QuestID))
+		return *pStatus;
+	else
+		return ESuqsQuestStatus::Unavailable;
+	
+}
+
+USuqsQuestState* USuqsProgression::GetQuest(FName QuestID)
+{
+	auto Status = FindQuestState(QuestID);
+	return Status;
+}
+
+
+ESuqsQuestStatus USuqsProgression::GetQuestStatus(FSuqsQuestHandle Quest) const
+{
+	if (const auto CQ = GetCompiledQuest(Quest))
+	{
+		if (const auto Q = QuestStatesByHandle[Quest.Index])
+			return Q->GetStatus();
+		// Compact archived quests don't need rebuilding just for their status
+		if (const auto pRecord = ArchivedQuestRecords.Find(CQ->Identifier))
+			return pRecord->Status;
+	}
+	return ESuqsQuestStatus::Unavailable;
+}
+
+FSuqsQuestHandle USuqsProgression::GetQuestHandle(const FName& QuestID) const
+{
+	if (const int32* pIndex = QuestHandleLookup.Find(QuestID))
+		return FSuqsQuestHandle(*pIndex, CompiledQuests[*pIndex].Generation);
+
+	return FSuqsQuestHandle();
+}
+
+FSuqsObjectiveHandle USuqsProgression::GetObjectiveHandle(const FName& QuestID, const FName& ObjectiveID) const
+{
+	const FSuqsQuestHandle QH = GetQuestHandle(QuestID);
+	if (QH.IsValid())
+	{
+		// Objective IDs are optional so aren't in a lookup, these are resolved rarely anyway
+		const auto QDef = GetQuestDefinition(QuestID);
+		const auto& Objectives = GetQuestObjectives(*QDef);
+		for (int32 i = 0; i < Objectives.Num(); ++i)
+		{
+			if (Objectives[i].Identifier == ObjectiveID)
+				return FSuqsObjectiveHandle(QH, i);
+		}
+	}
+	return FSuqsObjectiveHandle();
+}
+
+FSuqsTaskHandle USuqsProgression::GetTaskHandle(const FName& QuestID, const FName& TaskID) const
+{
+	if (const int32* pQuestIndex = QuestHandleLookup.Find(QuestID))
+	{
+		if (const int32* pTaskIndex = CompiledQuests[*pQuestIndex].TaskLookup.Find(TaskID))
+			return GetTaskHandleByIndex(*pTaskIndex);
+	}
+	return FSuqsTaskHandle();
+}
+
+FSuqsTaskHandle USuqsProgression::GetTaskHandleByIndex(int32 TaskIndex) const
+{
+	if (CompiledTasks.IsValidIndex(TaskIndex))
+		return FSuqsTaskHandle(TaskIndex, CompiledTasks[TaskIndex].Generation);
+
+	return FSuqsTaskHandle();
+}
+
+USuqsQuestState* USuqsProgression::GetQuest(FSuqsQuestHandle Quest) const
+{
+	if (GetCompiledQuest(Quest))
+	{
+		// Compact archived quests are null here, they're only rebuilt by GetQuest(QuestID) or by changing them
+		return QuestStatesByHandle[Quest.Index];
+	}
+
+	return nullptr;
+}
+
+const FSuqsCompiledQuest* USuqsProgression::GetCompiledQuest(FSuqsQuestHandle Quest) const
+{
+	if (CompiledQuests.IsValidIndex(Quest.Index) &&
+		CompiledQuests[Quest.Index].Generation == Quest.Generation &&
+		CompiledQuests[Quest.Index].IsValid())
+		return &CompiledQuests[Quest.Index];
+
+	return nullptr;
+}
+
+const FSuqsCompiledTask* USuqsProgression::GetCompiledTask(FSuqsTaskHandle Task) const
+{
+	if (CompiledTasks.IsValidIndex(Task.Index) && CompiledTasks[Task.Index].Generation == Task.Generation)
+		return &CompiledTasks[Task.Index];
+
+	return nullptr;
+}
+
+USuqsObjectiveState* USuqsProgression::GetObjective(FSuqsObjectiveHandle Objective) const
+{
+	if (const auto Q = GetQuest(Objective.Quest))
+	{
+		const auto& Objectives = Q->GetObjectives();
+		if (Objectives.IsValidIndex(Objective.ObjectiveIndex))
+			return Objectives[Objective.ObjectiveIndex];
+	}
+	return nullptr;
+}
+
+USuqsTaskState* USuqsProgression::GetTaskState(FSuqsTaskHandle Task) const
+{
+	const auto T = FindTask(Task);
+	if (const auto Obj = T.GetObjective())
+		return Obj->GetTask(T.TaskIndex);
+	return nullptr;
+}
+
+FSuqsTaskStateRef USuqsProgression::FindTask(FSuqsTaskHandle Task) const
+{
+	const auto CT = GetCompiledTask(Task);
+	if (CT && CT->QuestIndex != INDEX_NONE)
+	{
+		const FSuqsQuestHandle QH(CT->QuestIndex, CompiledQuests[CT->QuestIndex].Generation);
+		if (const auto Obj = GetObjective(FSuqsObjectiveHandle(QH, CT->ObjectiveIndex)))
+			return FSuqsTaskStateRef(Obj, CT->TaskIndex);
+	}
+	return FSuqsTaskStateRef();
+}
+
+USuqsQuestState* USuqsProgression::FindQuestState(const FName& QuestID)
+{
+	auto PQ = ActiveQuests.Find(QuestID);
+	if (PQ)
+		return *PQ;
+	PQ = QuestArchive.Find(QuestID);
+	if (PQ)
+		return *PQ;
+
+	// Archived quests may be held compactly until they're needed
+	return HydrateArchivedQuest(QuestID);
+	
+}
+
+const USuqsQuestState* USuqsProgression::FindQuestState(const FName& QuestID) const
+{
+	return FindExistingQuestState(QuestID);
+}
+
+USuqsQuestState* USuqsProgression::FindExistingQuestState(const FName& QuestID) const
+{
+	if (const auto Q = ActiveQuests.FindRef(QuestID))
+		return Q;
+	return QuestArchive.FindRef(QuestID);
+}
+
+USuqsTaskState* USuqsProgression::FindTaskStatus(const FName& QuestID, const FName& TaskID)
+{
+	auto Q = FindQuestState(QuestID);
+	if (Q)
+	{
+		return Q->GetTask(TaskID);
+	}
+	
+	return nullptr;
+}
+
+FSuqsTaskStateRef USuqsProgression::FindTask(const FName& QuestID, const FName& TaskID)
+{
+	USuqsObjectiveState* Obj;
+	int TaskIndex;
+	auto Q = FindQuestState(QuestID);
+	if (Q && Q->FindTask(TaskID, Obj, TaskIndex))
+	{
+		return FSuqsTaskStateRef(Obj, TaskIndex);
+	}
+	return FSuqsTaskStateRef();
+}
+
+
+void USuqsProgression::GetAcceptedQuestIdentifiers(TArray<FName>& AcceptedQuestIDsOut) const
+{
+	ActiveQuests.GenerateKeyArray(AcceptedQuestIDsOut);
+}
+
+void USuqsProgression::GetArchivedQuestIdentifiers(TArray<FName>& ArchivedQuestIDsOut) const
+{
+	ArchivedQuestIDsOut.Reset(QuestArchive.Num() + ArchivedQuestRecords.Num());
+	ForEachArchivedQuestIdentifier([&ArchivedQuestIDsOut](const FName& QuestID)
+	{
+		ArchivedQuestIDsOut.Add(QuestID);
+	});
+}
+
+void USuqsProgression::ForEachArchivedQuestIdentifier(TFunctionRef<void(const FName&)> Func) const
+{
+	for (const auto& Pair : QuestArchive)
+	{
+		Func(Pair.Key);
+	}
+	for (const auto& Pair : ArchivedQuestRecords)
+	{
+		Func(Pair.Key);
+	}
+}
+
+void USuqsProgression::ForEachArchivedQuest(TFunctionRef<void(const FName&, const USuqsQuestState*, const FSuqsArchivedQuestRecord*)> Func) const
+{
+	for (const auto& Pair : QuestArchive)
+	{
+		Func(Pair.Key, Pair.Value, nullptr);
+	}
+	for (const auto& Pair : ArchivedQuestRecords)
+	{
+		Func(Pair.Key, nullptr, &Pair.Value);
+	}
+}
+
+
+void USuqsProgression::GetAcceptedQuests(TArray<USuqsQuestState*>& AcceptedQuestsOut) const
+{
+	ActiveQuests.GenerateValueArray(AcceptedQuestsOut);
+}
+
+void USuqsProgression::GetArchivedQuests(TArray<USuqsQuestState*>& ArchivedQuestsOut) const
+{
+	QuestArchive.GenerateValueArray(ArchivedQuestsOut);
+}
+
+int32 USuqsProgression::CompactArchivedQuests()
+{
+	// Events raised or queued, and batched changes, may still refer to the states
+	if (EventBroadcastDepth > 0 || QueuedEvents.Num() > 0 || BatchDepth > 0 || bFlushingBatch)
+	{
+		UE_LOG(LogSUQS, Warning, TEXT("CompactArchivedQuests: Can't compact while events are being raised or in a batch, ignoring"));
+		return 0;
+	}
+
+	// Quests still waiting on a resolve barrier need their state to resolve it
+	TArray<USuqsQuestState*> Quests;
+	for (const auto& Pair : QuestArchive)
+	{
+		if (!Pair.Value->ResolveBarrier.bPending)
+			Quests.Add(Pair.Value);
+	}
+
+	TArray<FName> TaskIDs;
+	int32 NumCompacted = 0;
+	for (auto Q : Quests)
+	{
+		const FName QuestID = Q->GetIdentifier();
+		const FSuqsQuest* QDef = GetQuestDefinition(QuestID);
+		if (!QDef)
+			continue;
+
+		TaskIDs.Reset();
+		for (auto O : Q->Objectives)
+		{
+			for (int i = 0; i < O->GetNumTasks(); ++i)
+			{
+				TaskIDs.Add(O->GetTaskDefinition(i).Identifier);
+			}
+		}
+		FSuqsQuestStateData QData;
+		SaveQuestToData(Q, QuestID, TaskIDs, QData);
+
+		// The state isn't pooled, the point is to release it
+		QuestArchive.Remove(QuestID);
+		if (const int32* pIndex = QuestHandleLookup.Find(QuestID))
+			QuestStatesByHandle[*pIndex] = nullptr;
+		UnscheduleQuestState(Q);
+		if (AddArchivedQuestRecord(QDef, QData))
+			++NumCompacted;
+	}
+
+	return NumCompacted;
+}
+
+SIZE_T USuqsProgression::GetArchivedQuestRecordsAllocatedSize() const
+{
+	SIZE_T Size = ArchivedQuestRecords.GetAllocatedSize();
+	for (const auto& Pair : ArchivedQuestRecords)
+	{
+		Size += Pair.Value.GetAllocatedSize();
+	}
+	return Size;
+}
+
+bool USuqsProgression::AcceptQuest(FName QuestID, bool bResetIfFailed, bool bResetIfComplete, bool bResetIfInProgress)
+{
+	if (IsQuestDataLoading())
+	{
+		// Hold until quest definitions are available
+		CallWhenQuestDataReady([this, QuestID, bResetIfFailed, bResetIfComplete, bResetIfInProgress]()
+		{
+			AcceptQuest(QuestID, bResetIfFailed, bResetIfComplete, bResetIfInProgress);
+		});
+		return true;
+	}
+
+	auto QDef = GetQuestDefinition(QuestID);
+	if (QDef)
+	{
+		// Check that we don't already have this quest
+		auto Quest = FindQuestState(QuestID);
+		if (Quest)
+		{
+			bool bReset;
+			switch(Quest->Status)
+			{
+			case ESuqsQuestStatus::Incomplete:
+				bReset = bResetIfInProgress;
+				break;
+			case ESuqsQuestStatus::Completed: 
+				bReset = bResetIfComplete;
+				break;
+			case ESuqsQuestStatus::Failed: 
+				bReset = bResetIfFailed;
+				break;
+			default:
+				bReset = true;
+				break;
+			}
+
+			if (!bReset)
+			{
+				UE_LOG(LogSUQS, Warning, TEXT("Ignoring request to accept quest %s because it has status %d"), *QuestID.ToString(), Quest->Status);
+				return false;
+			}
+
+			// Quest reset will raise all the necessary events
+			Quest->Reset();
+		}
+		else
+		{
+			// New quest
+			Quest = NewQuestState(QDef);
+			// The problem is that initialisation could trigger detail events while it sorts itself out, out of order
+			// Let's suppress that
+			const bool bPrevSuppressed = bSuppressEvents;
+			bSuppressEvents = true;
+			Quest->Initialise(QDef, this);
+			bSuppressEvents = bPrevSuppressed;
+			
+			AddActiveQuest(Quest);
+			
+			if (!bSuppressEvents)
+			{
+				// Manually raise all the initialisation events since these will have been suppressed
+				QueueOrBroadcastEvent(FSuqsProgressionEventDetails(ESuqsProgressionEventType::QuestAccepted, Quest));
+				QueueOrBroadcastEvent(FSuqsProgressionEventDetails(ESuqsProgressionEventType::ActiveQuestsChanged));
+
+				RaiseCurrentObjectiveChanged(Quest);
+			}
+
+			// Propagate global quest branches, if they're relevant to this quest
+			for (auto& Branch : GlobalActiveBranches)
+			{
+				if (Quest->UsesBranch(Branch))
+					Quest->SetBranchActive(Branch, true);
+			}
+		}
+
+		return true;
+	}
+	else
+	{
+		UE_LOG(LogSUQS, Error , TEXT("Attempted to accept a non-existent quest %s"), *QuestID.ToString());
+		return false;
+	}
+	
+}
+
+
+bool USuqsProgression::AutoAcceptQuests(const FName& FinishedQuestID, bool bFailed)
+{
+	bool bAnyAccepted = false;
+	const int32* pIndex = QuestHandleLookup.Find(FinishedQuestID);
+	if (!pIndex)
+		return false;
+
+	// Prerequisite counts are already up to date, so each dependent is a constant time check
+	// Copied because event handlers called while accepting quests may add or delete quest definitions
+	const TArray<int32> Dependents = bFailed ?
+		CompiledQuests[*pIndex].DependentsOnFailure : CompiledQuests[*pIndex].DependentsOnCompletion;
+	for (const int32 DepIndex : Dependents)
+	{
+		const FSuqsCompiledQuest& DepQuest = CompiledQuests[DepIndex];
+		if (DepQuest.IsValid() &&
+			DepQuest.bAutoAccept &&
+			UnmetPrerequisiteCounts[DepIndex] == 0 &&
+			!IsQuestAccepted(DepQuest.Identifier))
+		{
+			const FName DepQuestID = DepQuest.Identifier;
+			bAnyAccepted = AcceptQuest(DepQuestID) || bAnyAccepted;
+		}
+	}
+
+	return bAnyAccepted;
+}
+
+void USuqsProgression::ResetQuest(FName QuestID)
+{
+	if (IsQuestDataLoading())
+	{
+		CallWhenQuestDataReady([this, QuestID]() { ResetQuest(QuestID); });
+		return;
+	}
+
+	auto Q = FindQuestState(QuestID);
+	if (Q)
+		Q->Reset();
+
+	// note we don't update quest lists here, but we rely on callbacks since you could reset or re-activate using the quest itself
+	
+}
+
+void USuqsProgression::RemoveQuest(FName QuestID, bool bRemoveActive, bool bRemoveArchived)
+{
+	if (IsQuestDataLoading())
+	{
+		CallWhenQuestDataReady([this, QuestID, bRemoveActive, bRemoveArchived]() { RemoveQuest(QuestID, bRemoveActive, bRemoveArchived); });
+		return;
+	}
+
+	USuqsQuestState* RemovedActive = bRemoveActive ? ActiveQuests.FindRef(QuestID) : nullptr;
+	USuqsQuestState* RemovedArchived = bRemoveArchived ? QuestArchive.FindRef(QuestID) : nullptr;
+	if (bRemoveActive)
+		RemoveActiveQuest(QuestID);
+	if (bRemoveArchived)
+	{
+		QuestArchive.Remove(QuestID);
+		ArchivedQuestRecords.Remove(QuestID);
+	}
+
+	if (auto Q = FindExistingQuestState(QuestID))
+		UpdateQuestLookups(Q);
+	else if (!ArchivedQuestRecords.Contains(QuestID))
+	{
+		ESuqsQuestStatus OldStatus;
+		if (QuestStatusLookup.RemoveAndCopyValue(QuestID, OldStatus))
+			UpdateUnmetPrerequisites(QuestID, OldStatus, ESuqsQuestStatus::Unavailable);
+		if (const int32* pIndex = QuestHandleLookup.Find(QuestID))
+			QuestStatesByHandle[*pIndex] = nullptr;
+	}
+
+	// Re-used if the quest is accepted again, e.g. repeatable quests
+	PoolQuestState(RemovedActive);
+	PoolQuestState(RemovedArchived);
+}
+
+void USuqsProgression::FailQuest(FName QuestID)
+{
+	if (IsQuestDataLoading())
+	{
+		CallWhenQuestDataReady([this, QuestID]() { FailQuest(QuestID); });
+		return;
+	}
+
+	auto Q = FindQuestState(QuestID);
+	if (Q)
+		Q->Fail();
+
+	// note we don't update quest lists here, but we rely on callbacks since you could fail via the quest itself
+}
+
+void USuqsProgression::CompleteQuest(FName QuestID)
+{
+	if (IsQuestDataLoading())
+	{
+		CallWhenQuestDataReady([this, QuestID]() { CompleteQuest(QuestID); });
+		return;
+	}
+
+	auto Q = FindQuestState(QuestID);
+	if (Q)
+		Q->Complete();
+	
+}
+
+void USuqsProgression::ResolveQuest(FName QuestID)
+{
+	if (IsQuestDataLoading())
+	{
+		CallWhenQuestDataReady([this, QuestID]() { ResolveQuest(QuestID); });
+		return;
+	}
+
+	auto Q = FindQuestState(QuestID);
+	if (Q)
+		Q->Resolve();
+	
+}
+
+void USuqsProgression::FailTask(FName QuestID, FName TaskIdentifier)
+{
+	if (IsQuestDataLoading())
+	{
+		CallWhenQuestDataReady([this, QuestID, TaskIdentifier]() { FailTask(QuestID, TaskIdentifier); });
+		return;
+	}
+
+	if (QuestID.IsNone())
+	{
+		TArray<FSuqsTaskStateRef> Tasks;
+		GetActiveTasks(TaskIdentifier, Tasks);
+		for (const auto& T : Tasks)
+		{
+			if (const auto Obj = T.GetObjective())
+				Obj->FailTask(T.TaskIndex);
+		}
+	}
+	else
+	{
+		const auto T = FindTask(QuestID, TaskIdentifier);
+		if (const auto Obj = T.GetObjective())
+		{
+			Obj->FailTask(T.TaskIndex);
+		}
+	}
+}
+
+
+bool USuqsProgression::CompleteTask(FName QuestID, FName TaskIdentifier)
+{
+	if (IsQuestDataLoading())
+	{
+		CallWhenQuestDataReady([this, QuestID, TaskIdentifier]() { CompleteTask(QuestID, TaskIdentifier); });
+		return true;
+	}
+
+	if (QuestID.IsNone())
+	{
+		bool bCompleted = false;
+		TArray<FSuqsTaskStateRef> Tasks;
+		GetActiveTasks(TaskIdentifier, Tasks);
+		for (const auto& T : Tasks)
+		{
+			if (const auto Obj = T.GetObjective())
+				bCompleted = Obj->CompleteTask(T.TaskIndex) || bCompleted;
+		}
+		if (bCompleted)
+			return true;
+	}
+	else
+	{
+		const auto T = FindTask(QuestID, TaskIdentifier);
+		if (const auto Obj = T.GetObjective())
+		{
+			return Obj->CompleteTask(T.TaskIndex);
+		}
+	}
+	UE_LOG(LogSUQS, Warning, TEXT("Attempted to complete task %s/%s but it was not found in the active quests"),
+		*QuestID.ToString(), *TaskIdentifier.ToString());
+	return false;
+}
+
+bool USuqsProgression::CompleteTask(FSuqsTaskHandle Task)
+{
+	const auto T = FindTask(Task);
+	if (const auto Obj = T.GetObjective())
+	{
+		if (IsQuestDataLoading())
+		{
+			// Handles won't survive the rebuild, so hold the call by identifier instead
+			return CompleteTask(Obj->GetParentQuest()->GetIdentifier(), Obj->GetTaskDefinition(T.TaskIndex).Identifier);
+		}
+		return Obj->CompleteTask(T.TaskIndex);
+	}
+	UE_LOG(LogSUQS, Warning, TEXT("Attempted to complete task with handle %d but it was not found in accepted quests"), Task.Index);
+	return false;
+}
+
+int USuqsProgression::ProgressTask(FSuqsTaskHandle Task, int Delta)
+{
+	const auto T = FindTask(Task);
+	if (const auto Obj = T.GetObjective())
+	{
+		if (IsQuestDataLoading())
+		{
+			// Handles won't survive the rebuild, so hold the call by identifier instead
+			return ProgressTask(Obj->GetParentQuest()->GetIdentifier(), Obj->GetTaskDefinition(T.TaskIndex).Identifier, Delta);
+		}
+		return Obj->ProgressTask(T.TaskIndex, Delta);
+	}
+	return 0;
+}
+
+int USuqsProgression::ProgressTask(FName QuestID, FName TaskIdentifier, int Delta)
+{
+	if (IsQuestDataLoading())
+	{
+		CallWhenQuestDataReady([this, QuestID, TaskIdentifier, Delta]() { ProgressTask(QuestID, TaskIdentifier, Delta); });
+		return INDEX_NONE;
+	}
+
+	if (QuestID.IsNone())
+	{
+		int MaxLeft = 0;
+		TArray<FSuqsTaskStateRef> Tasks;
+		GetActiveTasks(TaskIdentifier, Tasks);
+		for (const auto& T : Tasks)
+		{
+			if (const auto Obj = T.GetObjective())
+				MaxLeft = std::max(Obj->ProgressTask(T.TaskIndex, Delta), MaxLeft);
+		}
+		return MaxLeft;
+	}
+	else
+	{
+		const auto T = FindTask(QuestID, TaskIdentifier);
+		if (const auto Obj = T.GetObjective())
+		{
+			return Obj->ProgressTask(T.TaskIndex, Delta);
+		}
+		return 0;
+	}
+}
+
+void USuqsProgression::SetTaskNumberCompleted(FName QuestID, FName TaskIdentifier, int Number)
+{
+	if (IsQuestDataLoading())
+	{
+		CallWhenQuestDataReady([this, QuestID, TaskIdentifier, Number]() { SetTaskNumberCompleted(QuestID, TaskIdentifier, Number); });
+		return;
+	}
+
+	if (QuestID.IsNone())
+	{
+		TArray<FSuqsTaskStateRef> Tasks;
+		GetActiveTasks(TaskIdentifier, Tasks);
+		for (const auto& T : Tasks)
+		{
+			if (const auto Obj = T.GetObjective())
+				Obj->SetTaskNumber(T.TaskIndex, Number);
+		}
+	}
+	else
+	{
+		const auto T = FindTask(QuestID, TaskIdentifier);
+		if (const auto Obj = T.GetObjective())
+		{
+			Obj->SetTaskNumber(T.TaskIndex, Number);
+		}
+	}
+}
+
+void USuqsProgression::ResolveTask(FName QuestID, FName TaskIdentifier)
+{
+	if (IsQuestDataLoading())
+	{
+		CallWhenQuestDataReady([this, QuestID, TaskIdentifier]() { ResolveTask(QuestID, TaskIdentifier); });
+		return;
+	}
+
+	if (QuestID.IsNone())
+	{
+		TArray<FSuqsTaskStateRef> Tasks;
+		GetActiveTasks(TaskIdentifier, Tasks);
+		for (const auto& T : Tasks)
+		{
+			if (const auto Obj = T.GetObjective())
+				Obj->ResolveTask(T.TaskIndex);
+		}
+	}
+	else
+	{
+		const auto T = FindTask(QuestID, TaskIdentifier);
+		if (const auto Obj = T.GetObjective())
+		{
+			Obj->ResolveTask(T.TaskIndex);
+		}
+	}
+}
+
+USuqsObjectiveState* USuqsProgression::GetCurrentObjective(FName QuestID) const
+{
+	if (auto Q = FindQuestState(QuestID))
+	{
+		return Q->GetCurrentObjective();
+	}
+	return nullptr;
+}
+
+
+bool USuqsProgression::IsQuestAccepted(FName QuestID) const
+{
+	return QuestStatusLookup.Contains(QuestID);
+}
+
+bool USuqsProgression::IsQuestActive(FName QuestID) const
+{
+	return ActiveQuests.Find(QuestID) != nullptr;
+}
+
+bool USuqsProgression::IsQuestIncomplete(FName QuestID) const
+{
+	// Quests which haven't been accepted are also incomplete
+	const auto pStatus = QuestStatusLookup.Find(QuestID);
+	return !pStatus || *pStatus == ESuqsQuestStatus::Incomplete;
+}
+
+bool USuqsProgression::IsQuestCompleted(FName QuestID) const
+{
+	const auto pStatus = QuestStatusLookup.Find(QuestID);
+	return pStatus && *pStatus == ESuqsQuestStatus::Completed;
+}
+
+bool USuqsProgression::IsQuestFailed(FName QuestID) const
+{
+	const auto pStatus = QuestStatusLookup.Find(QuestID);
+	return pStatus && *pStatus == ESuqsQuestStatus::Failed;
+}
+
+bool USuqsProgression::IsObjectiveIncomplete(FName QuestID, FName ObjectiveID) const
+{
+	if (auto Q = FindQuestState(QuestID))
+	{
+		return Q->IsObjectiveIncomplete(ObjectiveID);
+	}
+	ESuqsObjectiveStatus Status;
+	if (FindArchivedObjectiveStatus(QuestID, ObjectiveID, Status))
+	{
+		return Status != ESuqsObjectiveStatus::Completed && Status != ESuqsObjectiveStatus::Failed;
+	}
+	return false;
+}
+
+bool USuqsProgression::IsObjectiveCompleted(FName QuestID, FName ObjectiveID) const
+{
+	if (auto Q = FindQuestState(QuestID))
+	{
+		return Q->IsObjectiveCompleted(ObjectiveID);
+	}
+	ESuqsObjectiveStatus Status;
+	if (FindArchivedObjectiveStatus(QuestID, ObjectiveID, Status))
+	{
+		return Status == ESuqsObjectiveStatus::Completed;
+	}
+	return false;
+}
+
+bool USuqsProgression::IsObjectiveFailed(FName QuestID, FName ObjectiveID) const
+{
+	if (auto Q = FindQuestState(QuestID))
+	{
+		return Q->IsObjectiveFailed(ObjectiveID);
+	}
+	ESuqsObjectiveStatus Status;
+	if (FindArchivedObjectiveStatus(QuestID, ObjectiveID, Status))
+	{
+		return Status == ESuqsObjectiveStatus::Failed;
+	}
+	return false;
+}
+
+void USuqsProgression::ResetObjective(FName QuestID, FName ObjectiveID)
+{
+	if (IsQuestDataLoading())
+	{
+		CallWhenQuestDataReady([this, QuestID, ObjectiveID]() { ResetObjective(QuestID, ObjectiveID); });
+		return;
+	}
+
+	if (auto Q = FindQuestState(QuestID))
+	{
+		Q->ResetObjective(ObjectiveID);
+	}	
+}
+
+USuqsTaskState* USuqsProgression::GetNextMandatoryTask(FName QuestID) const
+{
+	if (auto Q = FindQuestState(QuestID))
+	{
+		return Q->GetNextMandatoryTask();
+	}
+	return nullptr;
+	
+}
+
+
+bool USuqsProgression::IsTaskIncomplete(FName QuestID, FName TaskID) const
+{
+	if (auto Q = FindQuestState(QuestID))
+	{
+		return Q->IsTaskIncomplete(TaskID);
+	}
+	ESuqsTaskStatus Status;
+	if (FindArchivedTaskStatus(QuestID, TaskID, Status))
+	{
+		return Status != ESuqsTaskStatus::Completed && Status != ESuqsTaskStatus::Failed;
+	}
+	// Should default to TRUE not false if missing (assume incomplete if never accepted)
+	return !IsQuestAccepted(QuestID);
+}
+
+bool USuqsProgression::IsTaskCompleted(FName QuestID, FName TaskID) const
+{
+	if (auto Q = FindQuestState(QuestID))
+	{
+		return Q->IsTaskCompleted(TaskID);
+	}
+	ESuqsTaskStatus Status;
+	if (FindArchivedTaskStatus(QuestID, TaskID, Status))
+	{
+		return Status == ESuqsTaskStatus::Completed;
+	}
+	return false;
+}
+
+bool USuqsProgression::IsTaskFailed(FName QuestID, FName TaskID) const
+{
+	if (auto Q = FindQuestState(QuestID))
+	{
+		return Q->IsTaskFailed(TaskID);
+	}
+	ESuqsTaskStatus Status;
+	if (FindArchivedTaskStatus(QuestID, TaskID, Status))
+	{
+		return Status == ESuqsTaskStatus::Failed;
+	}
+	return false;
+}
+
+bool USuqsProgression::IsTaskRelevant(FName QuestID, FName TaskID) const
+{
+	if (auto Q = FindQuestState(QuestID))
+	{
+		return Q->IsTaskRelevant(TaskID);
+	}
+	return false;
+	
+}
+
+bool USuqsProgression::IsTaskRelevant(FSuqsTaskHandle Task) const
+{
+	const auto T = FindTask(Task);
+	if (const auto Obj = T.GetObjective())
+	{
+		return Obj->IsTaskRelevant(T.TaskIndex);
+	}
+	return false;
+}
+
+USuqsTaskState* USuqsProgression::GetTaskState(FName QuestID, FName TaskID) const
+{
+	if (auto Q = FindQuestState(QuestID))
+	{
+		return Q->GetTask(TaskID);
+	}
+	return nullptr;
+	
+}
+
+void USuqsProgression::ResetTask(FName QuestID, FName TaskID)
+{
+	if (IsQuestDataLoading())
+	{
+		CallWhenQuestDataReady([this, QuestID, TaskID]() { ResetTask(QuestID, TaskID); });
+		return;
+	}
+
+	if (auto Q = FindQuestState(QuestID))
+	{
+		Q->ResetTask(TaskID);
+	}
+}
+
+void USuqsProgression::SetQuestBranchActive(FName QuestID, FName Branch, bool bActive)
+{
+	if (IsQuestDataLoading())
+	{
+		CallWhenQuestDataReady([this, QuestID, Branch, bActive]() { SetQuestBranchActive(QuestID, Branch, bActive); });
+		return;
+	}
+
+	if (auto Q = FindQuestState(QuestID))
+	{
+		Q->SetBranchActive(Branch, bActive);
+	}
+}
+
+
+bool USuqsProgression::IsQuestBranchActive(FName QuestID, FName Branch)
+{
+	if (auto Q = FindExistingQuestState(QuestID))
+	{
+		return Q->IsBranchActive(Branch);
+	}
+	if (const auto pRecord = ArchivedQuestRecords.Find(QuestID))
+	{
+		// No branch is always active
+		if (Branch.IsNone() || pRecord->ActiveBranches.Contains(Branch))
+			return true;
+		// Same as USuqsQuestState::IsBranchActive, global branches count as active for branches the quest doesn't use
+		const FSuqsCompiledQuest* CQ = GetCompiledQuest(GetQuestHandle(QuestID));
+		return (!CQ || !CQ->BranchLookup.Contains(Branch)) && IsGlobalQuestBranchActive(Branch);
+	}
+	return false;
+}
+
+void USuqsProgression::SetGlobalQuestBranchActive(FName Branch, bool bActive)
+{
+	if (IsQuestDataLoading())
+	{
+		CallWhenQuestDataReady([this, Branch, bActive]() { SetGlobalQuestBranchActive(Branch, bActive); });
+		return;
+	}
+
+	if (Branch.IsNone())
+		return;
+
+	bool bChanged = false;;
+	if (bActive)
+	{
+		if (!GlobalActiveBranches.Contains(Branch))
+		{
+			GlobalActiveBranches.Add(Branch);
+			bChanged = true;
+		}
+	}
+	else
+		bChanged = GlobalActiveBranches.Remove(Branch) > 0;
+
+	if (bChanged)
+	{
+		// Copy into temporary list because this can change quest state and move between lists
+		TArray<USuqsQuestState*> ListCopy;
+		GetActiveQuestsUsingBranch(Branch, ListCopy);
+		for (auto Q : ListCopy)
+		{
+			Q->SetBranchActive(Branch, bActive);
+		}
+	}
+}
+
+void USuqsProgression::ResetGlobalQuestBranches()
+{
+	if (IsQuestDataLoading())
+	{
+		CallWhenQuestDataReady([this]() { ResetGlobalQuestBranches(); });
+		return;
+	}
+
+	TArray<USuqsQuestState*> ListCopy;
+	for (auto& Branch : GlobalActiveBranches)
+	{
+		// Copy into temporary list because this can change quest state and move between lists
+		GetActiveQuestsUsingBranch(Branch, ListCopy);
+		for (auto Q : ListCopy)
+		{
+			Q->SetBranchActive(Branch, false);
+		}
+	}
+	GlobalActiveBranches.Empty();
+}
+
+bool USuqsProgression::IsGlobalQuestBranchActive(FName Branch)
+{
+	// No branch is always active
+	if (Branch.IsNone())
+		return true;
+
+	return GlobalActiveBranches.Contains(Branch);
+}
+
+const TArray<FName>& USuqsProgression::GetGlobalActiveQuestBranches() const
+{
+	return GlobalActiveBranches;
+}
+
+void USuqsProgression::SetGateOpen(FName GateName, bool bOpen)
+{
+	if (IsQuestDataLoading())
+	{
+		CallWhenQuestDataReady([this, GateName, bOpen]() { SetGateOpen(GateName, bOpen); });
+		return;
+	}
+
+	// Ignore nonsense
+	if (GateName.IsNone())
+		return;
+	
+	if (bOpen)
+	{
+		bool bWasAlreadyPresent;
+		OpenGates.Add(GateName, &bWasAlreadyPresent);
+		FSuqsGateWaiters Waiters;
+		// Take the list since this change may cascade to completing quests, which may add barriers
+		if (!bWasAlreadyPresent && GateWaiters.RemoveAndCopyValue(GateName, Waiters))
+		{
+			// Tasks first so that objectives & tasks are finished before quests, as in USuqsQuestState::NotifyGateOpened
+			for (const auto& Task : Waiters.Tasks)
+			{
+				const auto Obj = Task.GetObjective();
+				if (Obj && IsActiveQuestInstance(Obj->GetParentQuest()))
+				{
+					Obj->NotifyTaskGateOpened(Task.TaskIndex, GateName);
+				}
+			}
+			for (const auto& WeakQuest : Waiters.Quests)
+			{
+				const auto Quest = WeakQuest.Get();
+				if (IsActiveQuestInstance(Quest) &&
+					Quest->IsResolveBlockedOn(ESuqsResolveBarrierCondition::Gate) &&
+					Quest->ResolveBarrier.Gate == GateName)
+				{
+					Quest->MaybeNotifyStatusChange();
+				}
+			}
+		}
+	}
+	else
+		OpenGates.Remove(GateName);
+}
+
+bool USuqsProgression::IsGateOpen(FName GateName)
+{
+	// No gate is always OK
+	if (GateName.IsNone())
+		return true;
+
+	return OpenGates.Contains(GateName);
+}
+
+bool USuqsProgression::QuestDependenciesMet(const FName& QuestID)
+{
+	if (const int32* pIndex = QuestHandleLookup.Find(QuestID))
+	{
+		return UnmetPrerequisiteCounts[*pIndex] == 0;
+	}
+	return false;
+
+}
+
+void USuqsProgression::AddParameterProvider(UObject* Provider)
+{
+	if (IsValid(Provider) && Provider->Implements<USuqsParameterProvider>())
+	{
+		const int PrevNum = ParameterProviders.Num();
+		const int NewIdx = ParameterProviders.AddUnique(Provider);
+		if (NewIdx >= PrevNum)
+		{
+			// This might cause active tasks to change their text
+			OnParameterProvidersChanged.Broadcast(this);
+		}
+	}
+	else
+	{
+		UE_LOG(LogSUQS, Error, TEXT("Provider passed to AddFormatter is either invalid or doesn't implement ISuqsParameterProvider, ignoring."))
+	}
+}
+
+void USuqsProgression::RemoveParameterProvider(UObject* Provider)
+{
+	ParameterProviders.Remove(Provider);
+}
+
+void USuqsProgression::RemoveAllParameterProviders()
+{
+	ParameterProviders.Empty();
+}
+
+FText USuqsProgression::FormatQuestOrTaskText(const FName& QuestID, const FName& TaskID, const FText& FormatText)
+{
+	if (!IsValid(FormatParams))
+		FormatParams = NewObject<USuqsNamedFormatParams>();
+	else
+		FormatParams->Empty();
+
+	if (const auto Instance = GetQuestInstance(QuestID))
+	{
+		for (const auto& Pair : Instance->Parameters)
+		{
+			FormatParams->SetParameter(Pair.Key, Pair.Value);
+		}
+	}
+
+	for (int i = 0; i < ParameterProviders.Num(); ++i)
+	{
+		auto F = ParameterProviders[i];
+		if (F.IsValid())
+		{
+			ISuqsParameterProvider::Execute_GetQuestParameters(F.Get(), QuestID, TaskID, FormatParams);
+		}
+		else
+		{
+			// Weak pointer to deleted object, tidy up so these don't accumulate
+			ParameterProviders.RemoveAt(i);
+			--i;
+		}
+	}
+
+	return FormatParams->Format(FormatText);
 }
 
-void USuqsProgression::FailQuest(FName QuestID)
+FText USuqsProgression::FormatQuestText(const FName& QuestID, const FText& FormatText)
 {
-	auto Q = FindQuestState(QuestID);
-	if (Q)
-		Q->Fail();
+	static FName NoTaskID;
+	return FormatQuestOrTaskText(QuestID, NoTaskID, FormatText);
 
-	// note we don't update quest lists here, but we rely on callbacks since you could fail via the quest itself
 }
 
-void USuqsProgression::CompleteQuest(FName QuestID)
+FText USuqsProgression::FormatTaskText(const FName& QuestID, const FName& TaskID, const FText& FormatText)
 {
-	auto Q = FindQuestState(QuestID);
-	if (Q)
-		Q->Complete();
-	
+	return FormatQuestOrTaskText(QuestID, TaskID, FormatText);
 }
 
-void USuqsProgression::ResolveQuest(FName QuestID)
+bool USuqsProgression::GetTextNeedsFormatting(const FText& Text)
 {
-	auto Q = FindQuestState(QuestID);
-	if (Q)
-		Q->Resolve();
-	
+	// Determine whether there are any parameters in the text
+	// This picks up both ordered and named, but we don't support ordered for simplicity (and it's generally a bad idea)
+	TArray<FString> Params;
+	FText::GetFormatPatternParameters(Text, Params);
+
+	return Params.Num() > 0;
 }
 
-void USuqsProgression::FailTask(FName QuestID, FName TaskIdentifier)
+void USuqsProgression::QueueOrBroadcastEvent(const FSuqsProgressionEventDetails& Evt)
 {
-	if (QuestID.IsNone())
+	if (IsQueuingEvents())
 	{
-		for (auto Pair : ActiveQuests)
+		// Identical events are combined if allowed, keeping the position of the latest one so that sequences like
+		// added / removed / added end up in the right final state
+		if (IsEventTypeCoalesced(Evt.EventType))
 		{
-			Pair.Value->FailTask(TaskIdentifier);
+			if (const int32* pPrevIndex = QueuedEventIndices.Find(Evt))
+			{
+				SupersededEvents[*pPrevIndex] = true;
+			}
+			QueuedEventIndices.Add(Evt, QueuedEvents.Num());
 		}
+		QueuedEvents.Add(Evt);
+		SupersededEvents.Add(false);
 	}
 	else
 	{
-		auto T = FindTaskStatus(QuestID, TaskIdentifier);
-		if (T)
-		{
-			T->Fail();
-		}
+		BroadcastEvent(Evt);
 	}
 }
 
-
-bool USuqsProgression::CompleteTask(FName QuestID, FName TaskIdentifier)
+void USuqsProgression::BroadcastEvent(const FSuqsProgressionEventDetails& Evt)
 {
-	if (QuestID.IsNone())
-	{
-		bool bCompleted = false;
-		for (auto Pair : ActiveQuests)
-		{
-			bCompleted = Pair.Value->CompleteTask(TaskIdentifier) || bCompleted;
-		}
-		if (bCompleted)
-			return true;
-	}
-	else
+	++EventBroadcastDepth;
+	// Specific events first, then the general one
+	switch (Evt.EventType)
 	{
-		auto T = FindTaskStatus(QuestID, TaskIdentifier);
-		if (T)
-		{
-			return T->Complete();
-		}
+	case ESuqsProgressionEventType::ActiveQuestsChanged:
+		OnActiveQuestsListChanged.Broadcast();
+		break;
+	case ESuqsProgressionEventType::QuestAccepted:
+		OnQuestAccepted.Broadcast(Evt.Quest);
+		break;
+	case ESuqsProgressionEventType::QuestCompleted:
+		OnQuestCompleted.Broadcast(Evt.Quest);
+		break;
+	case ESuqsProgressionEventType::QuestFailed:
+		OnQuestFailed.Broadcast(Evt.Quest);
+		break;
+	case ESuqsProgressionEventType::ObjectiveCompleted:
+		OnObjectiveCompleted.Broadcast(Evt.Objective);
+		break;
+	case ESuqsProgressionEventType::ObjectiveFailed:
+		OnObjectiveFailed.Broadcast(Evt.Objective);
+		break;
+	case ESuqsProgressionEventType::TaskUpdated:
+		OnTaskUpdated.Broadcast(Evt.Task);
+		break;
+	case ESuqsProgressionEventType::TaskCompleted:
+		OnTaskCompleted.Broadcast(Evt.Task);
+		break;
+	case ESuqsProgressionEventType::TaskFailed:
+		OnTaskFailed.Broadcast(Evt.Task);
+		break;
+	default:
+		break;
 	}
-	UE_LOG(LogSUQS, Warning, TEXT("Attempted to complete task %s/%s but it was not found in the active quests"),
-		*QuestID.ToString(), *TaskIdentifier.ToString());
-	return false;
+	OnProgressionEvent.Broadcast(Evt);
+	--EventBroadcastDepth;
+
+	PoolPendingQuestStates();
 }
 
-int USuqsProgression::ProgressTask(FName QuestID, FName TaskIdentifier, int Delta)
+void USuqsProgression::BroadcastQueuedEvents()
 {
-	if (QuestID.IsNone())
-	{
-		int MaxLeft = 0;
-		for (auto Pair : ActiveQuests)
-		{
-			MaxLeft = std::max(Pair.Value->ProgressTask(TaskIdentifier, Delta), MaxLeft);
-		}
-		return MaxLeft;
-	}
-	else
+	// Move out first, listeners can make further changes which raise more events
+	const TArray<FSuqsProgressionEventDetails> Events = MoveTemp(QueuedEvents);
+	const TBitArray<> Superseded = MoveTemp(SupersededEvents);
+	QueuedEvents.Reset();
+	SupersededEvents.Reset();
+	QueuedEventIndices.Reset();
+
+	++EventBroadcastDepth;
+	for (int i = 0; i < Events.Num(); ++i)
 	{
-		auto T = FindTaskStatus(QuestID, TaskIdentifier);
-		if (T)
-		{
-			return T->Progress(Delta);
-		}
-		return 0;
+		if (!Superseded[i])
+			BroadcastEvent(Events[i]);
 	}
+	--EventBroadcastDepth;
+
+	PoolPendingQuestStates();
 }
 
-void USuqsProgression::SetTaskNumberCompleted(FName QuestID, FName TaskIdentifier, int Number)
+void USuqsProgression::BeginBatch()
 {
-	if (QuestID.IsNone())
-	{
-		int MaxLeft = 0;
-		for (auto Pair : ActiveQuests)
-		{
-			Pair.Value->SetTaskNumberCompleted(TaskIdentifier, Number);
-		}
-	}
-	else
-	{
-		auto T = FindTaskStatus(QuestID, TaskIdentifier);
-		if (T)
-		{
-			return T->SetNumber(Number);
-		}
-	}
+	++BatchDepth;
 }
 
-void USuqsProgression::ResolveTask(FName QuestID, FName TaskIdentifier)
+void USuqsProgression::EndBatch()
 {
-	if (QuestID.IsNone())
+	if (BatchDepth <= 0)
 	{
-		for (auto Pair : ActiveQuests)
-		{
-			Pair.Value->ResolveTask(TaskIdentifier);
-		}
+		UE_LOG(LogSUQS, Error, TEXT("EndBatch called without a matching BeginBatch, ignoring"));
+		return;
 	}
-	else
+
+	if (--BatchDepth > 0)
+		return;
+
+	// Keep queuing events while deferred changes propagate, so listeners only see the final state
+	bFlushingBatch = true;
+	// Objectives first, since quests re-scan objectives. Processing can defer nothing further now we're not batching,
+	// but quests can pull their own objectives out of the list so re-check each time
+	while (DeferredObjectiveUpdates.Num() > 0 || DeferredQuestUpdates.Num() > 0)
 	{
-		auto T = FindTaskStatus(QuestID, TaskIdentifier);
-		if (T)
+		if (DeferredObjectiveUpdates.Num() > 0)
+		{
+			const auto Obj = DeferredObjectiveUpdates[0];
+			DeferredObjectiveUpdates.RemoveAt(0);
+			Obj->NotifyTaskStatusChanged(INDEX_NONE);
+		}
+		else
 		{
-			T->Resolve();
+			const auto Q = DeferredQuestUpdates[0];
+			DeferredQuestUpdates.RemoveAt(0);
+			Q->NotifyObjectiveStatusChanged();
 		}
 	}
-}
+	bFlushingBatch = false;
 
-USuqsObjectiveState* USuqsProgression::GetCurrentObjective(FName QuestID) const
-{
-	if (auto Q = FindQuestState(QuestID))
-	{
-		return Q->GetCurrentObjective();
-	}
-	return nullptr;
+	// Deferred events wait for the next tick
+	if (!bDeferEvents)
+		BroadcastQueuedEvents();
 }
 
-
-bool USuqsProgression::IsQuestAccepted(FName QuestID) const
+void USuqsProgression::SetDeferEvents(bool bDefer)
 {
-	if (FindQuestState(QuestID))
-	{
-		return true;
-	}
-	return false;
+	bDeferEvents = bDefer;
+	// Don't leave anything stranded
+	if (!IsQueuingEvents() && QueuedEvents.Num() > 0)
+		BroadcastQueuedEvents();
 }
 
-bool USuqsProgression::IsQuestActive(FName QuestID) const
+void USuqsProgression::SetEventTypeCoalesced(ESuqsProgressionEventType EventType, bool bCoalesce)
 {
-	return ActiveQuests.Find(QuestID) != nullptr;
+	if (bCoalesce)
+		CoalescedEventTypes |= EventTypeBit(EventType);
+	else
+		CoalescedEventTypes &= ~EventTypeBit(EventType);
 }
 
-bool USuqsProgression::IsQuestIncomplete(FName QuestID) const
+bool USuqsProgression::DeferObjectiveUpdate(USuqsObjectiveState* Objective)
 {
-	if (auto Q = FindQuestState(QuestID))
-	{
-		return Q->IsIncomplete();
-	}
+	// Quests being loaded are always processed immediately
+	if (BatchDepth == 0 || Objective->GetParentQuest()->IsLoading())
+		return false;
+
+	DeferredObjectiveUpdates.AddUnique(Objective);
 	return true;
 }
 
-bool USuqsProgression::IsQuestCompleted(FName QuestID) const
+bool USuqsProgression::DeferQuestUpdate(USuqsQuestState* Quest)
 {
-	if (auto Q = FindQuestState(QuestID))
-	{
-		return Q->IsCompleted();
-	}
-	return false;
+	if (BatchDepth == 0 || Quest->IsLoading())
+		return false;
+
+	DeferredQuestUpdates.AddUnique(Quest);
+	return true;
 }
 
-bool USuqsProgression::IsQuestFailed(FName QuestID) const
+bool USuqsProgression::ProcessDeferredObjectiveUpdates(USuqsQuestState* Quest)
 {
-	if (auto Q = FindQuestState(QuestID))
+	if (DeferredObjectiveUpdates.Num() == 0 && DeferredQuestUpdates.Num() == 0)
+		return false;
+
+	bool bProcessed = false;
+	// Processing an objective can cascade into the quest and process others, so search again each time
+	int Index;
+	while ((Index = DeferredObjectiveUpdates.IndexOfByPredicate(
+		[Quest](const USuqsObjectiveState* O) { return O->GetParentQuest() == Quest; })) != INDEX_NONE)
 	{
-		return Q->IsFailed();
+		const auto Obj = DeferredObjectiveUpdates[Index];
+		DeferredObjectiveUpdates.RemoveAt(Index);
+		Obj->NotifyTaskStatusChanged(INDEX_NONE);
+		bProcessed = true;
 	}
-	return false;
+	// Quest is about to re-scan anyway
+	return DeferredQuestUpdates.Remove(Quest) > 0 || bProcessed;
 }
 
-bool USuqsProgression::IsObjectiveIncomplete(FName QuestID, FName ObjectiveID) const
+USuqsTaskState* USuqsProgression::GetTaskForEvent(USuqsObjectiveState* Objective,
+	int TaskIndex,
+	ESuqsProgressionEventType EventType) const
 {
-	if (auto Q = FindQuestState(QuestID))
+	// Task states are only created when something needs them, and nothing needs them for an event nobody hears
+	bool bListening = OnProgressionEvent.IsBound();
+	switch (EventType)
 	{
-		return Q->IsObjectiveIncomplete(ObjectiveID);
+	case ESuqsProgressionEventType::TaskUpdated:
+		bListening = bListening || OnTaskUpdated.IsBound();
+		break;
+	case ESuqsProgressionEventType::TaskCompleted:
+		bListening = bListening || OnTaskCompleted.IsBound();
+		break;
+	case ESuqsProgressionEventType::TaskFailed:
+		bListening = bListening || OnTaskFailed.IsBound();
+		break;
+	default:
+		break;
 	}
-	return false;
-	
+	return bListening ? Objective->GetTask(TaskIndex) : nullptr;
 }
 
-bool USuqsProgression::IsObjectiveCompleted(FName QuestID, FName ObjectiveID) const
+USuqsTaskState* USuqsProgression::GetTaskWithWaypoints(USuqsObjectiveState* Objective, int TaskIndex) const
 {
-	if (auto Q = FindQuestState(QuestID))
+	// A task state which already exists has its own cache of waypoints
+	if (Objective->HasTaskObject(TaskIndex))
+		return Objective->GetTask(TaskIndex);
+
+	// Otherwise only create one if the waypoint subsystem has had waypoints registered for the task
+	if (IsValid(GetWorld()))
 	{
-		return Q->IsObjectiveCompleted(ObjectiveID);
+		const auto GI = UGameplayStatics::GetGameInstance(this);
+		const auto Suqs = IsValid(GI) ? GI->GetSubsystem<USuqsWaypointSubsystem>() : nullptr;
+		if (Suqs && Suqs->GetTaskGeneration(Objective->GetParentQuest()->GetIdentifier(),
+		                                    Objective->GetTaskDefinition(TaskIndex).Identifier) != 0)
+		{
+			return Objective->GetTask(TaskIndex);
+		}
 	}
-	return false;
+	return nullptr;
 }
 
-bool USuqsProgression::IsObjectiveFailed(FName QuestID, FName ObjectiveID) const
+void USuqsProgression::RaiseTaskUpdated(USuqsObjectiveState* Objective, int TaskIndex)
 {
-	if (auto Q = FindQuestState(QuestID))
+	// When events are deferred, these are combined per tick (see SetDeferEvents)
+	if (!bSuppressEvents)
 	{
-		return Q->IsObjectiveFailed(ObjectiveID);
+		if (const auto Task = GetTaskForEvent(Objective, TaskIndex, ESuqsProgressionEventType::TaskUpdated))
+			QueueOrBroadcastEvent(FSuqsProgressionEventDetails(ESuqsProgressionEventType::TaskUpdated, Task));
+		
+		// A task that hasn't changed visibility but has changed status may need its waypoints enabling/disabling
+		SetTaskWaypointsCurrent(Objective, TaskIndex, Objective->IsTaskIncomplete(TaskIndex));
 	}
-	return false;
 }
 
-void USuqsProgression::ResetObjective(FName QuestID, FName ObjectiveID)
+void USuqsProgression::SetTaskWaypointsCurrent(USuqsObjectiveState* Objective, int TaskIndex, bool bIsCurrent)
 {
-	if (auto Q = FindQuestState(QuestID))
+	const auto Task = GetTaskWithWaypoints(Objective, TaskIndex);
+	if (!Task)
+		return;
+
+	// Index loop because listeners to waypoint changes could register / unregister waypoints, invalidating the cache
+	const auto& Waypoints = Task->GetAllWaypoints();
+	for (int i = 0; i < Waypoints.Num(); ++i)
 	{
-		Q->ResetObjective(ObjectiveID);
-	}	
+		if (const auto W = Waypoints[i].Get())
+		{
+			W->SetIsCurrent(bIsCurrent);
+		}
+	}
 }
 
-USuqsTaskState* USuqsProgression::GetNextMandatoryTask(FName QuestID) const
+void USuqsProgression::RaiseTaskCompleted(USuqsObjectiveState* Objective, int TaskIndex)
 {
-	if (auto Q = FindQuestState(QuestID))
+	if (!bSuppressEvents)
 	{
-		return Q->GetNextMandatoryTask();
+		if (const auto Task = GetTaskForEvent(Objective, TaskIndex, ESuqsProgressionEventType::TaskCompleted))
+			QueueOrBroadcastEvent(FSuqsProgressionEventDetails(ESuqsProgressionEventType::TaskCompleted, Task));
 	}
-	return nullptr;
+	// A task being completed means its waypoints are no longer needed
+	SetTaskWaypointsCurrent(Objective, TaskIndex, false);
 	
 }
 
-
-bool USuqsProgression::IsTaskIncomplete(FName QuestID, FName TaskID) const
+void USuqsProgression::RaiseTaskAdded(USuqsObjectiveState* Objective, int TaskIndex)
 {
-	if (auto Q = FindQuestState(QuestID))
+	if (!bSuppressEvents)
 	{
-		return Q->IsTaskIncomplete(TaskID);
+		if (const auto Task = GetTaskForEvent(Objective, TaskIndex, ESuqsProgressionEventType::TaskAdded))
+			QueueOrBroadcastEvent(FSuqsProgressionEventDetails(ESuqsProgressionEventType::TaskAdded, Task));
 	}
-	// Should default to TRUE not false if missing (assume incomplete if never accepted)
-	return true;
-}
+	const auto Task = GetTaskWithWaypoints(Objective, TaskIndex);
+	if (!Task)
+		return;
 
-bool USuqsProgression::IsTaskCompleted(FName QuestID, FName TaskID) const
-{
-	if (auto Q = FindQuestState(QuestID))
+	// A task being added means its waypoints become relevant, so we should get events for them being changed
+	// Index loop because listeners to waypoint changes could register / unregister waypoints, invalidating the cache
+	const auto& Waypoints = Task->GetAllWaypoints();
+	for (int i = 0; i < Waypoints.Num(); ++i)
 	{
-		return Q->IsTaskCompleted(TaskID);
+		const auto W = Waypoints[i].Get();
+		if (!W)
+			continue;
+		W->SetIsCurrent(true);
+
+		// Take this opportunity to sub to events
+		if (!bSubcribedToWaypointEvents)
+		{
+			const auto GI = UGameplayStatics::GetGameInstance(W);
+			if (IsValid(GI))
+			{
+				auto Suqs = GI->GetSubsystem<USuqsWaypointSubsystem>();
+				Suqs->OnAnyWaypointMoved.AddDynamic(this, &USuqsProgression::OnWaypointMoved);
+				Suqs->OnAnyWaypointEnabledChanged.AddDynamic(this, &USuqsProgression::OnWaypointEnabledChanged);
+				bSubcribedToWaypointEvents = true;
+			}
+		}
 	}
-	return false;
 }
 
-bool USuqsProgression::IsTaskFailed(FName QuestID, FName TaskID) const
+void USuqsProgression::RaiseTaskRemoved(USuqsObjectiveState* Objective, int TaskIndex)
 {
-	if (auto Q = FindQuestState(QuestID))
+	if (!bSuppressEvents)
 	{
-		return Q->IsTaskFailed(TaskID);
+		if (const auto Task = GetTaskForEvent(Objective, TaskIndex, ESuqsProgressionEventType::TaskRemoved))
+			QueueOrBroadcastEvent(FSuqsProgressionEventDetails(ESuqsProgressionEventType::TaskRemoved, Task));
 	}
-	return false;
+	// A task being removed means its waypoints are no longer relevant
+	SetTaskWaypointsCurrent(Objective, TaskIndex, false);
 }
 
-bool USuqsProgression::IsTaskRelevant(FName QuestID, FName TaskID) const
+void USuqsProgression::RaiseTaskFailed(USuqsObjectiveState* Objective, int TaskIndex)
 {
-	if (auto Q = FindQuestState(QuestID))
+	if (!bSuppressEvents)
 	{
-		return Q->IsTaskRelevant(TaskID);
+		if (const auto Task = GetTaskForEvent(Objective, TaskIndex, ESuqsProgressionEventType::TaskFailed))
+			QueueOrBroadcastEvent(FSuqsProgressionEventDetails(ESuqsProgressionEventType::TaskFailed, Task));
 	}
-	return false;
+	// A task being failed means its waypoints are no longer needed
+	SetTaskWaypointsCurrent(Objective, TaskIndex, false);
 	
 }
 
-USuqsTaskState* USuqsProgression::GetTaskState(FName QuestID, FName TaskID) const
+
+void USuqsProgression::RaiseObjectiveCompleted(USuqsObjectiveState* Objective)
 {
-	if (auto Q = FindQuestState(QuestID))
+	if (!bSuppressEvents)
 	{
-		return Q->GetTask(TaskID);
+		QueueOrBroadcastEvent(FSuqsProgressionEventDetails(ESuqsProgressionEventType::ObjectiveCompleted, Objective));
 	}
-	return nullptr;
-	
 }
 
-void USuqsProgression::ResetTask(FName QuestID, FName TaskID)
+void USuqsProgression::RaiseObjectiveFailed(USuqsObjectiveState* Objective)
 {
-	if (auto Q = FindQuestState(QuestID))
+	if (!bSuppressEvents)
 	{
-		Q->ResetTask(TaskID);
+		QueueOrBroadcastEvent(FSuqsProgressionEventDetails(ESuqsProgressionEventType::ObjectiveFailed, Objective));
 	}
 }
 
-void USuqsProgression::SetQuestBranchActive(FName QuestID, FName Branch, bool bActive)
+
+void USuqsProgression::RaiseQuestCompleted(USuqsQuestState* Quest)
 {
-	if (auto Q = FindQuestState(QuestID))
+	UpdateQuestLookups(Quest);
+	if (!bSuppressEvents)
 	{
-		Q->SetBranchActive(Branch, bActive);
+		QueueOrBroadcastEvent(FSuqsProgressionEventDetails(ESuqsProgressionEventType::QuestCompleted, Quest));
 	}
-}
 
+	// We don't process changes caused by complete / fail until barriers resolved (see ProcessQuestStatusChange)
+	
+}
 
-bool USuqsProgression::IsQuestBranchActive(FName QuestID, FName Branch)
+void USuqsProgression::RaiseQuestFailed(USuqsQuestState* Quest)
 {
-	if (auto Q = FindQuestState(QuestID))
+	UpdateQuestLookups(Quest);
+	if (!bSuppressEvents)
 	{
-		return Q->IsBranchActive(Branch);
+		QueueOrBroadcastEvent(FSuqsProgressionEventDetails(ESuqsProgressionEventType::QuestFailed, Quest));
 	}
-	return false;
+
+	// We don't process changes caused by complete / fail until barriers resolved (see ProcessQuestStatusChange)
+	
 }
 
-void USuqsProgression::SetGlobalQuestBranchActive(FName Branch, bool bActive)
+void USuqsProgression::RaiseQuestReset(USuqsQuestState* Quest)
 {
-	if (Branch.IsNone())
-		return;
-
-	bool bChanged = false;;
-	if (bActive)
+	// Move quest to the correct list immediately, unlike complete / fail
+	const int NumRemoved = QuestArchive.Remove(Quest->GetIdentifier());
+	AddActiveQuest(Quest);
+	
+	if (!bSuppressEvents)
 	{
-		if (!GlobalActiveBranches.Contains(Branch))
+		// Always raise as new acceptance
+		QueueOrBroadcastEvent(FSuqsProgressionEventDetails(ESuqsProgressionEventType::QuestAccepted, Quest));
+		
+		// Only raise list change if moved from archived
+		if (NumRemoved > 0)
 		{
-			GlobalActiveBranches.Add(Branch);
-			bChanged = true;
+			QueueOrBroadcastEvent(FSuqsProgressionEventDetails(ESuqsProgressionEventType::ActiveQuestsChanged));
 		}
 	}
-	else
-		bChanged = GlobalActiveBranches.Remove(Branch) > 0;
+}
 
-	if (bChanged)
+void USuqsProgression::RaiseCurrentObjectiveChanged(USuqsQuestState* Quest)
+{
+	if (!bSuppressEvents)
 	{
-		// Copy into temporary list because this can change quest state and move between lists
-		TArray<USuqsQuestState*> ListCopy;
-		ActiveQuests.GenerateValueArray(ListCopy);
-		for (auto Q : ListCopy)
+		QueueOrBroadcastEvent(FSuqsProgressionEventDetails(ESuqsProgressionEventType::QuestCurrentObjectiveChanged, Quest));
+
+		// Also raise events for every task which is now relevant
+		if (const auto Obj = Quest->GetCurrentObjective())
 		{
-			Q->SetBranchActive(Branch, bActive);
+			for (int i = 0; i < Obj->GetNumTasks(); ++i)
+			{
+				if (!Obj->GetTaskHidden(i))
+					RaiseTaskAdded(Obj, i);
+			}
 		}
+		
 	}
 }
 
-void USuqsProgression::ResetGlobalQuestBranches()
+void USuqsProgression::ProcessQuestStatusChange(USuqsQuestState* Quest)
 {
-	for (auto& Branch : GlobalActiveBranches)
+	// Quest list and dependent quest acceptance is potentially delayed for completion / failed
+	const ESuqsQuestStatus Status = Quest->GetStatus();
+	if (Status == ESuqsQuestStatus::Completed ||
+		Status == ESuqsQuestStatus::Failed)
 	{
-		// Copy into temporary list because this can change quest state and move between lists
-		TArray<USuqsQuestState*> ListCopy;
-		ActiveQuests.GenerateValueArray(ListCopy);
-		for (auto Q : ListCopy)
+		// Move quest to the correct list
+		RemoveActiveQuest(Quest->GetIdentifier());
+		QuestArchive.Add(Quest->GetIdentifier(), Quest);
+		UpdateQuestLookups(Quest);
+		if (!bSuppressEvents)
 		{
-			Q->SetBranchActive(Branch, false);
+			QueueOrBroadcastEvent(FSuqsProgressionEventDetails(ESuqsProgressionEventType::QuestArchived, Quest));
+			// Raise this here for the purpose of archive quests
+			// Auto-accepts will raise this again
+			QueueOrBroadcastEvent(FSuqsProgressionEventDetails(ESuqsProgressionEventType::ActiveQuestsChanged));
 		}
+		
+		// Rebuilding an archived quest from its record isn't a new completion / failure
+		if (!bHydratingArchivedQuest)
+			AutoAcceptQuests(Quest->GetIdentifier(), Status == ESuqsQuestStatus::Failed);
+		
 	}
-	GlobalActiveBranches.Empty();
 }
 
-bool USuqsProgression::IsGlobalQuestBranchActive(FName Branch)
+void USuqsProgression::AddActiveQuest(USuqsQuestState* Quest)
 {
-	// No branch is always active
-	if (Branch.IsNone())
-		return true;
+	const FName& QuestID = Quest->GetIdentifier();
+	if (ActiveQuests.FindRef(QuestID) == Quest)
+	{
+		// Already active but status may have changed
+		UpdateQuestLookups(Quest);
+		return;
+	}
 
-	return GlobalActiveBranches.Contains(Branch);
-}
+	// Replace any other instance
+	RemoveActiveQuest(QuestID);
+	ActiveQuests.Add(QuestID, Quest);
+	UpdateQuestLookups(Quest);
 
-const TArray<FName>& USuqsProgression::GetGlobalActiveQuestBranches() const
-{
-	return GlobalActiveBranches;
+	for (auto Obj : Quest->GetObjectives())
+	{
+		for (int i = 0; i < Obj->GetNumTasks(); ++i)
+		{
+			ActiveTasksByID.FindOrAdd(Obj->GetTaskDefinition(i).Identifier).Add(FSuqsTaskStateRef(Obj, i));
+		}
+	}
 }
 
-void USuqsProgression::SetGateOpen(FName GateName, bool bOpen)
+void USuqsProgression::RemoveActiveQuest(const FName& QuestID)
 {
-	// Ignore nonsense
-	if (GateName.IsNone())
+	USuqsQuestState* Quest = nullptr;
+	if (!ActiveQuests.RemoveAndCopyValue(QuestID, Quest) || !Quest)
 		return;
-	
-	if (bOpen)
+
+	for (auto Obj : Quest->GetObjectives())
 	{
-		bool bWasAlreadyPresent;
-		OpenGates.Add(GateName, &bWasAlreadyPresent);
-		if (!bWasAlreadyPresent)
+		for (int i = 0; i < Obj->GetNumTasks(); ++i)
 		{
-			TArray<USuqsQuestState*> ActiveQuestList;
-			// Need to copy since this change may cascade to completing quests
-			ActiveQuests.GenerateValueArray(ActiveQuestList);
-			for (auto Quest : ActiveQuestList)
+			const FName& TaskID = Obj->GetTaskDefinition(i).Identifier;
+			if (auto pTasks = ActiveTasksByID.Find(TaskID))
 			{
-				Quest->NotifyGateOpened(GateName);
+				pTasks->RemoveSingle(FSuqsTaskStateRef(Obj, i));
+				if (pTasks->Num() == 0)
+					ActiveTasksByID.Remove(TaskID);
 			}
 		}
 	}
-	else
-		OpenGates.Remove(GateName);
 }
 
-bool USuqsProgression::IsGateOpen(FName GateName)
+USuqsQuestState* USuqsProgression::NewQuestState(const FSuqsQuest* QDef)
 {
-	// No gate is always OK
-	if (GateName.IsNone())
-		return true;
+	USuqsQuestState* Quest = nullptr;
+	if (const int32* pIndex = QuestHandleLookup.Find(QDef->Identifier))
+		QuestStatePool.RemoveAndCopyValue(*pIndex, Quest);
 
-	return OpenGates.Contains(GateName);
+	// Caller (re-)initialises either way
+	return Quest ? Quest : NewObject<USuqsQuestState>(GetOuter());
 }
 
-bool USuqsProgression::QuestDependenciesMet(const FName& QuestID)
+void USuqsProgression::PoolQuestState(USuqsQuestState* Quest)
 {
-	if (auto QuestDef = QuestDefinitions.Find(QuestID))
+	if (!Quest)
+		return;
+
+	// Events already raised or queued can refer to this state, and handlers may still be running code in it, so it
+	// can't be re-initialised until they've all finished
+	if (EventBroadcastDepth > 0 || QueuedEvents.Num() > 0 || BatchDepth > 0 || bFlushingBatch)
 	{
-		for (auto& RequiredCompletedID : QuestDef->PrerequisiteQuests)
-		{
-			if (!IsQuestCompleted(RequiredCompletedID))
-				return false;
-		}
-		for (auto& RequiredFailedID : QuestDef->PrerequisiteQuestFailures)
-		{
-			if (!IsQuestFailed(RequiredFailedID))
-				return false;
-		}
-		return true;
+		PendingQuestStatePool.AddUnique(Quest);
+		return;
 	}
-	return false;
-	
+
+	// Only states no longer in use, built from the current compiled definition, can be re-initialised in place
+	// The quest definition itself may have gone, so don't touch it
+	const int32 QuestIndex = Quest->Handle.Index;
+	if (!CompiledQuests.IsValidIndex(QuestIndex) ||
+		QuestStatesByHandle[QuestIndex] == Quest ||
+		!Quest->IsCompiledDefinitionCurrent())
+		return;
+
+	// Nothing should update it while it's pooled
+	UnscheduleQuestState(Quest);
+	QuestStatePool.Add(QuestIndex, Quest);
 }
 
-void USuqsProgression::AddParameterProvider(UObject* Provider)
+void USuqsProgression::UnscheduleQuestState(USuqsQuestState* Quest)
 {
-	if (IsValid(Provider) && Provider->Implements<USuqsParameterProvider>())
+	TickingQuests.Remove(Quest);
+	DeferredQuestUpdates.Remove(Quest);
+	for (auto Obj : Quest->GetObjectives())
 	{
-		const int PrevNum = ParameterProviders.Num();
-		const int NewIdx = ParameterProviders.AddUnique(Provider);
-		if (NewIdx >= PrevNum)
+		DeferredObjectiveUpdates.Remove(Obj);
+		for (int i = 0; i < Obj->GetNumTasks(); ++i)
 		{
-			// This might cause active tasks to change their text
-			OnParameterProvidersChanged.Broadcast(this);
+			TickingTasks.Remove(FSuqsTaskStateRef(Obj, i));
 		}
 	}
-	else
+	for (auto& Pair : GateWaiters)
 	{
-		UE_LOG(LogSUQS, Error, TEXT("Provider passed to AddFormatter is either invalid or doesn't implement ISuqsParameterProvider, ignoring."))
+		Pair.Value.Quests.Remove(Quest);
+		Pair.Value.Tasks.RemoveAll([Quest](const FSuqsTaskStateRef& T)
+		{
+			return T.Objective.IsValid() && T.Objective->GetParentQuest() == Quest;
+		});
 	}
 }
 
-void USuqsProgression::RemoveParameterProvider(UObject* Provider)
+void USuqsProgression::PoolPendingQuestStates()
 {
-	ParameterProviders.Remove(Provider);
-}
+	if (PendingQuestStatePool.Num() == 0 || EventBroadcastDepth > 0)
+		return;
 
-void USuqsProgression::RemoveAllParameterProviders()
-{
-	ParameterProviders.Empty();
+	// May go straight back to pending if events are still queued
+	const TArray<USuqsQuestState*> Pending = MoveTemp(PendingQuestStatePool);
+	PendingQuestStatePool.Reset();
+	for (auto Q : Pending)
+	{
+		PoolQuestState(Q);
+	}
 }
 
-FText USuqsProgression::FormatQuestOrTaskText(const FName& QuestID, const FName& TaskID, const FText& FormatText)
+void USuqsProgression::UpdateQuestLookups(USuqsQuestState* Quest)
 {
-	if (!IsValid(FormatParams))
-		FormatParams = NewObject<USuqsNamedFormatParams>();
-	else
-		FormatParams->Empty();
-
-	for (int i = 0; i < ParameterProviders.Num(); ++i)
+	// Only the registered instance of a quest is authoritative, others may be mid-initialisation or discarded
+	if (FindExistingQuestState(Quest->GetIdentifier()) == Quest)
 	{
-		auto F = ParameterProviders[i];
-		if (F.IsValid())
-		{
-			ISuqsParameterProvider::Execute_GetQuestParameters(F.Get(), QuestID, TaskID, FormatParams);
-		}
-		else
-		{
-			// Weak pointer to deleted object, tidy up so these don't accumulate
-			ParameterProviders.RemoveAt(i);
-			--i;
-		}
+		const ESuqsQuestStatus* pOldStatus = QuestStatusLookup.Find(Quest->GetIdentifier());
+		const ESuqsQuestStatus OldStatus = pOldStatus ? *pOldStatus : ESuqsQuestStatus::Unavailable;
+		QuestStatusLookup.Add(Quest->GetIdentifier(), Quest->GetStatus());
+		UpdateUnmetPrerequisites(Quest->GetIdentifier(), OldStatus, Quest->GetStatus());
+		if (const int32* pIndex = QuestHandleLookup.Find(Quest->GetIdentifier()))
+			QuestStatesByHandle[*pIndex] = Quest;
 	}
-
-	return FormatParams->Format(FormatText);
 }
 
-FText USuqsProgression::FormatQuestText(const FName& QuestID, const FText& FormatText)
+int32 USuqsProgression::AllocateQuestIndex()
 {
-	static FName NoTaskID;
-	return FormatQuestOrTaskText(QuestID, NoTaskID, FormatText);
+	if (FreeQuestIndexes.Num() > 0)
+		return FreeQuestIndexes.Pop(false);
 
+	QuestStatesByHandle.Add(nullptr);
+	UnmetPrerequisiteCounts.Add(0);
+	return CompiledQuests.AddDefaulted();
 }
 
-FText USuqsProgression::FormatTaskText(const FName& QuestID, const FName& TaskID, const FText& FormatText)
-{
-	return FormatQuestOrTaskText(QuestID, TaskID, FormatText);
-}
-
-bool USuqsProgression::GetTextNeedsFormatting(const FText& Text)
+void USuqsProgression::ReleaseQuestIndex(int32 QuestIndex)
 {
-	// Determine whether there are any parameters in the text
-	// This picks up both ordered and named, but we don't support ordered for simplicity (and it's generally a bad idea)
-	TArray<FString> Params;
-	FText::GetFormatPatternParameters(Text, Params);
-
-	return Params.Num() > 0;
+	// Must already be invalidated. New generation so that handles to the old quest don't resolve to the next one
+	++CompiledQuests[QuestIndex].Generation;
+	QuestStatesByHandle[QuestIndex] = nullptr;
+	UnmetPrerequisiteCounts[QuestIndex] = 0;
+	FreeQuestIndexes.Add(QuestIndex);
 }
 
-void USuqsProgression::RaiseTaskUpdated(USuqsTaskState* Task)
+int32 USuqsProgression::AllocateTaskRange(int32 NumTasks)
 {
-	// might be worth queuing these up and raising combined?
-	if (!bSuppressEvents)
+	// First fit, most quests are replaced by ones of a similar size
+	for (int32 i = 0; NumTasks > 0 && i < FreeTaskRanges.Num(); ++i)
 	{
-		OnTaskUpdated.Broadcast(Task);
-		OnProgressionEvent.Broadcast(FSuqsProgressionEventDetails(ESuqsProgressionEventType::TaskUpdated, Task));
-		
-		// A task that hasn't changed visibility but has changed status may need its waypoints enabling/disabling
-		auto Waypoints = Task->GetWaypoints(false);
-		for (auto W : Waypoints)
+		auto& Range = FreeTaskRanges[i];
+		if (Range.Value >= NumTasks)
 		{
-			W->SetIsCurrent(Task->IsIncomplete());
+			const int32 FirstTask = Range.Key;
+			Range.Key += NumTasks;
+			Range.Value -= NumTasks;
+			if (Range.Value == 0)
+				FreeTaskRanges.RemoveAt(i);
+			return FirstTask;
 		}
 	}
+	return CompiledTasks.AddDefaulted(NumTasks);
 }
 
-void USuqsProgression::RaiseTaskCompleted(USuqsTaskState* Task)
+void USuqsProgression::ReleaseTaskRange(int32 FirstTask, int32 NumTasks)
 {
-	if (!bSuppressEvents)
+	if (NumTasks <= 0)
+		return;
+
+	// Kept sorted & merged with neighbours so that freed ranges don't fragment into pieces too small to re-use
+	const int32 Insert = Algo::LowerBoundBy(FreeTaskRanges, FirstTask, [](const TPair<int32, int32>& R) { return R.Key; });
+	FreeTaskRanges.Insert(TPair<int32, int32>(FirstTask, NumTasks), Insert);
+	if (FreeTaskRanges.IsValidIndex(Insert + 1) && FirstTask + NumTasks == FreeTaskRanges[Insert + 1].Key)
 	{
-		OnTaskCompleted.Broadcast(Task);
-		OnProgressionEvent.Broadcast(FSuqsProgressionEventDetails(ESuqsProgressionEventType::TaskCompleted, Task));
+		FreeTaskRanges[Insert].Value += FreeTaskRanges[Insert + 1].Value;
+		FreeTaskRanges.RemoveAt(Insert + 1);
 	}
-	// A task being completed means its waypoints are no longer needed
-	auto Waypoints = Task->GetWaypoints(false);
-	for (auto W : Waypoints)
+	if (Insert > 0 && FreeTaskRanges[Insert - 1].Key + FreeTaskRanges[Insert - 1].Value == FirstTask)
 	{
-		W->SetIsCurrent(false);
+		FreeTaskRanges[Insert - 1].Value += FreeTaskRanges[Insert].Value;
+		FreeTaskRanges.RemoveAt(Insert);
 	}
-	
 }
 
-void USuqsProgression::RaiseTaskAdded(USuqsTaskState* Task)
+void USuqsProgression::StoreCompiledQuest(int32 QuestIndex, FSuqsCompiledQuest&& Quest, TArray<FSuqsCompiledTask>& Tasks)
 {
-	if (!bSuppressEvents)
+	// Task indexes are local to the quest until stored, freed ranges are re-used before growing
+	Quest.FirstTask = AllocateTaskRange(Tasks.Num());
+	for (auto& Pair : Quest.TaskLookup)
 	{
-		OnProgressionEvent.Broadcast(FSuqsProgressionEventDetails(ESuqsProgressionEventType::TaskAdded, Task));
+		Pair.Value += Quest.FirstTask;
 	}
-	// A task being added means its waypoints become relevant, so we should get events for them being changed
-	auto Waypoints = Task->GetWaypoints(false);
-	for (auto W : Waypoints)
+	for (int32 i = 0; i < Tasks.Num(); ++i)
 	{
-		W->SetIsCurrent(true);
+		auto& CT = CompiledTasks[Quest.FirstTask + i];
+		const uint32 Generation = CT.Generation;
+		CT = Tasks[i];
+		CT.QuestIndex = QuestIndex;
+		CT.Generation = Generation;
+	}
+	for (const auto& Pair : Quest.BranchLookup)
+	{
+		QuestsByBranch.FindOrAdd(Pair.Key).Add(QuestIndex);
+	}
+	// The slot keeps its generation, handles to this quest stay valid when it's recompiled
+	Quest.Generation = CompiledQuests[QuestIndex].Generation;
+	CompiledQuests[QuestIndex] = MoveTemp(Quest);
+}
 
-		// Take this opportunity to sub to events
-		if (!bSubcribedToWaypointEvents)
-		{
-			const auto GI = UGameplayStatics::GetGameInstance(W);
-			if (IsValid(GI))
-			{
-				auto Suqs = GI->GetSubsystem<USuqsWaypointSubsystem>();
-				Suqs->OnAnyWaypointMoved.AddDynamic(this, &USuqsProgression::OnWaypointMoved);
-				Suqs->OnAnyWaypointEnabledChanged.AddDynamic(this, &USuqsProgression::OnWaypointEnabledChanged);
-				bSubcribedToWaypointEvents = true;
-			}
-		}
+int32 USuqsProgression::RecompileQuestDefinition(int32 QuestIndex, const FSuqsQuest& Quest)
+{
+	// Unlinking leaves our dependents waiting on our name, linking again picks them back up
+	UnlinkQuestDependencies(QuestIndex);
+	InvalidateCompiledQuest(QuestIndex);
+
+	FSuqsCompiledQuest CQ;
+	TArray<FSuqsCompiledTask> Tasks;
+	TArray<const FSuqsTask*> DuplicateTasks;
+	CompileQuestDefinition(Quest, GetQuestObjectives(Quest), GetQuestInstance(Quest.Identifier), CQ, Tasks, DuplicateTasks);
+	for (const auto Task : DuplicateTasks)
+	{
+		UE_LOG(LogSUQS, Error, TEXT("Task ID '%s' has been used more than once! Duplicate entry title: %s"), *Task->Identifier.ToString(), *Task->Title.ToString());
 	}
+	// Same quest handle, but new task handles since the number of tasks may have changed
+	StoreCompiledQuest(QuestIndex, MoveTemp(CQ), Tasks);
+	LinkQuestDependencies(QuestIndex);
+	return DuplicateTasks.Num();
 }
 
-void USuqsProgression::RaiseTaskRemoved(USuqsTaskState* Task)
+void USuqsProgression::InvalidateCompiledQuest(int32 QuestIndex)
 {
-	if (!bSuppressEvents)
+	auto& CQ = CompiledQuests[QuestIndex];
+	for (const auto& Pair : CQ.BranchLookup)
 	{
-		OnProgressionEvent.Broadcast(FSuqsProgressionEventDetails(ESuqsProgressionEventType::TaskRemoved, Task));
+		if (auto pQuests = QuestsByBranch.Find(Pair.Key))
+			pQuests->RemoveSingle(QuestIndex);
 	}
-	// A task being removed means its waypoints are no longer relevant
-	auto Waypoints = Task->GetWaypoints(false);
-	for (auto W : Waypoints)
+	// Pooled states were built for the old compiled quest
+	QuestStatePool.Remove(QuestIndex);
+	// Task handles stop resolving, and their range is free for the next quest compiled
+	for (int32 i = CQ.FirstTask; i < CQ.FirstTask + CQ.NumTasks; ++i)
 	{
-		W->SetIsCurrent(false);
+		CompiledTasks[i].QuestIndex = INDEX_NONE;
+		++CompiledTasks[i].Generation;
 	}
+	ReleaseTaskRange(CQ.FirstTask, CQ.NumTasks);
+	const uint32 Generation = CQ.Generation;
+	CQ = FSuqsCompiledQuest();
+	CQ.Generation = Generation;
 }
 
-void USuqsProgression::RaiseTaskFailed(USuqsTaskState* Task)
+void USuqsProgression::LinkQuestDependencies(int32 QuestIndex)
 {
-	if (!bSuppressEvents)
+	// Edges go from prerequisite to dependent, so a quest resolving only visits the quests waiting on it
+	// Prerequisites may already be resolved if this quest was defined at runtime
+	// Copied since a quest can be its own prerequisite, and adding to its dependents would invalidate references
+	const FName QuestID = CompiledQuests[QuestIndex].Identifier;
+	const TArray<FName> PrerequisiteQuests = CompiledQuests[QuestIndex].PrerequisiteQuests;
+	const TArray<FName> PrerequisiteQuestFailures = CompiledQuests[QuestIndex].PrerequisiteQuestFailures;
+	int32 NumUnmet = CompiledQuests[QuestIndex].NumPrerequisites;
+	for (const auto& PrereqID : PrerequisiteQuests)
 	{
-		OnTaskFailed.Broadcast(Task);
-		OnProgressionEvent.Broadcast(FSuqsProgressionEventDetails(ESuqsProgressionEventType::TaskFailed, Task));
+		if (const int32* pPrereqIndex = QuestHandleLookup.Find(PrereqID))
+		{
+			CompiledQuests[*pPrereqIndex].DependentsOnCompletion.Add(QuestIndex);
+			if (IsQuestCompleted(PrereqID))
+				--NumUnmet;
+		}
+		else
+		{
+			UE_LOG(LogSUQS, Warning, TEXT("Quest '%s' has prerequisite quest '%s' which doesn't exist"),
+				*QuestID.ToString(), *PrereqID.ToString());
+			UnresolvedCompletionPrerequisites.Add(PrereqID, QuestIndex);
+		}
 	}
-	// A task being failed means its waypoints are no longer needed
-	auto Waypoints = Task->GetWaypoints(false);
-	for (auto W : Waypoints)
+	for (const auto& PrereqID : PrerequisiteQuestFailures)
 	{
-		W->SetIsCurrent(false);
+		if (const int32* pPrereqIndex = QuestHandleLookup.Find(PrereqID))
+		{
+			CompiledQuests[*pPrereqIndex].DependentsOnFailure.Add(QuestIndex);
+			if (IsQuestFailed(PrereqID))
+				--NumUnmet;
+		}
+		else
+		{
+			UE_LOG(LogSUQS, Warning, TEXT("Quest '%s' has prerequisite quest failure '%s' which doesn't exist"),
+				*QuestID.ToString(), *PrereqID.ToString());
+			UnresolvedFailurePrerequisites.Add(PrereqID, QuestIndex);
+		}
 	}
-	
-}
+	UnmetPrerequisiteCounts[QuestIndex] = NumUnmet;
 
+	// Quests defined earlier may have been waiting for this one
+	auto& CQ = CompiledQuests[QuestIndex];
+	UnresolvedCompletionPrerequisites.MultiFind(QuestID, CQ.DependentsOnCompletion);
+	UnresolvedCompletionPrerequisites.Remove(QuestID);
+	UnresolvedFailurePrerequisites.MultiFind(QuestID, CQ.DependentsOnFailure);
+	UnresolvedFailurePrerequisites.Remove(QuestID);
+}
 
-void USuqsProgression::RaiseObjectiveCompleted(USuqsObjectiveState* Objective)
+void USuqsProgression::UnlinkQuestDependencies(int32 QuestIndex)
 {
-	if (!bSuppressEvents)
+	// Our own prerequisite edges go away with us
+	// Only uses the compiled quest, since the definition may already be gone
+	auto& CQ = CompiledQuests[QuestIndex];
+	for (const auto& PrereqID : CQ.PrerequisiteQuests)
+	{
+		if (const int32* pPrereqIndex = QuestHandleLookup.Find(PrereqID))
+			CompiledQuests[*pPrereqIndex].DependentsOnCompletion.RemoveSingle(QuestIndex);
+		else
+			UnresolvedCompletionPrerequisites.RemoveSingle(PrereqID, QuestIndex);
+	}
+	for (const auto& PrereqID : CQ.PrerequisiteQuestFailures)
 	{
-		OnObjectiveCompleted.Broadcast(Objective);
-		OnProgressionEvent.Broadcast(FSuqsProgressionEventDetails(ESuqsProgressionEventType::ObjectiveCompleted, Objective));
+		if (const int32* pPrereqIndex = QuestHandleLookup.Find(PrereqID))
+			CompiledQuests[*pPrereqIndex].DependentsOnFailure.RemoveSingle(QuestIndex);
+		else
+			UnresolvedFailurePrerequisites.RemoveSingle(PrereqID, QuestIndex);
+	}
+
+	// Quests depending on us are left waiting in case it's defined again
+	// Their counts don't change, quest status is dealt with separately
+	for (const int32 DepIndex : CQ.DependentsOnCompletion)
+	{
+		if (DepIndex != QuestIndex)
+			UnresolvedCompletionPrerequisites.Add(CQ.Identifier, DepIndex);
 	}
+	for (const int32 DepIndex : CQ.DependentsOnFailure)
+	{
+		if (DepIndex != QuestIndex)
+			UnresolvedFailurePrerequisites.Add(CQ.Identifier, DepIndex);
+	}
+	CQ.DependentsOnCompletion.Empty();
+	CQ.DependentsOnFailure.Empty();
 }
 
-void USuqsProgression::RaiseObjectiveFailed(USuqsObjectiveState* Objective)
+void USuqsProgression::UpdateUnmetPrerequisites(const FName& QuestID, ESuqsQuestStatus OldStatus, ESuqsQuestStatus NewStatus)
 {
-	if (!bSuppressEvents)
+	if (OldStatus == NewStatus)
+		return;
+
+	const int32* pIndex = QuestHandleLookup.Find(QuestID);
+	if (!pIndex)
+		return;
+
+	const auto& CQ = CompiledQuests[*pIndex];
+	if (OldStatus == ESuqsQuestStatus::Completed || NewStatus == ESuqsQuestStatus::Completed)
+	{
+		const int32 Delta = NewStatus == ESuqsQuestStatus::Completed ? -1 : 1;
+		for (const int32 DepIndex : CQ.DependentsOnCompletion)
+		{
+			UnmetPrerequisiteCounts[DepIndex] += Delta;
+		}
+	}
+	if (OldStatus == ESuqsQuestStatus::Failed || NewStatus == ESuqsQuestStatus::Failed)
 	{
-		OnObjectiveFailed.Broadcast(Objective);
-		OnProgressionEvent.Broadcast(FSuqsProgressionEventDetails(ESuqsProgressionEventType::ObjectiveFailed, Objective));
+		const int32 Delta = NewStatus == ESuqsQuestStatus::Failed ? -1 : 1;
+		for (const int32 DepIndex : CQ.DependentsOnFailure)
+		{
+			UnmetPrerequisiteCounts[DepIndex] += Delta;
+		}
 	}
 }
 
-
-void USuqsProgression::RaiseQuestCompleted(USuqsQuestState* Quest)
+void USuqsProgression::ResetUnmetPrerequisites()
 {
-	if (!bSuppressEvents)
+	// Call whenever all quest statuses are cleared
+	for (int32 i = 0; i < CompiledQuests.Num(); ++i)
 	{
-		OnQuestCompleted.Broadcast(Quest);
-		OnProgressionEvent.Broadcast(FSuqsProgressionEventDetails(ESuqsProgressionEventType::QuestCompleted, Quest));
+		UnmetPrerequisiteCounts[i] = CompiledQuests[i].NumPrerequisites;
 	}
-
-	// We don't process changes caused by complete / fail until barriers resolved (see ProcessQuestStatusChange)
-	
 }
 
-void USuqsProgression::RaiseQuestFailed(USuqsQuestState* Quest)
+int32 USuqsProgression::CheckQuestDependencyCycles(const TArray<int32>& StartQuestIndexes) const
 {
-	if (!bSuppressEvents)
+	// Any new cycle must include one of the new or changed quests, so only search from those
+	// Depth first with an explicit stack so that long quest chains can't overflow
+	enum class EVisit : uint8 { NotVisited, InProgress, Done };
+	struct FFrame
 	{
-		OnQuestFailed.Broadcast(Quest);
-		OnProgressionEvent.Broadcast(FSuqsProgressionEventDetails(ESuqsProgressionEventType::QuestFailed, Quest));
+		int32 QuestIndex;
+		int32 NextEdge;
+	};
+	TArray<EVisit> Visits;
+	Visits.SetNumZeroed(CompiledQuests.Num());
+	TArray<FFrame> Stack;
+	int32 NumCycles = 0;
+	for (const int32 StartIndex : StartQuestIndexes)
+	{
+		if (Visits[StartIndex] != EVisit::NotVisited || !CompiledQuests[StartIndex].IsValid())
+			continue;
+
+		Visits[StartIndex] = EVisit::InProgress;
+		Stack.Add(FFrame { StartIndex, 0 });
+		while (Stack.Num() > 0)
+		{
+			FFrame& Top = Stack.Last();
+			const auto& CQ = CompiledQuests[Top.QuestIndex];
+			const int32 NumCompletionEdges = CQ.DependentsOnCompletion.Num();
+			if (Top.NextEdge < NumCompletionEdges + CQ.DependentsOnFailure.Num())
+			{
+				const int32 Next = Top.NextEdge < NumCompletionEdges ?
+					CQ.DependentsOnCompletion[Top.NextEdge] : CQ.DependentsOnFailure[Top.NextEdge - NumCompletionEdges];
+				++Top.NextEdge;
+				if (Visits[Next] == EVisit::InProgress)
+				{
+					FString Cycle;
+					for (int32 i = Stack.IndexOfByPredicate([Next](const FFrame& F) { return F.QuestIndex == Next; }); i < Stack.Num(); ++i)
+					{
+						Cycle += CompiledQuests[Stack[i].QuestIndex].Identifier.ToString() + TEXT(" -> ");
+					}
+					Cycle += CompiledQuests[Next].Identifier.ToString();
+					UE_LOG(LogSUQS, Error, TEXT("Quest prerequisites form a cycle, these quests can never be auto-accepted: %s"), *Cycle);
+					++NumCycles;
+				}
+				else if (Visits[Next] == EVisit::NotVisited)
+				{
+					Visits[Next] = EVisit::InProgress;
+					Stack.Add(FFrame { Next, 0 });
+				}
+			}
+			else
+			{
+				Visits[Top.QuestIndex] = EVisit::Done;
+				Stack.Pop(false);
+			}
+		}
 	}
+	return NumCycles;
+}
+
+void USuqsProgression::CompileQuestDefinition(const FSuqsQuest& Quest,
+	const TArray<FSuqsObjective>& Objectives,
+	const FSuqsQuestInstance* Instance,
+	FSuqsCompiledQuest& OutQuest,
+	TArray<FSuqsCompiledTask>& OutTasks,
+	TArray<const FSuqsTask*>& OutDuplicateTasks)
+{
+	// Must be thread safe, only touches the output
+	// Anything derived purely from the definition is worked out here once, rather than in every state object
+	OutQuest.Identifier = Quest.Identifier;
+	OutQuest.FirstTask = 0;
+	OutQuest.bTitleNeedsFormatting = GetTextNeedsFormatting(Quest.Title);
+	OutQuest.bActiveDescriptionNeedsFormatting = GetTextNeedsFormatting(Quest.DescriptionWhenActive);
+	OutQuest.bCompletedDescriptionNeedsFormatting = GetTextNeedsFormatting(Quest.DescriptionWhenCompleted);
+	OutQuest.bAutoAccept = Quest.AutoAccept;
+	OutQuest.NumPrerequisites = Quest.PrerequisiteQuests.Num() + Quest.PrerequisiteQuestFailures.Num();
+	OutQuest.PrerequisiteQuests = Quest.PrerequisiteQuests;
+	OutQuest.PrerequisiteQuestFailures = Quest.PrerequisiteQuestFailures;
+	OutQuest.DefinitionHash = GetQuestDefinitionHash(Quest, Objectives, Instance);
+	OutQuest.NumObjectives = Objectives.Num();
+	OutQuest.ObjectiveIdentifiers.Reserve(Objectives.Num());
+	OutQuest.ObjectiveBranches.Reserve(Objectives.Num());
+	OutQuest.ObjectiveMandatoryTasksNeeded.Reserve(Objectives.Num());
+	int32 NumTasks = 0;
+	for (int32 ObjIndex = 0; ObjIndex < Objectives.Num(); ++ObjIndex)
+	{
+		const auto& Objective = Objectives[ObjIndex];
+		OutQuest.ObjectiveIdentifiers.Add(Objective.Identifier);
+
+		int32 BranchIndex = INDEX_NONE;
+		if (!Objective.Branch.IsNone())
+		{
+			if (const int32* pBranchIndex = OutQuest.BranchLookup.Find(Objective.Branch))
+			{
+				BranchIndex = *pBranchIndex;
+			}
+			else
+			{
+				BranchIndex = OutQuest.BranchLookup.Num();
+				OutQuest.BranchLookup.Add(Objective.Branch, BranchIndex);
+			}
+		}
+		OutQuest.ObjectiveBranches.Add(BranchIndex);
 
-	// We don't process changes caused by complete / fail until barriers resolved (see ProcessQuestStatusChange)
-	
+		int32 MandatoryTasksNeeded = Objective.NumberOfMandatoryTasksRequired == -1 ? 0 : Objective.NumberOfMandatoryTasksRequired;
+		for (int32 TaskIndex = 0; TaskIndex < Objective.Tasks.Num(); ++TaskIndex)
+		{
+			const auto& Task = Objective.Tasks[TaskIndex];
+			// Task lookup doubles as the uniqueness check; the last duplicate wins as in the quest state lookup
+			if (OutQuest.TaskLookup.Contains(Task.Identifier))
+			{
+				OutDuplicateTasks.Add(&Task);
+			}
+			OutQuest.TaskLookup.Add(Task.Identifier, NumTasks++);
+
+			auto& CT = OutTasks.AddDefaulted_GetRef();
+			CT.Identifier = Task.Identifier;
+			CT.ObjectiveIndex = ObjIndex;
+			CT.TaskIndex = TaskIndex;
+			CT.bTitleNeedsFormatting = GetTextNeedsFormatting(Task.Title);
+			CT.bHiddenOnCompleteOrFail = !Task.bAlwaysVisible && Task.bMandatory && Objective.bSequentialTasks;
+
+			if (Objective.NumberOfMandatoryTasksRequired == -1 && Task.bMandatory)
+				++MandatoryTasksNeeded;
+		}
+		OutQuest.ObjectiveMandatoryTasksNeeded.Add(MandatoryTasksNeeded);
+	}
+	OutQuest.NumTasks = NumTasks;
 }
 
-void USuqsProgression::RaiseQuestReset(USuqsQuestState* Quest)
+uint32 USuqsProgression::GetQuestDefinitionHash(const FSuqsQuest& Quest, const TArray<FSuqsObjective>& Objectives, const FSuqsQuestInstance* Instance)
 {
-	// Move quest to the correct list immediately, unlike complete / fail
-	const int NumRemoved = QuestArchive.Remove(Quest->GetIdentifier());
-	ActiveQuests.Add(Quest->GetIdentifier(), Quest);
-	
-	if (!bSuppressEvents)
+	// Must cover every field so any edit is picked up on reload
+	// Everything is hashed case-sensitively, since GetTypeHash(FName) ignores case and would miss a rename which only
+	// changes case. Text uses the source string & localisation key rather than ToString(), which depends on the culture
+	auto HashName = [](uint32 Hash, const FName& Name)
 	{
-		// Always raise as new acceptance
-		OnQuestAccepted.Broadcast(Quest);
-		OnProgressionEvent.Broadcast(FSuqsProgressionEventDetails(ESuqsProgressionEventType::QuestAccepted, Quest));
-		
-		// Only raise list change if moved from archived
-		if (NumRemoved > 0)
+		return HashCombine(Hash, FCrc::StrCrc32(*Name.ToString()));
+	};
+	auto HashText = [](uint32 Hash, const FText& Text)
+	{
+		if (const FString* Source = FTextInspector::GetSourceString(Text))
+			Hash = HashCombine(Hash, FCrc::StrCrc32(**Source));
+		if (const TOptional<FString> Namespace = FTextInspector::GetNamespace(Text))
+			Hash = HashCombine(Hash, FCrc::StrCrc32(*Namespace.GetValue()));
+		if (const TOptional<FString> Key = FTextInspector::GetKey(Text))
+			Hash = HashCombine(Hash, FCrc::StrCrc32(*Key.GetValue()));
+		return Hash;
+	};
+	auto HashNames = [&HashName](uint32 Hash, const TArray<FName>& Names)
+	{
+		Hash = HashCombine(Hash, GetTypeHash(Names.Num()));
+		for (const FName& Name : Names)
+		{
+			Hash = HashName(Hash, Name);
+		}
+		return Hash;
+	};
+
+	uint32 Hash = HashName(0, Quest.Identifier);
+	Hash = HashNames(Hash, Quest.Labels);
+	Hash = HashCombine(Hash, Quest.bPlayerVisible);
+	Hash = HashText(Hash, Quest.Title);
+	Hash = HashText(Hash, Quest.DescriptionWhenActive);
+	Hash = HashText(Hash, Quest.DescriptionWhenCompleted);
+	Hash = HashCombine(Hash, Quest.AutoAccept);
+	Hash = HashNames(Hash, Quest.PrerequisiteQuests);
+	Hash = HashNames(Hash, Quest.PrerequisiteQuestFailures);
+	Hash = HashNames(Hash, Quest.DefaultActiveBranches);
+	Hash = HashCombine(Hash, Quest.bResolveAutomatically);
+	Hash = HashCombine(Hash, GetTypeHash(Quest.ResolveDelay));
+	Hash = HashName(Hash, Quest.ResolveGate);
+
+	Hash = HashCombine(Hash, GetTypeHash(Objectives.Num()));
+	for (const auto& Objective : Objectives)
+	{
+		Hash = HashName(Hash, Objective.Identifier);
+		Hash = HashText(Hash, Objective.Title);
+		Hash = HashText(Hash, Objective.DescriptionWhenActive);
+		Hash = HashText(Hash, Objective.DescriptionWhenCompleted);
+		Hash = HashCombine(Hash, Objective.bSequentialTasks);
+		Hash = HashCombine(Hash, GetTypeHash(Objective.NumberOfMandatoryTasksRequired));
+		Hash = HashCombine(Hash, Objective.bContinueOnFail);
+		Hash = HashName(Hash, Objective.Branch);
+		Hash = HashCombine(Hash, GetTypeHash(Objective.Tasks.Num()));
+		for (const auto& Task : Objective.Tasks)
 		{
-			OnActiveQuestsListChanged.Broadcast();
-			OnProgressionEvent.Broadcast(FSuqsProgressionEventDetails(ESuqsProgressionEventType::ActiveQuestsChanged));
+			Hash = HashName(Hash, Task.Identifier);
+			Hash = HashNames(Hash, Task.Labels);
+			Hash = HashText(Hash, Task.Title);
+			Hash = HashCombine(Hash, Task.bMandatory);
+			Hash = HashCombine(Hash, GetTypeHash(Task.TargetNumber));
+			Hash = HashCombine(Hash, GetTypeHash(Task.TimeLimit));
+			Hash = HashCombine(Hash, Task.TimeLimitCompleteOnExpiry);
+			Hash = HashCombine(Hash, Task.bResolveAutomatically);
+			Hash = HashCombine(Hash, GetTypeHash(Task.ResolveDelay));
+			Hash = HashName(Hash, Task.ResolveGate);
+			Hash = HashCombine(Hash, Task.bAlwaysVisible);
 		}
 	}
-}
 
-void USuqsProgression::RaiseCurrentObjectiveChanged(USuqsQuestState* Quest)
-{
-	if (!bSuppressEvents)
+	if (Instance)
 	{
-		OnProgressionEvent.Broadcast(FSuqsProgressionEventDetails(ESuqsProgressionEventType::QuestCurrentObjectiveChanged, Quest));
-
-		// Also raise events for every task which is now relevant
-		if (const auto Obj = Quest->GetCurrentObjective())
+		// Overrides are applied to states (e.g. task target numbers) so changing them is an edit too
+		// Map order depends on how they were built, so pairs are summed to be independent of it
+		// Default active branches are already in the instance definition
+		uint32 OverridesHash = 0;
+		for (const auto& Pair : Instance->TaskTargetNumbers)
 		{
-			TArray<USuqsTaskState*> Tasks;
-			Obj->GetAllRelevantTasks(Tasks);
-			for (const auto T : Tasks)
-			{
-				RaiseTaskAdded(T);
-			}
+			OverridesHash += HashCombine(HashName(0, Pair.Key), GetTypeHash(Pair.Value));
 		}
-		
+		Hash = HashCombine(Hash, OverridesHash);
+		OverridesHash = 0;
+		for (const auto& Pair : Instance->Parameters)
+		{
+			OverridesHash += HashText(FCrc::StrCrc32(*Pair.Key), Pair.Value);
+		}
+		Hash = HashCombine(Hash, OverridesHash);
 	}
+	return Hash;
 }
 
-void USuqsProgression::ProcessQuestStatusChange(USuqsQuestState* Quest)
+bool USuqsProgression::MatchesCompiledStructure(int32 QuestIndex, const TArray<FSuqsObjective>& Objectives) const
 {
-	// Quest list and dependent quest acceptance is potentially delayed for completion / failed
-	const ESuqsQuestStatus Status = Quest->GetStatus();
-	if (Status == ESuqsQuestStatus::Completed ||
-		Status == ESuqsQuestStatus::Failed)
+	// Old definitions may be gone by now, so this only uses compiled data
+	// Case-sensitive, like the definition hash, so that a case-only rename is still a change
+	const FSuqsCompiledQuest& CQ = CompiledQuests[QuestIndex];
+	if (CQ.NumObjectives != Objectives.Num() || CQ.ObjectiveIdentifiers.Num() != Objectives.Num())
+		return false;
+
+	int32 TaskHandleIndex = CQ.FirstTask;
+	for (int32 ObjIndex = 0; ObjIndex < Objectives.Num(); ++ObjIndex)
 	{
-		// Move quest to the correct list
-		ActiveQuests.Remove(Quest->GetIdentifier());
-		QuestArchive.Add(Quest->GetIdentifier(), Quest);
-		if (!bSuppressEvents)
+		const auto& Objective = Objectives[ObjIndex];
+		if (!CQ.ObjectiveIdentifiers[ObjIndex].IsEqual(Objective.Identifier, ENameCase::CaseSensitive))
+			return false;
+
+		for (int32 TaskIndex = 0; TaskIndex < Objective.Tasks.Num(); ++TaskIndex, ++TaskHandleIndex)
 		{
-			OnProgressionEvent.Broadcast(FSuqsProgressionEventDetails(ESuqsProgressionEventType::QuestArchived, Quest));
-			// Raise this here for the purpose of archive quests
-			// Auto-accepts will raise this again
-			OnActiveQuestsListChanged.Broadcast();
-			OnProgressionEvent.Broadcast(FSuqsProgressionEventDetails(ESuqsProgressionEventType::ActiveQuestsChanged));
+			if (TaskHandleIndex >= CQ.FirstTask + CQ.NumTasks)
+				return false;
+
+			const FSuqsCompiledTask& CT = CompiledTasks[TaskHandleIndex];
+			if (CT.ObjectiveIndex != ObjIndex ||
+				CT.TaskIndex != TaskIndex ||
+				!CT.Identifier.IsEqual(Objective.Tasks[TaskIndex].Identifier, ENameCase::CaseSensitive))
+				return false;
 		}
-		
-		AutoAcceptQuests(Quest->GetIdentifier(), Status == ESuqsQuestStatus::Failed);
-		
 	}
+	return TaskHandleIndex == CQ.FirstTask + CQ.NumTasks;
+}
+
+void USuqsProgression::GetActiveTasks(const FName& TaskID, TArray<FSuqsTaskStateRef>& TasksOut) const
+{
+	// Copy, since operating on tasks can archive quests and alter the lookup
+	if (auto pTasks = ActiveTasksByID.Find(TaskID))
+		TasksOut = *pTasks;
+	else
+		TasksOut.Empty();
 }
 
-const FSuqsQuest* USuqsProgression::GetQuestDefinition(const FName& QuestID)
+const FSuqsQuest* USuqsProgression::GetQuestDefinition(const FName& QuestID) const
 {
-	return QuestDefinitions.Find(QuestID);
+	const auto pQuest = QuestDefinitions.Find(QuestID);
+	return pQuest ? *pQuest : nullptr;
 }
 
 FSuqsResolveBarrier USuqsProgression::GetResolveBarrierForTask(const FSuqsTask* Task,
@@ -1125,15 +3219,111 @@ FSuqsResolveBarrier USuqsProgression::GetResolveBarrierForQuest(const FSuqsQuest
 // FTickableGameObject start
 void USuqsProgression::Tick(float DeltaTime)
 {
-	// Copy into temporary list because ticking can fail quests and alter the collection
-	TArray<USuqsQuestState*> ListCopy;
-	ActiveQuests.GenerateValueArray(ListCopy);
-	for (auto Q : ListCopy)
+	// Only quests & tasks with a timer running are scheduled, everything else costs nothing per frame
+	// Copy into temporary lists because ticking can complete / fail items and alter the collections
+	if (TickingQuests.Num() > 0)
+	{
+		const TArray<TWeakObjectPtr<USuqsQuestState>> QuestsCopy = TickingQuests.Array();
+		for (const auto& WeakQ : QuestsCopy)
+		{
+			const auto Q = WeakQ.Get();
+			if (IsTickRequired(Q))
+				Q->Tick(DeltaTime);
+
+			// Check again after ticking, drop anything whose timer has finished until it's scheduled again
+			if (!IsTickRequired(Q))
+				TickingQuests.Remove(WeakQ);
+		}
+	}
+	if (TickingTasks.Num() > 0)
+	{
+		const TArray<FSuqsTaskStateRef> TasksCopy = TickingTasks.Array();
+		for (const auto& T : TasksCopy)
+		{
+			if (IsTickRequired(T))
+				T.Objective->TickTask(T.TaskIndex, DeltaTime);
+
+			if (!IsTickRequired(T))
+				TickingTasks.Remove(T);
+		}
+	}
+
+	// Raise deferred events once per tick, after timers have been processed
+	if (bDeferEvents && BatchDepth == 0 && QueuedEvents.Num() > 0)
+		BroadcastQueuedEvents();
+}
+
+bool USuqsProgression::IsTickable() const
+{
+	return TickingQuests.Num() > 0 || TickingTasks.Num() > 0 || (bDeferEvents && QueuedEvents.Num() > 0);
+}
+
+void USuqsProgression::ScheduleTick(USuqsQuestState* Quest)
+{
+	if (Quest && Quest->IsTickRequired())
+		TickingQuests.Add(Quest);
+}
+
+void USuqsProgression::ScheduleTick(USuqsObjectiveState* Objective, int TaskIndex)
+{
+	if (Objective && Objective->IsTaskTickRequired(TaskIndex))
+		TickingTasks.Add(FSuqsTaskStateRef(Objective, TaskIndex));
+}
+
+void USuqsProgression::WaitForGate(USuqsQuestState* Quest)
+{
+	if (Quest &&
+		Quest->IsResolveBlockedOn(ESuqsResolveBarrierCondition::Gate) &&
+		!IsGateOpen(Quest->ResolveBarrier.Gate))
+	{
+		GateWaiters.FindOrAdd(Quest->ResolveBarrier.Gate).Quests.AddUnique(Quest);
+	}
+}
+
+void USuqsProgression::WaitForGate(USuqsObjectiveState* Objective, int TaskIndex)
+{
+	if (Objective &&
+		Objective->IsTaskResolveBlockedOn(TaskIndex, ESuqsResolveBarrierCondition::Gate) &&
+		!IsGateOpen(Objective->GetTaskResolveBarrier(TaskIndex).Gate))
+	{
+		GateWaiters.FindOrAdd(Objective->GetTaskResolveBarrier(TaskIndex).Gate).Tasks.AddUnique(FSuqsTaskStateRef(Objective, TaskIndex));
+	}
+}
+
+void USuqsProgression::GetActiveQuestsUsingBranch(const FName& Branch, TArray<USuqsQuestState*>& QuestsOut) const
+{
+	QuestsOut.Reset();
+	if (const auto pQuestIndexes = QuestsByBranch.Find(Branch))
 	{
-		Q->Tick(DeltaTime);
+		for (const int32 QuestIndex : *pQuestIndexes)
+		{
+			const auto Q = QuestStatesByHandle[QuestIndex];
+			if (IsActiveQuestInstance(Q))
+				QuestsOut.Add(Q);
+		}
 	}
 }
 
+bool USuqsProgression::IsActiveQuestInstance(const USuqsQuestState* Quest) const
+{
+	// Must still be the active instance, quests can be archived, removed or reloaded
+	return IsValid(Quest) && ActiveQuests.FindRef(Quest->GetIdentifier()) == Quest;
+}
+
+bool USuqsProgression::IsTickRequired(const USuqsQuestState* Quest) const
+{
+	return IsActiveQuestInstance(Quest) && Quest->IsTickRequired();
+}
+
+bool USuqsProgression::IsTickRequired(const FSuqsTaskStateRef& Task) const
+{
+	const auto Obj = Task.GetObjective();
+	if (!Obj)
+		return false;
+
+	return IsActiveQuestInstance(Obj->GetParentQuest()) && Obj->IsTaskTickRequired(Task.TaskIndex);
+}
+
 TStatId USuqsProgression::GetStatId() const
 {
 	RETURN_QUICK_DECLARE_CYCLE_STAT(USuqsStatus, STATGROUP_Tickables);
@@ -1170,9 +3360,13 @@ void USuqsProgression::Serialize(FArchive& Ar)
 		// Give hook the opportunity to fix up data
 		OnPreLoad.ExecuteIfBound(this, Data);
 
-		LoadFromData(Data);
+		// Quest definitions are needed to restore states, so hold the load if they're not ready yet
+		CallWhenQuestDataReady([this, Data]()
+		{
+			LoadFromData(Data);
 
-		OnProgressionLoaded.Broadcast(this);
+			OnProgressionLoaded.Broadcast(this);
+		});
 		
 	}
 	else
@@ -1188,10 +3382,33 @@ void USuqsProgression::LoadFromData(const FSuqsSaveData& Data)
 	// Save / load from data is deliberately self-contained here in progression and not distributed around
 	// the quest / objective / task classes. Partly this is because we compress out Objectives in the save data
 	// and partly it's because it's just easier to follow, considering it's only a few lines of code
+	// Existing states are re-initialised for the quests being loaded rather than creating new ones, once unregistered
+	TArray<USuqsQuestState*> PrevQuests;
+	ActiveQuests.GenerateValueArray(PrevQuests);
+	for (auto& Pair : QuestArchive)
+	{
+		PrevQuests.Add(Pair.Value);
+	}
 	ActiveQuests.Empty();
 	QuestArchive.Empty();
+	ArchivedQuestRecords.Empty();
+	ActiveTasksByID.Empty();
+	QuestStatusLookup.Empty();
+	ResetUnmetPrerequisites();
+	TickingQuests.Empty();
+	TickingTasks.Empty();
+	GateWaiters.Empty();
 	GlobalActiveBranches.Empty();
 	OpenGates.Empty();
+	// Handles stay valid across loads, only the states change
+	for (auto& Q : QuestStatesByHandle)
+	{
+		Q = nullptr;
+	}
+	for (auto Q : PrevQuests)
+	{
+		PoolQuestState(Q);
+	}
 
 	bSuppressEvents = true;
 	
@@ -1199,44 +3416,9 @@ void USuqsProgression::LoadFromData(const FSuqsSaveData& Data)
 	{
 		if (auto QDef = GetQuestDefinition(FName(QData.Identifier)))
 		{
-			auto Q = NewObject<USuqsQuestState>(GetOuter());
-			// This will re-create the quest structure, including objectives and tasks, based on *current* definition
-			Q->Initialise(QDef, this);
-			Q->StartLoad();
-
-			for (FString Branch : QData.ActiveBranches)
-			{
-				Q->SetBranchActive(FName(Branch), true);
-			}
-
-			for (auto& TData : QData.TaskData)
-			{
-				// Discard task state which isn't in the quest any more
-				if (auto T = Q->GetTask(FName(TData.Identifier)))
-				{
-					T->SetNumber(TData.Number);
-					T->SetTimeRemaining(TData.TimeRemaining);
-					// It's important this is done LAST, because completion triggered from the above can generate
-					// a new barrier
-					T->SetResolveBarrier(TData.ResolveBarrier);
-				}		
-			}
-
-			// Again, set the resolve barrier last to ensure we overwrite any new generated one
-			Q->SetResolveBarrier(QData.ResolveBarrier);
-
-			Q->FinishLoad();
-
-            if (QData.Status == ESuqsQuestDataStatus::Incomplete)
-            	ActiveQuests.Add(QDef->Identifier, Q);
-			else
-			{
-				// Manually set the status, in case this isn't borne out by the current quest def
-				Q->OverrideStatus(QData.Status == ESuqsQuestDataStatus::Failed ?
-					ESuqsQuestStatus::Failed : ESuqsQuestStatus::Completed);
-
-				QuestArchive.Add(QDef->Identifier, Q);
-			}
+			// Archived quests are kept compact until something needs more than their status
+			if (!AddArchivedQuestRecord(QDef, QData))
+				LoadQuestFromData(QDef, QData);
 		}
 		else
 		{
@@ -1245,6 +3427,18 @@ void USuqsProgression::LoadFromData(const FSuqsSaveData& Data)
 		
 	}
 
+	// Compact archived quests haven't been through a status change, so accept any dependents which weren't in the
+	// save, e.g. quests added since. Done once everything is loaded so that saved dependents are found
+	TArray<TPair<FName, bool>> FinishedQuests;
+	for (const auto& Pair : ArchivedQuestRecords)
+	{
+		FinishedQuests.Emplace(Pair.Key, Pair.Value.Status == ESuqsQuestStatus::Failed);
+	}
+	for (const auto& Finished : FinishedQuests)
+	{
+		AutoAcceptQuests(Finished.Key, Finished.Value);
+	}
+
 	// Now load global branches
 	for (FString Branch : Data.GlobalActiveBranches)
 	{
@@ -1259,6 +3453,331 @@ void USuqsProgression::LoadFromData(const FSuqsSaveData& Data)
 	bSuppressEvents = false;
 }
 
+bool USuqsProgression::DiscardQuestState(int32 QuestIndex, FSuqsQuestStateData* OutData)
+{
+	USuqsQuestState* Q = QuestStatesByHandle[QuestIndex];
+	if (!Q)
+		return false;
+
+	// The quest definition may not exist any more, so identifiers come from the compiled quest
+	// Quest status is left alone, it's up to the caller to restore or remove it
+	const FSuqsCompiledQuest& CQ = CompiledQuests[QuestIndex];
+	TArray<FName> TaskIDs;
+	TaskIDs.SetNum(CQ.NumTasks);
+	for (const auto& Pair : CQ.TaskLookup)
+	{
+		TaskIDs[Pair.Value - CQ.FirstTask] = Pair.Key;
+	}
+	if (OutData)
+	{
+		SaveQuestToData(Q, CQ.Identifier, TaskIDs, *OutData);
+	}
+
+	TArray<FSuqsTaskStateRef> Tasks;
+	for (auto O : Q->Objectives)
+	{
+		for (int i = 0; i < O->GetNumTasks(); ++i)
+		{
+			Tasks.Add(FSuqsTaskStateRef(O, i));
+		}
+		DeferredObjectiveUpdates.Remove(O);
+	}
+	if (ActiveQuests.FindRef(CQ.Identifier) == Q)
+	{
+		ActiveQuests.Remove(CQ.Identifier);
+		for (int32 i = 0; i < Tasks.Num(); ++i)
+		{
+			if (auto pTasks = ActiveTasksByID.Find(TaskIDs[i]))
+			{
+				pTasks->RemoveSingle(Tasks[i]);
+				if (pTasks->Num() == 0)
+					ActiveTasksByID.Remove(TaskIDs[i]);
+			}
+		}
+	}
+	if (QuestArchive.FindRef(CQ.Identifier) == Q)
+	{
+		QuestArchive.Remove(CQ.Identifier);
+	}
+	TickingQuests.Remove(Q);
+	for (const auto& T : Tasks)
+	{
+		TickingTasks.Remove(T);
+	}
+	for (auto& Pair : GateWaiters)
+	{
+		Pair.Value.Quests.Remove(Q);
+		Pair.Value.Tasks.RemoveAll([&Tasks](const FSuqsTaskStateRef& T) { return Tasks.Contains(T); });
+	}
+	DeferredQuestUpdates.Remove(Q);
+	QuestStatesByHandle[QuestIndex] = nullptr;
+	return true;
+}
+
+USuqsQuestState* USuqsProgression::LoadQuestFromData(const FSuqsQuest* QDef, const FSuqsQuestStateData& QData)
+{
+	auto Q = NewQuestState(QDef);
+	// This will re-create the quest structure, including objectives and tasks, based on *current* definition
+	Q->Initialise(QDef, this);
+	Q->StartLoad();
+
+	for (FString Branch : QData.ActiveBranches)
+	{
+		Q->SetBranchActive(FName(Branch), true);
+	}
+
+	for (auto& TData : QData.TaskData)
+	{
+		// Discard task state which isn't in the quest any more
+		USuqsObjectiveState* Obj;
+		int TaskIndex;
+		if (Q->FindTask(FName(TData.Identifier), Obj, TaskIndex))
+		{
+			Obj->SetTaskNumber(TaskIndex, TData.Number);
+			Obj->SetTaskTimeRemaining(TaskIndex, TData.TimeRemaining);
+			// It's important this is done LAST, because completion triggered from the above can generate
+			// a new barrier
+			Obj->SetTaskResolveBarrier(TaskIndex, TData.ResolveBarrier);
+		}		
+	}
+
+	// Again, set the resolve barrier last to ensure we overwrite any new generated one
+	Q->SetResolveBarrier(QData.ResolveBarrier);
+
+	Q->FinishLoad();
+
+	if (QData.Status == ESuqsQuestDataStatus::Incomplete)
+		AddActiveQuest(Q);
+	else
+	{
+		// Manually set the status, in case this isn't borne out by the current quest def
+		Q->OverrideStatus(QData.Status == ESuqsQuestDataStatus::Failed ?
+			ESuqsQuestStatus::Failed : ESuqsQuestStatus::Completed);
+
+		QuestArchive.Add(QDef->Identifier, Q);
+	}
+	UpdateQuestLookups(Q);
+	return Q;
+}
+
+bool USuqsProgression::AddArchivedQuestRecord(const FSuqsQuest* QDef, const FSuqsQuestStateData& QData)
+{
+	// Only resolved, archived quests; anything still waiting on a barrier needs its state to resolve it
+	const FName QuestID = QDef->Identifier;
+	const int32* pIndex = QuestHandleLookup.Find(QuestID);
+	if (!pIndex ||
+		QData.Status == ESuqsQuestDataStatus::Incomplete ||
+		QData.ResolveBarrier.bPending ||
+		FindExistingQuestState(QuestID))
+		return false;
+
+	FSuqsArchivedQuestRecord Record;
+	Record.Status = QData.Status == ESuqsQuestDataStatus::Failed ? ESuqsQuestStatus::Failed : ESuqsQuestStatus::Completed;
+	Record.ResolveBarrier = QData.ResolveBarrier;
+	for (const FString& Branch : QData.ActiveBranches)
+	{
+		Record.ActiveBranches.Add(FName(Branch));
+	}
+
+	const FSuqsCompiledQuest& CQ = CompiledQuests[*pIndex];
+	for (const auto& TData : QData.TaskData)
+	{
+		// Discard task state which isn't in the quest any more, like loading does
+		const FName TaskID(TData.Identifier);
+		const int32* pTaskIndex = CQ.TaskLookup.Find(TaskID);
+		if (!pTaskIndex)
+			continue;
+
+		// Tasks in their initial state are re-created that way, no need to keep them
+		const FSuqsCompiledTask& CT = CompiledTasks[*pTaskIndex];
+		const FSuqsTask& TDef = GetQuestObjectives(*QDef)[CT.ObjectiveIndex].Tasks[CT.TaskIndex];
+		FSuqsResolveBarrier TaskBarrier;
+		TaskBarrier = TData.ResolveBarrier;
+		if (TData.Number == 0 && TData.TimeRemaining == TDef.TimeLimit && TaskBarrier == FSuqsResolveBarrier())
+			continue;
+
+		Record.Tasks.Add(FSuqsArchivedQuestRecord::FTask { TaskID, TData.Number, TData.TimeRemaining, TaskBarrier });
+	}
+	Record.ActiveBranches.Shrink();
+	Record.Tasks.Shrink();
+
+	const ESuqsQuestStatus* pOldStatus = QuestStatusLookup.Find(QuestID);
+	const ESuqsQuestStatus OldStatus = pOldStatus ? *pOldStatus : ESuqsQuestStatus::Unavailable;
+	QuestStatusLookup.Add(QuestID, Record.Status);
+	UpdateUnmetPrerequisites(QuestID, OldStatus, Record.Status);
+	ArchivedQuestRecords.Add(QuestID, MoveTemp(Record));
+	return true;
+}
+
+USuqsQuestState* USuqsProgression::HydrateArchivedQuest(const FName& QuestID)
+{
+	const FSuqsQuest* QDef = GetQuestDefinition(QuestID);
+	FSuqsArchivedQuestRecord Record;
+	if (!QDef || !ArchivedQuestRecords.RemoveAndCopyValue(QuestID, Record))
+		return nullptr;
+
+	FSuqsQuestStateData QData;
+	ArchivedQuestRecordToData(QuestID, Record, QData);
+
+	// This only restores what already happened, so no events and no knock-on effects
+	const bool bPrevSuppressed = bSuppressEvents;
+	const bool bPrevHydrating = bHydratingArchivedQuest;
+	bSuppressEvents = true;
+	bHydratingArchivedQuest = true;
+	USuqsQuestState* Q = LoadQuestFromData(QDef, QData);
+	// Loading re-evaluates the barrier for the status, but this one was resolved before it was archived
+	Q->ResolveBarrier = Record.ResolveBarrier;
+	bHydratingArchivedQuest = bPrevHydrating;
+	bSuppressEvents = bPrevSuppressed;
+
+	return Q;
+}
+
+bool USuqsProgression::IsArchivedBarrierPending(const FSuqsResolveBarrier& Barrier) const
+{
+	// Same as rebuilding the state would find, see USuqsObjectiveState::MaybeNotifyTaskStatusChange
+	if (!Barrier.bPending)
+		return false;
+	const auto IsBlockedOn = [&Barrier](ESuqsResolveBarrierCondition Condition)
+	{
+		return (Barrier.Conditions & static_cast<uint32>(Condition)) > 0;
+	};
+	if (IsBlockedOn(ESuqsResolveBarrierCondition::Explicit))
+		return !Barrier.bGrantedExplicitly;
+	return (IsBlockedOn(ESuqsResolveBarrierCondition::Time) && Barrier.TimeRemaining > 0) ||
+		(IsBlockedOn(ESuqsResolveBarrierCondition::Gate) && !OpenGates.Contains(Barrier.Gate));
+}
+
+ESuqsTaskStatus USuqsProgression::GetArchivedTaskStatus(const FName& QuestID,
+	const FSuqsArchivedQuestRecord& Record,
+	const FSuqsTask& TaskDef) const
+{
+	// Tasks which haven't moved on from their initial state aren't recorded
+	const auto RecordTask = Record.Tasks.FindByPredicate([&TaskDef](const FSuqsArchivedQuestRecord::FTask& T)
+	{
+		return T.Identifier == TaskDef.Identifier;
+	});
+	if (!RecordTask)
+		return ESuqsTaskStatus::NotStarted;
+
+	int TargetNumber = TaskDef.TargetNumber;
+	if (const auto Instance = GetQuestInstance(QuestID))
+	{
+		if (const int* pTarget = Instance->TaskTargetNumbers.Find(TaskDef.Identifier))
+			TargetNumber = FMath::Max(1, *pTarget);
+	}
+
+	// Status isn't saved, it's derived in the same order as LoadQuestFromData: number first, then time remaining
+	ESuqsTaskStatus Status = ESuqsTaskStatus::NotStarted;
+	const int Number = FMath::Clamp(RecordTask->Number, 0, TargetNumber);
+	if (Number == TargetNumber)
+		Status = ESuqsTaskStatus::Completed;
+	else if (Number > 0)
+		Status = ESuqsTaskStatus::InProgress;
+	if (TaskDef.TimeLimit > 0 && RecordTask->TimeRemaining <= 0)
+		Status = TaskDef.TimeLimitCompleteOnExpiry ? ESuqsTaskStatus::Completed : ESuqsTaskStatus::Failed;
+
+	return Status;
+}
+
+bool USuqsProgression::FindArchivedTaskStatus(const FName& QuestID, const FName& TaskID, ESuqsTaskStatus& OutStatus) const
+{
+	const auto pRecord = ArchivedQuestRecords.Find(QuestID);
+	const FSuqsQuest* QDef = pRecord ? GetQuestDefinition(QuestID) : nullptr;
+	if (!QDef)
+		return false;
+
+	for (const auto& Objective : GetQuestObjectives(*QDef))
+	{
+		for (const auto& TaskDef : Objective.Tasks)
+		{
+			if (TaskDef.Identifier == TaskID)
+			{
+				OutStatus = GetArchivedTaskStatus(QuestID, *pRecord, TaskDef);
+				return true;
+			}
+		}
+	}
+	return false;
+}
+
+bool USuqsProgression::FindArchivedObjectiveStatus(const FName& QuestID, const FName& ObjectiveID, ESuqsObjectiveStatus& OutStatus) const
+{
+	const auto pRecord = ArchivedQuestRecords.Find(QuestID);
+	const FSuqsQuest* QDef = pRecord ? GetQuestDefinition(QuestID) : nullptr;
+	const FSuqsCompiledQuest* CQ = QDef ? GetCompiledQuest(GetQuestHandle(QuestID)) : nullptr;
+	if (!CQ)
+		return false;
+
+	const auto& Objectives = GetQuestObjectives(*QDef);
+	const int32 ObjIndex = Objectives.IndexOfByPredicate([&ObjectiveID](const FSuqsObjective& O)
+	{
+		return O.Identifier == ObjectiveID;
+	});
+	if (!CQ->ObjectiveMandatoryTasksNeeded.IsValidIndex(ObjIndex))
+		return false;
+
+	// Same counting as USuqsObjectiveState::RecountTasks / UpdateStatusFromTaskCounts
+	int Complete = 0, Failed = 0, Incomplete = 0;
+	for (const auto& TaskDef : Objectives[ObjIndex].Tasks)
+	{
+		if (!TaskDef.bMandatory)
+			continue;
+
+		switch (GetArchivedTaskStatus(QuestID, *pRecord, TaskDef))
+		{
+		case ESuqsTaskStatus::Completed:
+		{
+			// Completed but not resolved doesn't count either way
+			const auto RecordTask = pRecord->Tasks.FindByPredicate([&TaskDef](const FSuqsArchivedQuestRecord::FTask& T)
+			{
+				return T.Identifier == TaskDef.Identifier;
+			});
+			if (!RecordTask || !IsArchivedBarrierPending(RecordTask->ResolveBarrier))
+				++Complete;
+			break;
+		}
+		case ESuqsTaskStatus::Failed:
+			++Failed;
+			break;
+		default:
+			++Incomplete;
+			break;
+		}
+	}
+
+	const int Needed = CQ->ObjectiveMandatoryTasksNeeded[ObjIndex];
+	if (Failed > 0 && (Incomplete + Complete) < Needed)
+		OutStatus = ESuqsObjectiveStatus::Failed;
+	else if (Complete >= Needed)
+		OutStatus = ESuqsObjectiveStatus::Completed;
+	else
+		OutStatus = Complete > 0 ? ESuqsObjectiveStatus::InProgress : ESuqsObjectiveStatus::NotStarted;
+	return true;
+}
+
+void USuqsProgression::ArchivedQuestRecordToData(const FName& QuestID,
+	const FSuqsArchivedQuestRecord& Record,
+	FSuqsQuestStateData& QData)
+{
+	QData.Identifier = QuestID.ToString();
+	QData.Status = Record.Status == ESuqsQuestStatus::Failed ?
+		ESuqsQuestDataStatus::Failed : ESuqsQuestDataStatus::Completed;
+	for (const FName& Branch : Record.ActiveBranches)
+	{
+		QData.ActiveBranches.Add(Branch.ToString());
+	}
+	QData.ResolveBarrier = Record.ResolveBarrier;
+	for (const auto& Task : Record.Tasks)
+	{
+		auto& TData = QData.TaskData.Emplace_GetRef();
+		TData.Identifier = Task.Identifier.ToString();
+		TData.Number = Task.Number;
+		TData.TimeRemaining = Task.TimeRemaining;
+		TData.ResolveBarrier = Task.ResolveBarrier;
+	}
+}
+
 void USuqsProgression::SaveToData(FSuqsSaveData& Data) const
 {
 	Data.Version = SuqsCurrentDataVersion;
@@ -1276,48 +3795,70 @@ void USuqsProgression::SaveToData(FSuqsSaveData& Data) const
 	}
 	SaveToData(ActiveQuests, Data);
 	SaveToData(QuestArchive, Data);
+	// Compact archived quests are saved as they are, there's no need to rebuild them
+	for (const auto& Pair : ArchivedQuestRecords)
+	{
+		ArchivedQuestRecordToData(Pair.Key, Pair.Value, Data.QuestData.Emplace_GetRef());
+	}
 }
 
 void USuqsProgression::SaveToData(TMap<FName, USuqsQuestState*> Quests, FSuqsSaveData& Data)
 {
+	TArray<FName> TaskIDs;
 	for (auto Pair : Quests)
 	{
 		auto Q = Pair.Value;
-		auto& QData = Data.QuestData.Emplace_GetRef();
-		
-		QData.Identifier = Q->GetIdentifier().ToString();
-		// Status is kept as a separate enum for future insulation
-		switch (Q->Status)
+		TaskIDs.Reset();
+		for (auto O : Q->Objectives)
 		{
-		case ESuqsQuestStatus::Incomplete:
-			QData.Status = ESuqsQuestDataStatus::Incomplete;
-			break;
-		case ESuqsQuestStatus::Completed:
-			QData.Status = ESuqsQuestDataStatus::Completed;
-			break;
-		case ESuqsQuestStatus::Failed:
-			QData.Status = ESuqsQuestDataStatus::Failed;
-			break;
-		default: ;
+			for (int i = 0; i < O->GetNumTasks(); ++i)
+			{
+				TaskIDs.Add(O->GetTaskDefinition(i).Identifier);
+			}
 		}
+		SaveQuestToData(Q, Q->GetIdentifier(), TaskIDs, Data.QuestData.Emplace_GetRef());
+	}
+}
 
-		for (auto Branch : Q->GetActiveBranches())
-		{
-			QData.ActiveBranches.Add(Branch.ToString());
-		}
+void USuqsProgression::SaveQuestToData(const USuqsQuestState* Q,
+	const FName& QuestID,
+	TArrayView<const FName> TaskIDs,
+	FSuqsQuestStateData& QData)
+{
+	// Identifiers are passed in rather than taken from the definitions, since those may be gone when reloading
+	QData.Identifier = QuestID.ToString();
+	// Status is kept as a separate enum for future insulation
+	switch (Q->Status)
+	{
+	case ESuqsQuestStatus::Incomplete:
+		QData.Status = ESuqsQuestDataStatus::Incomplete;
+		break;
+	case ESuqsQuestStatus::Completed:
+		QData.Status = ESuqsQuestDataStatus::Completed;
+		break;
+	case ESuqsQuestStatus::Failed:
+		QData.Status = ESuqsQuestDataStatus::Failed;
+		break;
+	default: ;
+	}
 
-		QData.ResolveBarrier = Q->ResolveBarrier;
+	for (auto Branch : Q->GetActiveBranches())
+	{
+		QData.ActiveBranches.Add(Branch.ToString());
+	}
 
-		for (auto O : Q->Objectives)
+	QData.ResolveBarrier = Q->ResolveBarrier;
+
+	int32 TaskIndex = 0;
+	for (auto O : Q->Objectives)
+	{
+		for (int i = 0; i < O->GetNumTasks(); ++i)
 		{
-			for (auto T : O->GetTasks())
-			{
-				auto& TData = QData.TaskData.Emplace_GetRef();
-				TData.Identifier = T->GetIdentifier().ToString();
-				TData.Number = T->GetNumber();
-				TData.TimeRemaining = T->GetTimeRemaining();
-				TData.ResolveBarrier = T->GetResolveBarrier();
-			}
+			auto& TData = QData.TaskData.Emplace_GetRef();
+			TData.Identifier = TaskIDs[TaskIndex++].ToString();
+			TData.Number = O->GetTaskNumber(i);
+			TData.TimeRemaining = O->GetTaskTimeRemaining(i);
+			TData.ResolveBarrier = O->GetTaskResolveBarrier(i);
 		}
 	}
 }
@@ -1327,7 +3868,7 @@ void USuqsProgression::OnWaypointMoved(USuqsWaypointComponent* Waypoint)
 	if (!bSuppressEvents)
 	{
 		const auto Task = GetTaskState(Waypoint->GetQuestID(), Waypoint->GetTaskID());
-		OnProgressionEvent.Broadcast(FSuqsProgressionEventDetails(ESuqsProgressionEventType::WaypointMoved, Waypoint, Task));
+		QueueOrBroadcastEvent(FSuqsProgressionEventDetails(ESuqsProgressionEventType::WaypointMoved, Waypoint, Task));
 	}
 	
 }
@@ -1337,7 +3878,7 @@ void USuqsProgression::OnWaypointEnabledChanged(USuqsWaypointComponent* Waypoint
 	if (!bSuppressEvents)
 	{
 		const auto Task = GetTaskState(Waypoint->GetQuestID(), Waypoint->GetTaskID());
-		OnProgressionEvent.Broadcast(FSuqsProgressionEventDetails(ESuqsProgressionEventType::WaypointEnabledOrDisabled, Waypoint, Task));
+		QueueOrBroadcastEvent(FSuqsProgressionEventDetails(ESuqsProgressionEventType::WaypointEnabledOrDisabled, Waypoint, Task));
 	}
 }
 //PRAGMA_ENABLE_OPTIMIZATION
\ No newline at end of file
@@ -0,0 +1,60 @@
+#include "SuqsQuestArena.h"
+
+FSuqsQuest* FSuqsQuestArena::Add(FSuqsQuest&& Quest)
+{
+	int32 SlotIndex;
+	if (FreeSlots.Num() > 0)
+	{
+		SlotIndex = FreeSlots.Pop(false);
+	}
+	else
+	{
+		Reserve(1);
+		SlotIndex = NumUsedSlots++;
+	}
+	FSuqsQuest* Slot = GetSlot(SlotIndex);
+	*Slot = MoveTemp(Quest);
+	SlotIndexes.Add(Slot, SlotIndex);
+	return Slot;
+}
+
+bool FSuqsQuestArena::Remove(const FSuqsQuest* Quest)
+{
+	int32 SlotIndex;
+	if (!SlotIndexes.RemoveAndCopyValue(Quest, SlotIndex))
+		return false;
+
+	// Release the memory held by the quest now, the slot itself is kept for reuse
+	*GetSlot(SlotIndex) = FSuqsQuest();
+	FreeSlots.Add(SlotIndex);
+	return true;
+}
+
+bool FSuqsQuestArena::Contains(const FSuqsQuest* Quest) const
+{
+	return SlotIndexes.Contains(Quest);
+}
+
+FSuqsQuest* FSuqsQuestArena::FindMutable(const FSuqsQuest* Quest)
+{
+	const int32* pSlotIndex = SlotIndexes.Find(Quest);
+	return pSlotIndex ? GetSlot(*pSlotIndex) : nullptr;
+}
+
+void FSuqsQuestArena::Reserve(int32 NumExtra)
+{
+	const int32 NumSlotsNeeded = NumUsedSlots + FMath::Max(0, NumExtra - FreeSlots.Num());
+	while (Chunks.Num() * ChunkSize < NumSlotsNeeded)
+	{
+		Chunks.Add(MakeUnique<FSuqsQuest[]>(ChunkSize));
+	}
+	SlotIndexes.Reserve(Num() + NumExtra);
+}
+
+void FSuqsQuestArena::Empty()
+{
+	Chunks.Empty();
+	FreeSlots.Empty();
+	SlotIndexes.Empty();
+	NumUsedSlots = 0;
+}
@@ -0,0 +1,427 @@
+#include "SuqsQuestCatalog.h"
+
+#include "Suqs.h"
+#include "SuqsQuest.h"
+#include "Serialization/MemoryReader.h"
+#include "Serialization/MemoryWriter.h"
+
+namespace SuqsCatalog
+{
+	// "SUQC"
+	constexpr uint32 Magic = 0x43515553;
+	constexpr int32 CurrentVersion = 1;
+
+	/// A range of entries in another array
+	struct FRange
+	{
+		int32 Start;
+		int32 Num;
+	};
+
+	enum EQuestFlags : uint32
+	{
+		Quest_PlayerVisible = 1 << 0,
+		Quest_AutoAccept = 1 << 1,
+		Quest_ResolveAutomatically = 1 << 2
+	};
+
+	enum EObjectiveFlags : uint32
+	{
+		Objective_SequentialTasks = 1 << 0,
+		Objective_ContinueOnFail = 1 << 1
+	};
+
+	enum ETaskFlags : uint32
+	{
+		Task_Mandatory = 1 << 0,
+		Task_TimeLimitCompleteOnExpiry = 1 << 1,
+		Task_ResolveAutomatically = 1 << 2,
+		Task_AlwaysVisible = 1 << 3
+	};
+
+	// All records are made of 4-byte fields so they have no padding and can be read in bulk
+	// Name & text fields are indexes into the name / text tables, INDEX_NONE for None / empty
+	// Name list ranges are into the name reference list
+
+	struct FHeader
+	{
+		uint32 Magic;
+		int32 Version;
+		int32 NumNames;
+		int32 NumTexts;
+		int32 NumNameRefs;
+		int32 NumQuests;
+		int32 NumObjectives;
+		int32 NumTasks;
+	};
+	static_assert(sizeof(FHeader) == 32, "Catalog header must not have padding");
+
+	struct FQuestRecord
+	{
+		int32 Identifier;
+		FRange Labels;
+		uint32 Flags;
+		int32 Title;
+		int32 DescriptionWhenActive;
+		int32 DescriptionWhenCompleted;
+		FRange PrerequisiteQuests;
+		FRange PrerequisiteQuestFailures;
+		FRange DefaultActiveBranches;
+		float ResolveDelay;
+		int32 ResolveGate;
+		FRange Objectives;
+	};
+	static_assert(sizeof(FQuestRecord) == 68, "Catalog quest record must not have padding");
+
+	struct FObjectiveRecord
+	{
+		int32 Identifier;
+		int32 Title;
+		int32 DescriptionWhenActive;
+		int32 DescriptionWhenCompleted;
+		uint32 Flags;
+		int32 NumberOfMandatoryTasksRequired;
+		int32 Branch;
+		FRange Tasks;
+	};
+	static_assert(sizeof(FObjectiveRecord) == 36, "Catalog objective record must not have padding");
+
+	struct FTaskRecord
+	{
+		int32 Identifier;
+		FRange Labels;
+		int32 Title;
+		uint32 Flags;
+		int32 TargetNumber;
+		float TimeLimit;
+		float ResolveDelay;
+		int32 ResolveGate;
+	};
+	static_assert(sizeof(FTaskRecord) == 36, "Catalog task record must not have padding");
+
+	class FBuilder
+	{
+	public:
+		TArray<FString> Names;
+		TMap<FName, int32> NameIndices;
+		TArray<FText> Texts;
+		TArray<int32> NameRefs;
+		TArray<FQuestRecord> Quests;
+		TArray<FObjectiveRecord> Objectives;
+		TArray<FTaskRecord> Tasks;
+
+		int32 AddName(const FName& Name)
+		{
+			if (Name.IsNone())
+				return INDEX_NONE;
+
+			if (const int32* pIndex = NameIndices.Find(Name))
+				return *pIndex;
+
+			const int32 Index = Names.Add(Name.ToString());
+			NameIndices.Add(Name, Index);
+			return Index;
+		}
+
+		int32 AddText(const FText& Text)
+		{
+			if (Text.IsEmpty())
+				return INDEX_NONE;
+
+			return Texts.Add(Text);
+		}
+
+		FRange AddNames(const TArray<FName>& InNames)
+		{
+			const FRange Range { NameRefs.Num(), InNames.Num() };
+			for (const auto& Name : InNames)
+			{
+				NameRefs.Add(AddName(Name));
+			}
+			return Range;
+		}
+
+		void AddQuest(const FSuqsQuest& Quest)
+		{
+			FQuestRecord Q;
+			Q.Identifier = AddName(Quest.Identifier);
+			Q.Labels = AddNames(Quest.Labels);
+			Q.Flags = (Quest.bPlayerVisible ? Quest_PlayerVisible : 0) |
+				(Quest.AutoAccept ? Quest_AutoAccept : 0) |
+				(Quest.bResolveAutomatically ? Quest_ResolveAutomatically : 0);
+			Q.Title = AddText(Quest.Title);
+			Q.DescriptionWhenActive = AddText(Quest.DescriptionWhenActive);
+			Q.DescriptionWhenCompleted = AddText(Quest.DescriptionWhenCompleted);
+			Q.PrerequisiteQuests = AddNames(Quest.PrerequisiteQuests);
+			Q.PrerequisiteQuestFailures = AddNames(Quest.PrerequisiteQuestFailures);
+			Q.DefaultActiveBranches = AddNames(Quest.DefaultActiveBranches);
+			Q.ResolveDelay = Quest.ResolveDelay;
+			Q.ResolveGate = AddName(Quest.ResolveGate);
+			const auto& QuestObjectives = Quest.Objectives;
+			Q.Objectives = FRange { Objectives.Num(), QuestObjectives.Num() };
+			Quests.Add(Q);
+
+			// Objectives are contiguous per quest, tasks are added after all the objectives so they're contiguous too
+			for (const auto& Objective : QuestObjectives)
+			{
+				FObjectiveRecord O;
+				O.Identifier = AddName(Objective.Identifier);
+				O.Title = AddText(Objective.Title);
+				O.DescriptionWhenActive = AddText(Objective.DescriptionWhenActive);
+				O.DescriptionWhenCompleted = AddText(Objective.DescriptionWhenCompleted);
+				O.Flags = (Objective.bSequentialTasks ? Objective_SequentialTasks : 0) |
+					(Objective.bContinueOnFail ? Objective_ContinueOnFail : 0);
+				O.NumberOfMandatoryTasksRequired = Objective.NumberOfMandatoryTasksRequired;
+				O.Branch = AddName(Objective.Branch);
+				O.Tasks = FRange { INDEX_NONE, Objective.Tasks.Num() };
+				Objectives.Add(O);
+			}
+			for (int i = 0; i < QuestObjectives.Num(); ++i)
+			{
+				Objectives[Q.Objectives.Start + i].Tasks.Start = Tasks.Num();
+				for (const auto& Task : QuestObjectives[i].Tasks)
+				{
+					FTaskRecord T;
+					T.Identifier = AddName(Task.Identifier);
+					T.Labels = AddNames(Task.Labels);
+					T.Title = AddText(Task.Title);
+					T.Flags = (Task.bMandatory ? Task_Mandatory : 0) |
+						(Task.TimeLimitCompleteOnExpiry ? Task_TimeLimitCompleteOnExpiry : 0) |
+						(Task.bResolveAutomatically ? Task_ResolveAutomatically : 0) |
+						(Task.bAlwaysVisible ? Task_AlwaysVisible : 0);
+					T.TargetNumber = Task.TargetNumber;
+					T.TimeLimit = Task.TimeLimit;
+					T.ResolveDelay = Task.ResolveDelay;
+					T.ResolveGate = AddName(Task.ResolveGate);
+					Tasks.Add(T);
+				}
+			}
+		}
+	};
+
+	template<typename T>
+	void SerializeRecords(FArchive& Ar, TArray<T>& Records)
+	{
+		Ar.Serialize(Records.GetData(), Records.Num() * sizeof(T));
+	}
+
+	/// Whether there's enough data left for Num items of at least MinSize bytes, so that corrupt counts are rejected
+	/// before anything is allocated for them
+	bool HasRemaining(FArchive& Ar, int32 Num, int64 MinSize)
+	{
+		return Num >= 0 && Ar.TotalSize() - Ar.Tell() >= static_cast<int64>(Num) * MinSize;
+	}
+
+	template<typename T>
+	bool ReadRecords(FArchive& Ar, int32 Num, TArray<T>& Records)
+	{
+		if (!HasRemaining(Ar, Num, sizeof(T)))
+			return false;
+
+		Records.SetNumUninitialized(Num);
+		SerializeRecords(Ar, Records);
+		return !Ar.IsError();
+	}
+
+	bool IsValidRange(const FRange& Range, int32 Num)
+	{
+		// Written so that it can't overflow
+		return Range.Start >= 0 && Range.Num >= 0 && Range.Start <= Num && Range.Num <= Num - Range.Start;
+	}
+}
+
+void FSuqsQuestCatalog::Write(const TArray<const FSuqsQuest*>& Quests, TArray<uint8>& OutData)
+{
+	using namespace SuqsCatalog;
+
+	FBuilder Builder;
+	for (const auto Quest : Quests)
+	{
+		Builder.AddQuest(*Quest);
+	}
+
+	FHeader Header;
+	Header.Magic = Magic;
+	Header.Version = CurrentVersion;
+	Header.NumNames = Builder.Names.Num();
+	Header.NumTexts = Builder.Texts.Num();
+	Header.NumNameRefs = Builder.NameRefs.Num();
+	Header.NumQuests = Builder.Quests.Num();
+	Header.NumObjectives = Builder.Objectives.Num();
+	Header.NumTasks = Builder.Tasks.Num();
+
+	OutData.Reset();
+	// Persistent so that texts keep their localisation keys
+	FMemoryWriter Ar(OutData, true);
+	Ar.Serialize(&Header, sizeof(Header));
+	for (auto& Name : Builder.Names)
+	{
+		Ar << Name;
+	}
+	for (auto& Text : Builder.Texts)
+	{
+		Ar << Text;
+	}
+	SerializeRecords(Ar, Builder.NameRefs);
+	SerializeRecords(Ar, Builder.Quests);
+	SerializeRecords(Ar, Builder.Objectives);
+	SerializeRecords(Ar, Builder.Tasks);
+}
+
+bool FSuqsQuestCatalog::Read(const TArray<uint8>& Data, TArray<FSuqsQuest>& OutQuests)
+{
+	using namespace SuqsCatalog;
+
+	OutQuests.Reset();
+
+	FMemoryReader Ar(Data, true);
+	FHeader Header;
+	if (Data.Num() < static_cast<int32>(sizeof(Header)))
+	{
+		UE_LOG(LogSUQS, Error, TEXT("Quest catalog is too small to be valid"));
+		return false;
+	}
+	Ar.Serialize(&Header, sizeof(Header));
+	if (Header.Magic != Magic)
+	{
+		UE_LOG(LogSUQS, Error, TEXT("Quest catalog data is not a quest catalog"));
+		return false;
+	}
+	if (Header.Version != CurrentVersion)
+	{
+		UE_LOG(LogSUQS, Error, TEXT("Quest catalog version %d is not supported (expected %d), please rebuild it"),
+			Header.Version, CurrentVersion);
+		return false;
+	}
+	// Names & texts are at least a length each
+	if (!HasRemaining(Ar, Header.NumNames, sizeof(int32)))
+	{
+		UE_LOG(LogSUQS, Error, TEXT("Quest catalog header is corrupt"));
+		return false;
+	}
+
+	TArray<FName> Names;
+	Names.Reserve(Header.NumNames);
+	for (int i = 0; i < Header.NumNames && !Ar.IsError(); ++i)
+	{
+		FString Name;
+		Ar << Name;
+		Names.Add(FName(*Name));
+	}
+	if (Ar.IsError() || !HasRemaining(Ar, Header.NumTexts, sizeof(int32)))
+	{
+		UE_LOG(LogSUQS, Error, TEXT("Quest catalog is truncated or corrupt"));
+		return false;
+	}
+	TArray<FText> Texts;
+	Texts.SetNum(Header.NumTexts);
+	for (int i = 0; i < Header.NumTexts && !Ar.IsError(); ++i)
+	{
+		Ar << Texts[i];
+	}
+
+	TArray<int32> NameRefs;
+	TArray<FQuestRecord> QuestRecords;
+	TArray<FObjectiveRecord> ObjectiveRecords;
+	TArray<FTaskRecord> TaskRecords;
+	if (Ar.IsError() ||
+		!ReadRecords(Ar, Header.NumNameRefs, NameRefs) ||
+		!ReadRecords(Ar, Header.NumQuests, QuestRecords) ||
+		!ReadRecords(Ar, Header.NumObjectives, ObjectiveRecords) ||
+		!ReadRecords(Ar, Header.NumTasks, TaskRecords))
+	{
+		UE_LOG(LogSUQS, Error, TEXT("Quest catalog is truncated or corrupt"));
+		return false;
+	}
+
+	auto GetName = [&Names](int32 Index)
+	{
+		return Names.IsValidIndex(Index) ? Names[Index] : NAME_None;
+	};
+	auto GetText = [&Texts](int32 Index)
+	{
+		return Texts.IsValidIndex(Index) ? Texts[Index] : FText::GetEmpty();
+	};
+	auto GetNames = [&](const FRange& Range, TArray<FName>& OutNames)
+	{
+		if (!IsValidRange(Range, NameRefs.Num()))
+			return false;
+
+		OutNames.Reserve(Range.Num);
+		for (int i = 0; i < Range.Num; ++i)
+		{
+			OutNames.Add(GetName(NameRefs[Range.Start + i]));
+		}
+		return true;
+	};
+
+	OutQuests.SetNum(QuestRecords.Num());
+	for (int QuestIndex = 0; QuestIndex < QuestRecords.Num(); ++QuestIndex)
+	{
+		const auto& QR = QuestRecords[QuestIndex];
+		auto& Quest = OutQuests[QuestIndex];
+		Quest.Identifier = GetName(QR.Identifier);
+		Quest.bPlayerVisible = (QR.Flags & Quest_PlayerVisible) != 0;
+		Quest.AutoAccept = (QR.Flags & Quest_AutoAccept) != 0;
+		Quest.bResolveAutomatically = (QR.Flags & Quest_ResolveAutomatically) != 0;
+		Quest.Title = GetText(QR.Title);
+		Quest.DescriptionWhenActive = GetText(QR.DescriptionWhenActive);
+		Quest.DescriptionWhenCompleted = GetText(QR.DescriptionWhenCompleted);
+		Quest.ResolveDelay = QR.ResolveDelay;
+		Quest.ResolveGate = GetName(QR.ResolveGate);
+		bool bValid = GetNames(QR.Labels, Quest.Labels) &&
+			GetNames(QR.PrerequisiteQuests, Quest.PrerequisiteQuests) &&
+			GetNames(QR.PrerequisiteQuestFailures, Quest.PrerequisiteQuestFailures) &&
+			GetNames(QR.DefaultActiveBranches, Quest.DefaultActiveBranches) &&
+			IsValidRange(QR.Objectives, ObjectiveRecords.Num());
+
+		if (bValid)
+		{
+			Quest.Objectives.SetNum(QR.Objectives.Num);
+			for (int ObjIndex = 0; ObjIndex < QR.Objectives.Num && bValid; ++ObjIndex)
+			{
+				const auto& OR = ObjectiveRecords[QR.Objectives.Start + ObjIndex];
+				auto& Objective = Quest.Objectives[ObjIndex];
+				Objective.Identifier = GetName(OR.Identifier);
+				Objective.Title = GetText(OR.Title);
+				Objective.DescriptionWhenActive = GetText(OR.DescriptionWhenActive);
+				Objective.DescriptionWhenCompleted = GetText(OR.DescriptionWhenCompleted);
+				Objective.bSequentialTasks = (OR.Flags & Objective_SequentialTasks) != 0;
+				Objective.bContinueOnFail = (OR.Flags & Objective_ContinueOnFail) != 0;
+				Objective.NumberOfMandatoryTasksRequired = OR.NumberOfMandatoryTasksRequired;
+				Objective.Branch = GetName(OR.Branch);
+
+				bValid = IsValidRange(OR.Tasks, TaskRecords.Num());
+				if (bValid)
+				{
+					Objective.Tasks.SetNum(OR.Tasks.Num);
+					for (int TaskIndex = 0; TaskIndex < OR.Tasks.Num && bValid; ++TaskIndex)
+					{
+						const auto& TR = TaskRecords[OR.Tasks.Start + TaskIndex];
+						auto& Task = Objective.Tasks[TaskIndex];
+						Task.Identifier = GetName(TR.Identifier);
+						Task.Title = GetText(TR.Title);
+						Task.bMandatory = (TR.Flags & Task_Mandatory) != 0;
+						Task.TimeLimitCompleteOnExpiry = (TR.Flags & Task_TimeLimitCompleteOnExpiry) != 0;
+						Task.bResolveAutomatically = (TR.Flags & Task_ResolveAutomatically) != 0;
+						Task.bAlwaysVisible = (TR.Flags & Task_AlwaysVisible) != 0;
+						Task.TargetNumber = TR.TargetNumber;
+						Task.TimeLimit = TR.TimeLimit;
+						Task.ResolveDelay = TR.ResolveDelay;
+						Task.ResolveGate = GetName(TR.ResolveGate);
+						bValid = GetNames(TR.Labels, Task.Labels);
+					}
+				}
+			}
+		}
+
+		if (!bValid)
+		{
+			UE_LOG(LogSUQS, Error, TEXT("Quest catalog entry for quest %s is corrupt"), *Quest.Identifier.ToString());
+			OutQuests.Reset();
+			return false;
+		}
+	}
+
+	return true;
+}
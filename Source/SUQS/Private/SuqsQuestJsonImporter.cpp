@@ -0,0 +1,260 @@
+#include "SuqsQuestJsonImporter.h"
+
+#include "SuqsQuest.h"
+#include "Serialization/JsonReader.h"
+
+namespace SuqsJson
+{
+	class FParser
+	{
+	public:
+		explicit FParser(const FString& JsonString)
+			: Reader(TJsonReaderFactory<TCHAR>::Create(JsonString))
+		{
+		}
+
+		FString Error;
+
+		bool ReadQuests(TArray<FSuqsQuest>& OutQuests)
+		{
+			if (!Next())
+				return false;
+			if (Notation != EJsonNotation::ArrayStart)
+				return Fail(TEXT("Expected an array of quests"));
+
+			while (Next())
+			{
+				if (Notation == EJsonNotation::ArrayEnd)
+					return true;
+				if (!ReadQuest(OutQuests.AddDefaulted_GetRef()))
+					return false;
+			}
+			return false;
+		}
+
+	protected:
+		TSharedRef<TJsonReader<TCHAR>> Reader;
+		EJsonNotation Notation = EJsonNotation::Null;
+
+		bool Next()
+		{
+			if (!Reader->ReadNext(Notation) || Notation == EJsonNotation::Error)
+			{
+				if (Error.IsEmpty())
+				{
+					// Reader errors already include the line & column
+					if (Reader->GetErrorMessage().IsEmpty())
+						Fail(TEXT("Unexpected end of JSON"));
+					else
+						Error = Reader->GetErrorMessage();
+				}
+				return false;
+			}
+			return true;
+		}
+
+		bool Fail(const FString& Message)
+		{
+			Error = FString::Printf(TEXT("%s at line %d, column %d"), *Message, Reader->GetLineNumber(), Reader->GetCharacterNumber());
+			return false;
+		}
+
+		bool Expect(EJsonNotation Expected, const FString& Field)
+		{
+			if (Notation != Expected)
+				return Fail(FString::Printf(TEXT("Unexpected value type for '%s'"), *Field));
+			return true;
+		}
+
+		/// Skip the current value, including nested objects & arrays
+		bool Skip()
+		{
+			int Depth = 0;
+			do
+			{
+				if (Notation == EJsonNotation::ObjectStart || Notation == EJsonNotation::ArrayStart)
+					++Depth;
+				else if (Notation == EJsonNotation::ObjectEnd || Notation == EJsonNotation::ArrayEnd)
+					--Depth;
+			}
+			while (Depth > 0 && Next());
+			return Depth == 0;
+		}
+
+		bool Read(const FString& Field, FName& Out)
+		{
+			if (!Expect(EJsonNotation::String, Field))
+				return false;
+			Out = FName(*Reader->GetValueAsString());
+			return true;
+		}
+
+		bool Read(const FString& Field, FText& Out)
+		{
+			if (!Expect(EJsonNotation::String, Field))
+				return false;
+			// Same text formats as DataTable import, e.g. NSLOCTEXT(...), or literal strings
+			const FString& Str = Reader->GetValueAsString();
+			if (Str.IsEmpty())
+				Out = FText::GetEmpty();
+			else if (!FTextStringHelper::ReadFromBuffer(*Str, Out))
+				Out = FText::FromString(Str);
+			return true;
+		}
+
+		bool Read(const FString& Field, bool& Out)
+		{
+			if (!Expect(EJsonNotation::Boolean, Field))
+				return false;
+			Out = Reader->GetValueAsBoolean();
+			return true;
+		}
+
+		bool Read(const FString& Field, int& Out)
+		{
+			if (!Expect(EJsonNotation::Number, Field))
+				return false;
+			Out = FMath::RoundToInt(Reader->GetValueAsNumber());
+			return true;
+		}
+
+		bool Read(const FString& Field, float& Out)
+		{
+			if (!Expect(EJsonNotation::Number, Field))
+				return false;
+			Out = static_cast<float>(Reader->GetValueAsNumber());
+			return true;
+		}
+
+		bool Read(const FString& Field, TArray<FName>& Out)
+		{
+			if (!Expect(EJsonNotation::ArrayStart, Field))
+				return false;
+			while (Next())
+			{
+				if (Notation == EJsonNotation::ArrayEnd)
+					return true;
+				if (!Read(Field, Out.AddDefaulted_GetRef()))
+					return false;
+			}
+			return false;
+		}
+
+		/// Read the fields of an object, calling ReadField for each with the field name; value is the current token
+		template<typename F>
+		bool ReadObject(const TCHAR* What, F ReadField)
+		{
+			if (Notation != EJsonNotation::ObjectStart)
+				return Fail(FString::Printf(TEXT("Expected %s object"), What));
+			while (Next())
+			{
+				if (Notation == EJsonNotation::ObjectEnd)
+					return true;
+				const FString Field = Reader->GetIdentifier();
+				bool bHandled = true;
+				if (!ReadField(Field, bHandled))
+					return false;
+				// Unknown properties are ignored
+				if (!bHandled && !Skip())
+					return false;
+			}
+			return false;
+		}
+
+		template<typename T, typename F>
+		bool ReadArray(const FString& Field, TArray<T>& Out, F ReadItem)
+		{
+			if (!Expect(EJsonNotation::ArrayStart, Field))
+				return false;
+			while (Next())
+			{
+				if (Notation == EJsonNotation::ArrayEnd)
+					return true;
+				if (!(this->*ReadItem)(Out.AddDefaulted_GetRef()))
+					return false;
+			}
+			return false;
+		}
+
+		bool ReadTask(FSuqsTask& Task)
+		{
+			const bool bOK = ReadObject(TEXT("task"), [this, &Task](const FString& Field, bool& bHandled)
+			{
+				if (Field == TEXT("Identifier")) return Read(Field, Task.Identifier);
+				if (Field == TEXT("Labels")) return Read(Field, Task.Labels);
+				if (Field == TEXT("Title")) return Read(Field, Task.Title);
+				if (Field == TEXT("bMandatory")) return Read(Field, Task.bMandatory);
+				if (Field == TEXT("TargetNumber")) return Read(Field, Task.TargetNumber);
+				if (Field == TEXT("TimeLimit")) return Read(Field, Task.TimeLimit);
+				if (Field == TEXT("TimeLimitCompleteOnExpiry")) return Read(Field, Task.TimeLimitCompleteOnExpiry);
+				if (Field == TEXT("bResolveAutomatically")) return Read(Field, Task.bResolveAutomatically);
+				if (Field == TEXT("ResolveDelay")) return Read(Field, Task.ResolveDelay);
+				if (Field == TEXT("ResolveGate")) return Read(Field, Task.ResolveGate);
+				if (Field == TEXT("bAlwaysVisible")) return Read(Field, Task.bAlwaysVisible);
+				bHandled = false;
+				return true;
+			});
+			if (bOK && Task.Identifier.IsNone())
+				return Fail(TEXT("Task is missing an Identifier"));
+			return bOK;
+		}
+
+		bool ReadObjective(FSuqsObjective& Objective)
+		{
+			return ReadObject(TEXT("objective"), [this, &Objective](const FString& Field, bool& bHandled)
+			{
+				if (Field == TEXT("Identifier")) return Read(Field, Objective.Identifier);
+				if (Field == TEXT("Title")) return Read(Field, Objective.Title);
+				if (Field == TEXT("DescriptionWhenActive")) return Read(Field, Objective.DescriptionWhenActive);
+				if (Field == TEXT("DescriptionWhenCompleted")) return Read(Field, Objective.DescriptionWhenCompleted);
+				if (Field == TEXT("bSequentialTasks")) return Read(Field, Objective.bSequentialTasks);
+				if (Field == TEXT("NumberOfMandatoryTasksRequired")) return Read(Field, Objective.NumberOfMandatoryTasksRequired);
+				if (Field == TEXT("bContinueOnFail")) return Read(Field, Objective.bContinueOnFail);
+				if (Field == TEXT("Branch")) return Read(Field, Objective.Branch);
+				if (Field == TEXT("Tasks")) return ReadArray(Field, Objective.Tasks, &FParser::ReadTask);
+				bHandled = false;
+				return true;
+			});
+		}
+
+		bool ReadQuest(FSuqsQuest& Quest)
+		{
+			const bool bOK = ReadObject(TEXT("quest"), [this, &Quest](const FString& Field, bool& bHandled)
+			{
+				if (Field == TEXT("Identifier")) return Read(Field, Quest.Identifier);
+				if (Field == TEXT("Labels")) return Read(Field, Quest.Labels);
+				if (Field == TEXT("bPlayerVisible")) return Read(Field, Quest.bPlayerVisible);
+				if (Field == TEXT("Title")) return Read(Field, Quest.Title);
+				if (Field == TEXT("DescriptionWhenActive")) return Read(Field, Quest.DescriptionWhenActive);
+				if (Field == TEXT("DescriptionWhenCompleted")) return Read(Field, Quest.DescriptionWhenCompleted);
+				if (Field == TEXT("AutoAccept")) return Read(Field, Quest.AutoAccept);
+				if (Field == TEXT("PrerequisiteQuests")) return Read(Field, Quest.PrerequisiteQuests);
+				if (Field == TEXT("PrerequisiteQuestFailures")) return Read(Field, Quest.PrerequisiteQuestFailures);
+				if (Field == TEXT("DefaultActiveBranches")) return Read(Field, Quest.DefaultActiveBranches);
+				if (Field == TEXT("bResolveAutomatically")) return Read(Field, Quest.bResolveAutomatically);
+				if (Field == TEXT("ResolveDelay")) return Read(Field, Quest.ResolveDelay);
+				if (Field == TEXT("ResolveGate")) return Read(Field, Quest.ResolveGate);
+				if (Field == TEXT("Objectives")) return ReadArray(Field, Quest.Objectives, &FParser::ReadObjective);
+				bHandled = false;
+				return true;
+			});
+			if (bOK && Quest.Identifier.IsNone())
+				return Fail(TEXT("Quest is missing an Identifier"));
+			return bOK;
+		}
+	};
+}
+
+bool FSuqsQuestJsonImporter::Import(const FString& JsonString, TArray<FSuqsQuest>& OutQuests, FString& OutError)
+{
+	OutQuests.Reset();
+
+	SuqsJson::FParser Parser(JsonString);
+	if (!Parser.ReadQuests(OutQuests))
+	{
+		OutError = Parser.Error;
+		OutQuests.Reset();
+		return false;
+	}
+	return true;
+}
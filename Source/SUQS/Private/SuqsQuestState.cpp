@@ -16,57 +16,146 @@ void USuqsQuestState::Initialise(const FSuqsQuest* Def, USuqsProgression* Root)
 	// Quest definitions are static data so it's OK to keep this (it's owned by parent)
 	QuestDefinition = Def;
 	Progression = Root;
+	Handle = Root->GetQuestHandle(Def->Identifier);
 	Status = ESuqsQuestStatus::Incomplete;
 	ResolveBarrier = Progression->GetResolveBarrierForQuest(QuestDefinition, Status);
-	FastTaskLookup.Empty();
+	// This state may be re-used from the progression's pool, so nothing can be assumed to be at its default
+	CurrentObjectiveIndex = -1;
+	bSuppressObjectiveChangeEvent = false;
+	bPreviousObjectivesFailQuest = false;
+	bIsLoading = false;
 	ActiveBranches.Empty();
+	UpdateActiveBranchBits();
 
-	bTitleNeedsFormatting = USuqsProgression::GetTextNeedsFormatting(QuestDefinition->Title);
-	bActiveDescriptionNeedsFormatting = USuqsProgression::GetTextNeedsFormatting(QuestDefinition->DescriptionWhenActive);
-	bCompletedDescriptionNeedsFormatting = USuqsProgression::GetTextNeedsFormatting(QuestDefinition->DescriptionWhenCompleted);
-
-	for (const auto& ObjDef : Def->Objectives)
+	// Anything derived purely from the definition was worked out when it was compiled, so no text parsing here
+	const auto CQ = GetCompiledDefinition();
+	if (CQ)
 	{
-		auto Obj = NewObject<USuqsObjectiveState>(GetOuter());
-		Obj->Initialise(&ObjDef, this, Root);
-		Objectives.Add(Obj);
-
-		for (auto Task : Obj->Tasks)
+		bTitleNeedsFormatting = CQ->bTitleNeedsFormatting;
+		bActiveDescriptionNeedsFormatting = CQ->bActiveDescriptionNeedsFormatting;
+		bCompletedDescriptionNeedsFormatting = CQ->bCompletedDescriptionNeedsFormatting;
+	}
+	else
+	{
+		bTitleNeedsFormatting = USuqsProgression::GetTextNeedsFormatting(QuestDefinition->Title);
+		bActiveDescriptionNeedsFormatting = USuqsProgression::GetTextNeedsFormatting(QuestDefinition->DescriptionWhenActive);
+		bCompletedDescriptionNeedsFormatting = USuqsProgression::GetTextNeedsFormatting(QuestDefinition->DescriptionWhenCompleted);
+	}
+
+	FirstCompiledTask = CQ ? CQ->FirstTask : -1;
+	FirstCompiledTaskGeneration = CQ ? Root->GetTaskHandleByIndex(CQ->FirstTask).Generation : 0;
+	int32 NextCompiledTask = FirstCompiledTask;
+	// Objective states from a previous initialisation with the same definition are re-used, but the list is still
+	// built up in order as if they were new
+	// Instances share their template's objectives
+	const auto& ObjDefs = Root->GetQuestObjectives(*Def);
+	TArray<USuqsObjectiveState*> PrevObjectives = MoveTemp(Objectives);
+	Objectives.Reset();
+	if (PrevObjectives.Num() != ObjDefs.Num())
+		PrevObjectives.Reset();
+	for (const auto& ObjDef : ObjDefs)
+	{
+		auto Obj = PrevObjectives.Num() > 0 ? PrevObjectives[Objectives.Num()] : NewObject<USuqsObjectiveState>(GetOuter());
+		Obj->ObjectiveIndex = Objectives.Num();
+		if (CQ)
+		{
+			Obj->BranchIndex = CQ->ObjectiveBranches[Obj->ObjectiveIndex];
+			Obj->FirstCompiledTask = NextCompiledTask;
+			NextCompiledTask += ObjDef.Tasks.Num();
+		}
+		else
 		{
-			FastTaskLookup.Add(Task->GetIdentifier(), Task);
+			Obj->BranchIndex = INDEX_NONE;
+			Obj->FirstCompiledTask = -1;
 		}
+		Obj->Initialise(&ObjDef, this, Root);
+		Objectives.Add(Obj);
 	}
 	ResetBranches();
 	
 	NotifyObjectiveStatusChanged();
 }
 
+void USuqsQuestState::RebindDefinition(const FSuqsQuest* Def)
+{
+	// Structure must be identical, so only the definition pointers change
+	QuestDefinition = Def;
+	const auto& ObjDefs = Progression->GetQuestObjectives(*Def);
+	for (int i = 0; i < Objectives.Num(); ++i)
+	{
+		Objectives[i]->RebindDefinition(&ObjDefs[i]);
+	}
+}
+
 void USuqsQuestState::Tick(float DeltaTime)
 {
-	// We tick our own conditions FIRST, otherwise ticking children could change our status and tick us simultaneously
+	// Tasks are scheduled for ticking separately by progression, only if they have a timer running
 	if (IsResolveBlockedOn(ESuqsResolveBarrierCondition::Time))
 	{
 		ResolveBarrier.TimeRemaining = FMath::Max(ResolveBarrier.TimeRemaining - DeltaTime, 0.f);
 	}
-	
-	// only tick the current objective
-	auto Obj = GetCurrentObjective();
-	if (Obj)
-	{
-		Obj->Tick(DeltaTime);
-	}
 
 	MaybeNotifyStatusChange();
 	
 }
 
+bool USuqsQuestState::IsTickRequired() const
+{
+	// Barriers are only relevant once completed / failed; the time is reset when the status changes
+	return (Status == ESuqsQuestStatus::Completed || Status == ESuqsQuestStatus::Failed) &&
+		IsResolveBlockedOn(ESuqsResolveBarrierCondition::Time) &&
+		ResolveBarrier.TimeRemaining > 0;
+}
+
+void USuqsQuestState::ScheduleCurrentObjectiveTick()
+{
+	if (auto Obj = GetCurrentObjective())
+	{
+		for (int i = 0; i < Obj->GetNumTasks(); ++i)
+		{
+			Progression->ScheduleTick(Obj, i);
+		}
+	}
+}
+
 
 USuqsTaskState* USuqsQuestState::GetTask(const FName& Identifier) const
 {
-	const auto ppT = FastTaskLookup.Find(Identifier);
-	if (ppT)
-		return *ppT;
-	return nullptr;
+	USuqsObjectiveState* Obj;
+	int TaskIndex;
+	return FindTask(Identifier, Obj, TaskIndex) ? Obj->GetTask(TaskIndex) : nullptr;
+}
+
+bool USuqsQuestState::FindTask(const FName& Identifier, USuqsObjectiveState*& OutObjective, int& OutTaskIndex) const
+{
+	// The compiled definition's task lookup leads straight to the objective & task, so we don't keep one of our own
+	if (IsCompiledDefinitionCurrent())
+	{
+		const int32* pTaskIndex = GetCompiledDefinition()->TaskLookup.Find(Identifier);
+		const FSuqsCompiledTask* CT = pTaskIndex ? Progression->GetCompiledTask(Progression->GetTaskHandleByIndex(*pTaskIndex)) : nullptr;
+		if (CT && Objectives.IsValidIndex(CT->ObjectiveIndex) && CT->TaskIndex < Objectives[CT->ObjectiveIndex]->GetNumTasks())
+		{
+			OutObjective = Objectives[CT->ObjectiveIndex];
+			OutTaskIndex = CT->TaskIndex;
+			return true;
+		}
+		return false;
+	}
+
+	// Not compiled, or recompiled since we were initialised
+	for (auto Obj : Objectives)
+	{
+		for (int i = 0; i < Obj->GetNumTasks(); ++i)
+		{
+			if (Obj->GetTaskDefinition(i).Identifier == Identifier)
+			{
+				OutObjective = Obj;
+				OutTaskIndex = i;
+				return true;
+			}
+		}
+	}
+	return false;
 }
 
 
@@ -88,7 +177,15 @@ void USuqsQuestState::SetBranchActive(FName Branch, bool bActive)
 		bChanged = ActiveBranches.Remove(Branch) > 0;
 
 	if (bChanged)
-		NotifyObjectiveStatusChanged();
+	{
+		// Branches no objective uses can't change anything, they're just remembered
+		const int32 BranchIndex = GetBranchIndex(Branch);
+		if (BranchIndex != INDEX_NONE)
+		{
+			ActiveBranchBits[BranchIndex] = bActive;
+			NotifyObjectiveStatusChanged();
+		}
+	}
 }
 
 void USuqsQuestState::ResetBranches()
@@ -96,6 +193,7 @@ void USuqsQuestState::ResetBranches()
 	if (ActiveBranches != QuestDefinition->DefaultActiveBranches)
 	{
 		ActiveBranches = QuestDefinition->DefaultActiveBranches;
+		UpdateActiveBranchBits();
 		NotifyObjectiveStatusChanged();
 	}
 }
@@ -105,49 +203,109 @@ bool USuqsQuestState::IsBranchActive(FName Branch)
 	// No branch is always active
 	if (Branch.IsNone())
 		return true;
-	
-	return ActiveBranches.Contains(Branch);
+
+	const int32 BranchIndex = GetBranchIndex(Branch);
+	if (BranchIndex != INDEX_NONE)
+		return ActiveBranchBits[BranchIndex];
+
+	// Global branches are only pushed to quests which use them, but still count as active everywhere
+	return ActiveBranches.Contains(Branch) ||
+		(Progression.IsValid() && Progression->IsGlobalQuestBranchActive(Branch));
+}
+
+bool USuqsQuestState::IsObjectiveOnActiveBranch(const USuqsObjectiveState* Objective) const
+{
+	if (Objective->BranchIndex != INDEX_NONE && ActiveBranchBits.IsValidIndex(Objective->BranchIndex))
+		return ActiveBranchBits[Objective->BranchIndex];
+
+	// No compiled branch info, fall back on names
+	return Objective->GetBranch().IsNone() || ActiveBranches.Contains(Objective->GetBranch());
+}
+
+const FSuqsCompiledQuest* USuqsQuestState::GetCompiledDefinition() const
+{
+	return Progression.IsValid() ? Progression->GetCompiledQuest(Handle) : nullptr;
+}
+
+bool USuqsQuestState::IsCompiledDefinitionCurrent() const
+{
+	// A recompiled quest can be given the same task range again, so the start of the range isn't enough on its own
+	const auto CQ = FirstCompiledTask >= 0 ? GetCompiledDefinition() : nullptr;
+	return CQ && CQ->FirstTask == FirstCompiledTask &&
+		(CQ->NumTasks == 0 || Progression->GetTaskHandleByIndex(FirstCompiledTask).Generation == FirstCompiledTaskGeneration);
+}
+
+int32 USuqsQuestState::GetBranchIndex(const FName& Branch) const
+{
+	if (const auto CQ = GetCompiledDefinition())
+	{
+		if (const int32* pIndex = CQ->BranchLookup.Find(Branch))
+			return *pIndex;
+	}
+	return INDEX_NONE;
+}
+
+void USuqsQuestState::UpdateActiveBranchBits()
+{
+	const auto CQ = GetCompiledDefinition();
+	ActiveBranchBits.Init(false, CQ ? CQ->BranchLookup.Num() : 0);
+	for (const auto& Branch : ActiveBranches)
+	{
+		const int32 BranchIndex = GetBranchIndex(Branch);
+		if (BranchIndex != INDEX_NONE)
+			ActiveBranchBits[BranchIndex] = true;
+	}
 }
 
 bool USuqsQuestState::CompleteTask(FName TaskID)
 {
-	if (auto T = GetTask(TaskID))
+	USuqsObjectiveState* Obj;
+	int TaskIndex;
+	if (FindTask(TaskID, Obj, TaskIndex))
 	{
-		return T->Complete();
+		return Obj->CompleteTask(TaskIndex);
 	}
 	return false;
 }
 
 void USuqsQuestState::ResolveTask(FName TaskID)
 {
-	if (auto T = GetTask(TaskID))
+	USuqsObjectiveState* Obj;
+	int TaskIndex;
+	if (FindTask(TaskID, Obj, TaskIndex))
 	{
-		T->Resolve();
+		Obj->ResolveTask(TaskIndex);
 	}
 }
 
 void USuqsQuestState::FailTask(const FName& TaskID)
 {
-	if (auto T = GetTask(TaskID))
+	USuqsObjectiveState* Obj;
+	int TaskIndex;
+	if (FindTask(TaskID, Obj, TaskIndex))
 	{
-		T->Fail();
+		Obj->FailTask(TaskIndex);
 	}	
 }
 
 int USuqsQuestState::ProgressTask(FName TaskID, int Delta)
 {
-	if (auto T = GetTask(TaskID))
+	USuqsObjectiveState* Obj;
+	int TaskIndex;
+	if (FindTask(TaskID, Obj, TaskIndex))
 	{
-		return T->Progress(Delta);
+		return Obj->ProgressTask(TaskIndex, Delta);
 	}
 	return 0;
 }
 
 void USuqsQuestState::SetTaskNumberCompleted(FName TaskID, int Number)
 {
-	if (auto T = GetTask(TaskID))
+	USuqsObjectiveState* Obj;
+	int TaskIndex;
+	if (FindTask(TaskID, Obj, TaskIndex))
 	{
-		return T->SetNumber(Number);
+		Obj->SetTaskNumber(TaskIndex, Number);
 	}
 }
 
@@ -269,36 +427,44 @@ USuqsTaskState* USuqsQuestState::GetNextMandatoryTask() const
 
 bool USuqsQuestState::IsTaskIncomplete(const FName& TaskID) const
 {
-	if (auto T = GetTask(TaskID))
+	USuqsObjectiveState* Obj;
+	int TaskIndex;
+	if (FindTask(TaskID, Obj, TaskIndex))
 	{
-		return T->IsIncomplete();
+		return Obj->IsTaskIncomplete(TaskIndex);
 	}
 	return false;
 }
 
 bool USuqsQuestState::IsTaskCompleted(const FName& TaskID) const
 {
-	if (auto T = GetTask(TaskID))
+	USuqsObjectiveState* Obj;
+	int TaskIndex;
+	if (FindTask(TaskID, Obj, TaskIndex))
 	{
-		return T->IsCompleted();
+		return Obj->GetTaskStatus(TaskIndex) == ESuqsTaskStatus::Completed;
 	}
 	return false;
 }
 
 bool USuqsQuestState::IsTaskFailed(const FName& TaskID) const
 {
-	if (auto T = GetTask(TaskID))
+	USuqsObjectiveState* Obj;
+	int TaskIndex;
+	if (FindTask(TaskID, Obj, TaskIndex))
 	{
-		return T->IsFailed();
+		return Obj->GetTaskStatus(TaskIndex) == ESuqsTaskStatus::Failed;
 	}
 	return false;
 }
 
 bool USuqsQuestState::IsTaskRelevant(const FName& TaskID) const
 {
-	if (auto T = GetTask(TaskID))
+	USuqsObjectiveState* Obj;
+	int TaskIndex;
+	if (FindTask(TaskID, Obj, TaskIndex))
 	{
-		return T->IsRelevant();
+		return Obj->IsTaskRelevant(TaskIndex);
 	}
 	return false;
 	
@@ -306,9 +472,11 @@ bool USuqsQuestState::IsTaskRelevant(const FName& TaskID) const
 
 void USuqsQuestState::ResetTask(FName TaskID)
 {
-	if (auto T = GetTask(TaskID))
+	USuqsObjectiveState* Obj;
+	int TaskIndex;
+	if (FindTask(TaskID, Obj, TaskIndex))
 	{
-		T->Reset();
+		Obj->ResetTask(TaskIndex);
 	}	
 }
 
@@ -372,6 +540,8 @@ void USuqsQuestState::SetResolveBarrier(const FSuqsResolveBarrierStateData& Barr
 	ResolveBarrier = Barrier;
 	// In case this completes
 	MaybeNotifyStatusChange();
+	Progression->ScheduleTick(this);
+	Progression->WaitForGate(this);
 }
 
 void USuqsQuestState::StartLoad()
@@ -387,27 +557,37 @@ void USuqsQuestState::FinishLoad()
 	}
 	NotifyObjectiveStatusChanged();
 
-	// Also need to determine if the title needs formatting, since Initialise() is not called
-	bTitleNeedsFormatting = USuqsProgression::GetTextNeedsFormatting(QuestDefinition->Title); 
-
 	bIsLoading = false;
 }
 
-void USuqsQuestState::NotifyObjectiveStatusChanged()
+void USuqsQuestState::NotifyObjectiveStatusChanged(const USuqsObjectiveState* ChangedObjectiveOrNull)
 {
+	// Objectives may have deferred changes if we're in a batch, bring them up to date first
+	const bool bProcessedDeferred = Progression->ProcessDeferredObjectiveUpdates(this);
+
 	// Re-scan the objectives from top to bottom (this allows ANY change to have been made, including backtracking)
 	// The next active objective is the next incomplete one in sequence which is on an active branch
 	// If there is no next objective, then the quest is complete.
 	int PrevObjIndex = CurrentObjectiveIndex;
-	CurrentObjectiveIndex = -1;
+	int ScanFromIndex = 0;
 	bool FailQuest = false;
+	if (ChangedObjectiveOrNull && !bProcessedDeferred && Objectives.IsValidIndex(CurrentObjectiveIndex) &&
+		ChangedObjectiveOrNull->ObjectiveIndex >= CurrentObjectiveIndex &&
+		Objectives.IsValidIndex(ChangedObjectiveOrNull->ObjectiveIndex) &&
+		Objectives[ChangedObjectiveOrNull->ObjectiveIndex] == ChangedObjectiveOrNull)
+	{
+		// Only the current objective or later changed, so nothing before the current objective is different
+		ScanFromIndex = CurrentObjectiveIndex;
+		FailQuest = bPreviousObjectivesFailQuest;
+	}
+	CurrentObjectiveIndex = -1;
 
-	for (int i = 0; i < Objectives.Num(); ++i)
+	for (int i = ScanFromIndex; i < Objectives.Num(); ++i)
 	{
 		auto Obj = Objectives[i];
 		// We ignore objectives not on the current branch entirely
 		// The first objective that's on an active branch and incomplete is the current objective
-		if (IsBranchActive(Obj->GetBranch()))
+		if (IsObjectiveOnActiveBranch(Obj))
 		{
 			if (Obj->IsIncomplete())
 			{
@@ -423,6 +603,8 @@ void USuqsQuestState::NotifyObjectiveStatusChanged()
 		}
 	}
 
+	bPreviousObjectivesFailQuest = FailQuest;
+
 	// If any unfiltered objectives failed, we lose
 	if (FailQuest)
 	{
@@ -449,16 +631,18 @@ void USuqsQuestState::NotifyObjectiveStatusChanged()
 				if (Objectives.IsValidIndex(PrevObjIndex))
 				{
 					const auto PrevObj = Objectives[PrevObjIndex];
-					for (const auto PrevTask : PrevObj->GetTasks())
+					for (int i = 0; i < PrevObj->GetNumTasks(); ++i)
 					{
-						if (!PrevTask->GetHidden())
+						if (!PrevObj->GetTaskHidden(i))
 						{
-							Progression->RaiseTaskRemoved(PrevTask);
+							Progression->RaiseTaskRemoved(PrevObj, i);
 						}
 					}
 				}
 				Progression->RaiseCurrentObjectiveChanged(this);
 			}
+			// Only tasks on the current objective tick
+			ScheduleCurrentObjectiveTick();
 		}
 	}
 }
@@ -512,6 +696,8 @@ void USuqsQuestState::QueueStatusChangeNotification()
 
 	// May immediately be satisfied
 	MaybeNotifyStatusChange();
+	Progression->ScheduleTick(this);
+	Progression->WaitForGate(this);
 }
 
 bool USuqsQuestState::IsResolveBlockedOn(ESuqsResolveBarrierCondition Barrier) const
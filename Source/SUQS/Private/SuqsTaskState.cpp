@@ -1,331 +1,210 @@
 #include "SuqsTaskState.h"
 
-#include <algorithm>
-#include "Suqs.h"
 #include "SuqsProgression.h"
+#include "SuqsWaypointComponent.h"
 #include "SuqsWaypointSubsystem.h"
 #include "Kismet/GameplayStatics.h"
 
-void USuqsTaskState::Initialise(const FSuqsTask* TaskDef, USuqsObjectiveState* ObjState, USuqsProgression* Root)
+void USuqsTaskState::Initialise(const FSuqsTask* TaskDef,
+                                const FSuqsCompiledTask* CompiledTask,
+                                USuqsObjectiveState* ObjState,
+                                USuqsProgression* Root)
 {
 	TaskDefinition = TaskDef;
 	ParentObjective = ObjState;
 	Progression = Root;
 
-	bTitleNeedsFormatting = USuqsProgression::GetTextNeedsFormatting(TaskDef->Title);
+	// Waypoint changes aren't passed on while pooled
+	CachedWaypoints.Reset();
+	CachedWaypointSubsystem.Reset();
+	bWaypointsCached = false;
 
-	Reset();
+	// Derived flags are worked out once when the definition is compiled, only fall back if that's missing
+	if (CompiledTask)
+		bTitleNeedsFormatting = CompiledTask->bTitleNeedsFormatting;
+	else
+		bTitleNeedsFormatting = USuqsProgression::GetTextNeedsFormatting(TaskDef->Title);
 }
 
-void USuqsTaskState::Tick(float DeltaTime)
+void USuqsTaskState::Detach()
 {
-	// Don't reduce time when task is hidden (e.g. not the next in sequence)
-	// Also not when also completed / failed
-	if (!bHidden &&
-		IsIncomplete() && 
-		IsTimeLimited() &&
-		TimeRemaining > 0)
-	{
-		SetTimeRemaining(TimeRemaining - DeltaTime);
-	}
-
-	if (IsResolveBlockedOn(ESuqsResolveBarrierCondition::Time))
-	{
-		ResolveBarrier.TimeRemaining = FMath::Max(ResolveBarrier.TimeRemaining - DeltaTime, 0.f);
-		MaybeNotifyParentStatusChange();
-	}
+	ParentObjective = nullptr;
+	TaskIndex = -1;
+	CachedWaypoints.Reset();
+	CachedWaypointSubsystem.Reset();
+	bWaypointsCached = false;
 }
 
-FText USuqsTaskState::GetTitle() const
+int USuqsTaskState::GetNumber() const
 {
-	if (bTitleNeedsFormatting)
-		return GetRootProgression()->FormatTaskText(GetParentObjective()->GetParentQuest()->GetIdentifier(),
-													 GetIdentifier(),
-													 TaskDefinition->Title);
-	else
-		return TaskDefinition->Title;
+	return ParentObjective ? ParentObjective->GetTaskNumber(TaskIndex) : 0;
 }
 
-void USuqsTaskState::SetTimeRemaining(float T)
+float USuqsTaskState::GetTimeRemaining() const
 {
-	const float PrevTime = TimeRemaining;
-	// Clamp to 0, but allow higher than taskdef time limit if desired
-    TimeRemaining = std::max(0.f, T);
-		
-	if (IsTimeLimited() && TimeRemaining < PrevTime)
-	{
-		Progression->RaiseTaskUpdated(this);
-		if (TimeRemaining <= 0)
-		{
-			TimeRemaining = 0;
-			if (TaskDefinition->TimeLimitCompleteOnExpiry)
-			{
-				Complete();
-			}
-			else
-			{
-				Fail();
-			}
-		}
-	}	
+	return ParentObjective ? ParentObjective->GetTaskTimeRemaining(TaskIndex) : 0;
 }
 
-void USuqsTaskState::SetResolveBarrier(const FSuqsResolveBarrier& Barrier)
+ESuqsTaskStatus USuqsTaskState::GetStatus() const
 {
-	ResolveBarrier = Barrier;
-	// In case manually changing to free up
-	MaybeNotifyParentStatusChange();
+	return ParentObjective ? ParentObjective->GetTaskStatus(TaskIndex) : ESuqsTaskStatus::NotStarted;
 }
 
-void USuqsTaskState::ChangeStatus(ESuqsTaskStatus NewStatus, bool bIgnoreResolveBarriers)
+bool USuqsTaskState::GetHidden() const
 {
-	if (Status != NewStatus)
-	{
-		Status = NewStatus;
-
-		switch(NewStatus)
-		{
-		case ESuqsTaskStatus::Completed: 
-			Progression->RaiseTaskCompleted(this);
-			break;
-		case ESuqsTaskStatus::Failed:
-			Progression->RaiseTaskFailed(this);
-			break;
-		default:
-			Progression->RaiseTaskUpdated(this);
-			break;
-		}
+	return ParentObjective ? ParentObjective->GetTaskHidden(TaskIndex) : false;
+}
 
-		QueueParentStatusChangeNotification(bIgnoreResolveBarriers);
+FSuqsResolveBarrier USuqsTaskState::GetResolveBarrier() const
+{
+	return ParentObjective ? ParentObjective->GetTaskResolveBarrier(TaskIndex) : FSuqsResolveBarrier();
+}
 
-	}
+int USuqsTaskState::GetTargetNumber() const
+{
+	return ParentObjective ? ParentObjective->GetTaskTargetNumber(TaskIndex) : TaskDefinition->TargetNumber;
 }
 
-void USuqsTaskState::QueueParentStatusChangeNotification(bool bIgnoreBarriers)
+FText USuqsTaskState::GetTitle() const
 {
-	if (bIgnoreBarriers)
-	{
-		ResolveBarrier = FSuqsResolveBarrier();
-		ResolveBarrier.bPending = true;
-	}
+	if (bTitleNeedsFormatting && ParentObjective)
+		return GetRootProgression()->FormatTaskText(GetParentObjective()->GetParentQuest()->GetIdentifier(),
+													 GetIdentifier(),
+													 TaskDefinition->Title);
 	else
-	{
-		ResolveBarrier = Progression->GetResolveBarrierForTask(TaskDefinition, Status);
-	}
-
-	MaybeNotifyParentStatusChange();
-	
+		return TaskDefinition->Title;
 }
 
-bool USuqsTaskState::IsResolveBlockedOn(ESuqsResolveBarrierCondition Barrier) const
+void USuqsTaskState::SetTimeRemaining(float T)
 {
-	return ResolveBarrier.bPending &&
-	   (ResolveBarrier.Conditions & static_cast<uint32>(Barrier)) > 0;
+	if (ParentObjective)
+		ParentObjective->SetTaskTimeRemaining(TaskIndex, T);
 }
 
-void USuqsTaskState::MaybeNotifyParentStatusChange()
+void USuqsTaskState::SetResolveBarrier(const FSuqsResolveBarrier& Barrier)
 {
-	// Early-out if barrier has already been processed so we only do this once per status change
-	if (!ResolveBarrier.bPending)
-		return;
-
-	// Assume cleared
-	bool bCleared = true;
-
-	// All conditions have to be fulfilled
-	if (IsResolveBlockedOn(ESuqsResolveBarrierCondition::Time))
-	{
-		if (ResolveBarrier.TimeRemaining > 0)
-		{
-			bCleared = false;
-		}
-	}
-	if (IsResolveBlockedOn(ESuqsResolveBarrierCondition::Gate))
-	{
-		if (!Progression->IsGateOpen(ResolveBarrier.Gate))
-		{
-			bCleared = false;
-		}
-	}
-	if (IsResolveBlockedOn(ESuqsResolveBarrierCondition::Explicit))
-	{
-		bCleared = ResolveBarrier.bGrantedExplicitly;
-	}
-	
-	if (bCleared)
-	{
-		ResolveBarrier.bPending = false;
-		ParentObjective->NotifyTaskStatusChanged(this);
-	}
+	if (ParentObjective)
+		ParentObjective->SetTaskResolveBarrier(TaskIndex, Barrier);
 }
 
 void USuqsTaskState::Fail(bool bIgnoreResolveBarriers)
 {
-	ChangeStatus(ESuqsTaskStatus::Failed, bIgnoreResolveBarriers);
+	if (ParentObjective)
+		ParentObjective->FailTask(TaskIndex, bIgnoreResolveBarriers);
 }
 
 bool USuqsTaskState::Complete(bool bIgnoreResolveBarriers)
 {
-	if (Status != ESuqsTaskStatus::Completed)
-	{
-		// Skip validation when loading
-		if (!ParentObjective->GetParentQuest()->IsLoading())
-		{
-			// Check sequencing
-			if (ParentObjective->GetParentQuest()->GetCurrentObjective() != ParentObjective)
-			{
-				UE_LOG(LogSUQS, Verbose, TEXT("Tried to complete task %s but parent objective %s is not current, ignoring"),
-					*GetIdentifier().ToString(), *ParentObjective->GetIdentifier().ToString())
-				return false;
-			}
-			if (ParentObjective->AreTasksSequential())
-			{
-				// Only allowed if optional or next in sequence
-				if (IsMandatory() && ParentObjective->GetNextMandatoryTask() != this)
-				{
-					UE_LOG(LogSUQS, Warning, TEXT("Tried to complete mandatory task %s out of order, ignoring"), *GetIdentifier().ToString())
-					return false;
-				}
-			}
-		}		
-		Number = TaskDefinition->TargetNumber;
-		ChangeStatus(ESuqsTaskStatus::Completed, bIgnoreResolveBarriers);
-	}
-	// Already completed
-	return true;
+	return ParentObjective && ParentObjective->CompleteTask(TaskIndex, bIgnoreResolveBarriers);
 }
 
 void USuqsTaskState::Resolve()
 {
-	ResolveBarrier.bGrantedExplicitly = true;
-	MaybeNotifyParentStatusChange();
+	if (ParentObjective)
+		ParentObjective->ResolveTask(TaskIndex);
 }
 
 int USuqsTaskState::Progress(int Delta)
 {
-	SetNumber(Number + Delta);
-
-	return GetNumberOutstanding();
+	return ParentObjective ? ParentObjective->ProgressTask(TaskIndex, Delta) : 0;
 }
 
-
 void USuqsTaskState::SetNumber(int N)
 {
-	const int PrevNumber = Number;
-	// Clamp
-	Number = std::min(std::max(0, N), TaskDefinition->TargetNumber);
-
-	if (PrevNumber != Number)
-	{
-		Progression->RaiseTaskUpdated(this);
-
-		if (Number == TaskDefinition->TargetNumber)
-			Complete();
-		else
-			ChangeStatus(Number > 0 ? ESuqsTaskStatus::InProgress : ESuqsTaskStatus::NotStarted);
-		
-	}
-	
+	if (ParentObjective)
+		ParentObjective->SetTaskNumber(TaskIndex, N);
 }
 
 int USuqsTaskState::GetNumberOutstanding() const
 {
 	// Number should be limited already so don't waste time clamping
-	return GetTargetNumber() - Number;
+	return GetTargetNumber() - GetNumber();
 }
 
 void USuqsTaskState::Reset()
 {
-	const bool bRaiseUpdate = Number > 0 || TimeRemaining < TaskDefinition->TimeLimit;
-	Number = 0;
-	TimeRemaining = TaskDefinition->TimeLimit;
-	ChangeStatus(ESuqsTaskStatus::NotStarted);
-
-	// There isn't an event for change status back to not started
-	if (bRaiseUpdate)
-		Progression->RaiseTaskUpdated(this);
-
+	if (ParentObjective)
+		ParentObjective->ResetTask(TaskIndex);
 }
 
 bool USuqsTaskState::IsResolveBlocked() const
 {
-	return !IsIncomplete() &&
-		ResolveBarrier.Conditions > 0 &&
-		ResolveBarrier.bPending;
-}
-
-void USuqsTaskState::NotifyGateOpened(const FName& GateName)
-{
-	if (IsResolveBlockedOn(ESuqsResolveBarrierCondition::Gate) && ResolveBarrier.Gate == GateName)
-		MaybeNotifyParentStatusChange();
+	return ParentObjective && ParentObjective->IsTaskResolveBlocked(TaskIndex);
 }
 
 bool USuqsTaskState::IsHiddenOnCompleteOrFail() const
 {
-	return !TaskDefinition->bAlwaysVisible && IsMandatory() &&
-		(ParentObjective.IsValid() && ParentObjective->AreTasksSequential());
+	return ParentObjective && ParentObjective->IsTaskHiddenOnCompleteOrFail(TaskIndex);
 }
 
 bool USuqsTaskState::IsRelevant() const
 {
-	return
-		IsIncomplete() &&
-		!bHidden &&
-		GetParentObjective() == GetParentObjective()->GetParentQuest()->GetCurrentObjective() &&
-		GetParentObjective()->GetParentQuest()->IsIncomplete();
+	return ParentObjective && ParentObjective->IsTaskRelevant(TaskIndex);
 }
 
 USuqsWaypointComponent* USuqsTaskState::GetWaypoint(bool bOnlyEnabled)
 {
-	if (IsValid(GetWorld()))
-	{
-		const auto GI = UGameplayStatics::GetGameInstance(this);
-		if (IsValid(GI))
-		{
-			auto Suqs = GI->GetSubsystem<USuqsWaypointSubsystem>();
-			return Suqs->GetWaypoint(GetParentObjective()->GetParentQuest()->GetIdentifier(), GetIdentifier(), bOnlyEnabled);
-		}
-	}
-
-	return nullptr;
+	const auto Waypoints = GetWaypointsRange(bOnlyEnabled);
+	return Waypoints.IsEmpty() ? nullptr : (*Waypoints.begin()).Get();
 }
 
 TArray<USuqsWaypointComponent*> USuqsTaskState::GetWaypoints(bool bOnlyEnabled)
 {
 	TArray<USuqsWaypointComponent*> Ret;
-	if (IsValid(GetWorld()))
+	for (const auto& W : GetWaypointsRange(bOnlyEnabled))
 	{
-		const auto GI = UGameplayStatics::GetGameInstance(this);
-		if (IsValid(GI))
-		{
-			auto Suqs = GI->GetSubsystem<USuqsWaypointSubsystem>();
-			Suqs->GetWaypoints(GetParentObjective()->GetParentQuest()->GetIdentifier(), GetIdentifier(), bOnlyEnabled, Ret);
-		}
+		Ret.Add(W.Get());
 	}
 	return Ret;
 }
 
-void USuqsTaskState::FinishLoad()
+TSuqsFilteredRange<const TWeakObjectPtr<USuqsWaypointComponent>> USuqsTaskState::GetWaypointsRange(bool bOnlyEnabled)
+{
+	using FWaypointRange = TSuqsFilteredRange<const TWeakObjectPtr<USuqsWaypointComponent>>;
+	if (bOnlyEnabled)
+		return FWaypointRange(GetAllWaypoints(), [](const TWeakObjectPtr<USuqsWaypointComponent>& W) { return W.IsValid() && W->IsEnabled(); });
+	return FWaypointRange(GetAllWaypoints(), [](const TWeakObjectPtr<USuqsWaypointComponent>& W) { return W.IsValid(); });
+}
+
+const TArray<TWeakObjectPtr<USuqsWaypointComponent>>& USuqsTaskState::GetAllWaypoints()
 {
-	// Derive hidden from other state, since it's not saved
-	bHidden = false;
-	if (IsMandatory())
+	// No task to have waypoints any more
+	if (!ParentObjective)
 	{
-		if (IsHiddenOnCompleteOrFail() && (IsCompleted() || IsFailed()))
-		{
-			bHidden = true;
-		}
-		else
+		CachedWaypoints.Reset();
+		bWaypointsCached = false;
+		return CachedWaypoints;
+	}
+
+	// A waypoint registering or unregistering for this task makes the cache out of date, whether or not the
+	// subsystem knows about our progression
+	USuqsWaypointSubsystem* Suqs = CachedWaypointSubsystem.Get();
+	if (!Suqs)
+	{
+		// Only cache once we've been able to reach the subsystem, and never keep one from another subsystem
+		CachedWaypoints.Reset();
+		bWaypointsCached = false;
+		if (IsValid(GetWorld()))
 		{
-			// If incomplete, then this is hidden if objective is set to sequential tasks and this isn't the next one
-			auto Obj = GetParentObjective();
-			if (Obj->AreTasksSequential() && Obj->GetNextMandatoryTask() != this)
+			const auto GI = UGameplayStatics::GetGameInstance(this);
+			if (IsValid(GI))
 			{
-				bHidden = true;
+				Suqs = GI->GetSubsystem<USuqsWaypointSubsystem>();
+				CachedWaypointSubsystem = Suqs;
 			}
 		}
+		if (!Suqs)
+			return CachedWaypoints;
 	}
 
-	// Also need to determine if the title needs formatting, since Initialise() is not called
-	bTitleNeedsFormatting = USuqsProgression::GetTextNeedsFormatting(TaskDefinition->Title); 
+	const FName QuestID = GetParentObjective()->GetParentQuest()->GetIdentifier();
+	const uint32 Generation = Suqs->GetTaskGeneration(QuestID, GetIdentifier());
+	if (!bWaypointsCached || CachedWaypointsGeneration != Generation)
+	{
+		CachedWaypoints.Reset();
+		Suqs->GetWaypoints(QuestID, GetIdentifier(), false, CachedWaypoints);
+		CachedWaypointsGeneration = Generation;
+		bWaypointsCached = true;
+	}
+	return CachedWaypoints;
 }
@@ -0,0 +1,49 @@
+#include "SuqsTaskStateStore.h"
+
+int32 FSuqsTaskStateStore::Allocate()
+{
+	int32 Slot;
+	if (FreeSlots.Num() > 0)
+	{
+		Slot = FreeSlots.Pop(false);
+	}
+	else
+	{
+		Slot = Number.AddUninitialized();
+		TargetNumber.AddUninitialized();
+		TimeRemaining.AddUninitialized();
+		Status.AddUninitialized();
+		Hidden.Add(false);
+		ResolveBarrier.AddDefaulted();
+	}
+	ResetSlot(Slot);
+	return Slot;
+}
+
+void FSuqsTaskStateStore::Release(int32 Slot)
+{
+	// Reset when it's next allocated
+	if (Number.IsValidIndex(Slot))
+		FreeSlots.Add(Slot);
+}
+
+void FSuqsTaskStateStore::ResetSlot(int32 Slot)
+{
+	Number[Slot] = 0;
+	TargetNumber[Slot] = 1;
+	TimeRemaining[Slot] = 0;
+	Status[Slot] = ESuqsTaskStatus::NotStarted;
+	Hidden[Slot] = false;
+	ResolveBarrier[Slot] = FSuqsResolveBarrier();
+}
+
+SIZE_T FSuqsTaskStateStore::GetAllocatedSize() const
+{
+	return Number.GetAllocatedSize() +
+		TargetNumber.GetAllocatedSize() +
+		TimeRemaining.GetAllocatedSize() +
+		Status.GetAllocatedSize() +
+		Hidden.GetAllocatedSize() +
+		ResolveBarrier.GetAllocatedSize() +
+		FreeSlots.GetAllocatedSize();
+}
@@ -2,9 +2,60 @@
 #include "SuqsProgression.h"
 #include "SuqsWaypointComponent.h"
 
+namespace
+{
+	template<typename TWaypointPtr>
+	bool AppendTaskWaypoints(const TArray<USuqsWaypointComponent*>& List,
+	                         const FName& TaskID,
+	                         bool bOnlyEnabled,
+	                         TArray<TWaypointPtr>& OutWaypoints)
+	{
+		bool bAnyFound = false;
+		bool bFoundTask = false;
+		for (auto W : List)
+		{
+			if (W->GetTaskID() == TaskID)
+			{
+				bFoundTask = true;
+				if (!bOnlyEnabled || W->IsEnabled())
+				{
+					// Waypoints are pre-sorted by SequenceIndex
+					OutWaypoints.Add(W);
+					// we won't use OutWayPoints.Num() to determine if we found anything, because we're not clearing the list
+					// to give callers the flexibility of appending to an existing list if they want
+					bAnyFound = true;
+				}
+			}
+			else if (bFoundTask)
+			{
+				// Tasks are grouped in the list already so we can process in sequence
+				// Once we exit the task we know we're done
+				break;
+			}
+		}
+		return bAnyFound;
+	}
+}
+
+void USuqsWaypointSubsystem::BumpTaskGeneration(FQuestWaypoints& QuestWaypoints, const FName& TaskID)
+{
+	QuestWaypoints.TaskGenerations.Add(TaskID, NextTaskGeneration++);
+}
+
+uint32 USuqsWaypointSubsystem::GetTaskGeneration(const FName& QuestID, const FName& TaskID) const
+{
+	if (const auto pQuest = WaypointsByQuest.Find(QuestID))
+	{
+		if (const uint32* pGeneration = pQuest->TaskGenerations.Find(TaskID))
+			return *pGeneration;
+	}
+	return 0;
+}
+
 void USuqsWaypointSubsystem::RegisterWaypoint(USuqsWaypointComponent* Waypoint)
 {
-	auto& List = WaypointsByQuest.FindOrAdd(Waypoint->GetQuestID());
+	auto& QuestWaypoints = WaypointsByQuest.FindOrAdd(Waypoint->GetQuestID());
+	auto& List = QuestWaypoints.Waypoints;
 
 	// group by task, then if there's >1 waypoint for a single task, order by sequence index for later convenience
 	bool bInserted = false;
@@ -44,6 +95,9 @@ void USuqsWaypointSubsystem::RegisterWaypoint(USuqsWaypointComponent* Waypoint)
 
 	if (bInserted)
 	{
+		// Only this task needs to re-fetch its cached waypoints
+		BumpTaskGeneration(QuestWaypoints, Waypoint->GetTaskID());
+
 		// Initialise the waypoint IsCurrent state from quest progression
 		// This isn't saved in the waypoint savegame data because it's derived from quest progression and
 		// may be out of date from when it was last saved (making progress while the level is unloaded)
@@ -59,10 +113,11 @@ void USuqsWaypointSubsystem::RegisterWaypoint(USuqsWaypointComponent* Waypoint)
 
 void USuqsWaypointSubsystem::UnregisterWaypoint(USuqsWaypointComponent* Waypoint)
 {
-	const auto pList = WaypointsByQuest.Find(Waypoint->GetQuestID());
-	if (pList)
+	const auto pQuest = WaypointsByQuest.Find(Waypoint->GetQuestID());
+	if (pQuest)
 	{
-		pList->RemoveSingle(Waypoint);
+		pQuest->Waypoints.RemoveSingle(Waypoint);
+		BumpTaskGeneration(*pQuest, Waypoint->GetTaskID());
 		Waypoint->OnWaypointMoved.RemoveDynamic(this, &USuqsWaypointSubsystem::OnWaypointMoved);
 		Waypoint->OnWaypointEnabledChanged.RemoveDynamic(this, &USuqsWaypointSubsystem::OnWaypointEnabledChanged);
 		Waypoint->OnWaypointIsCurrentChanged.RemoveDynamic(this, &USuqsWaypointSubsystem::OnWaypointIsCurrentChanged);
@@ -75,10 +130,10 @@ USuqsWaypointComponent* USuqsWaypointSubsystem::GetWaypoint(const FName& QuestID
                                                             const FName& TaskID,
                                                             bool bOnlyEnabled)
 {
-	const auto pList = WaypointsByQuest.Find(QuestID);
-	if (pList)
+	const auto pQuest = WaypointsByQuest.Find(QuestID);
+	if (pQuest)
 	{
-		for (auto W : *pList)
+		for (auto W : pQuest->Waypoints)
 		{
 			if (W->GetTaskID() == TaskID &&
 				(!bOnlyEnabled || W->IsEnabled()))
@@ -96,34 +151,17 @@ bool USuqsWaypointSubsystem::GetWaypoints(const FName& QuestID,
                                           bool bOnlyEnabled,
                                           TArray<USuqsWaypointComponent*>& OutWaypoints)
 {
-	const auto pList = WaypointsByQuest.Find(QuestID);
-	bool bAnyFound = false;
-	if (pList)
-	{
-		bool bFoundTask = false;
-		for (auto W : *pList)
-		{
-			if (W->GetTaskID() == TaskID)
-			{
-				bFoundTask = true;
-				if (!bOnlyEnabled || W->IsEnabled())
-				{
-					// Waypoints are pre-sorted by SequenceIndex
-					OutWaypoints.Add(W);
-					// we won't use OutWayPoints.Num() to determine if we found anything, because we're not clearing the list
-					// to give callers the flexibility of appending to an existing list if they want
-					bAnyFound = true;
-				}
-			}
-			else if (bFoundTask)
-			{
-				// Tasks are grouped in the list already so we can process in sequence
-				// Once we exit the task we know we're done
-				break;
-			}
-		}
-	}
-	return bAnyFound;
+	const auto pQuest = WaypointsByQuest.Find(QuestID);
+	return pQuest && AppendTaskWaypoints(pQuest->Waypoints, TaskID, bOnlyEnabled, OutWaypoints);
+}
+
+bool USuqsWaypointSubsystem::GetWaypoints(const FName& QuestID,
+                                          const FName& TaskID,
+                                          bool bOnlyEnabled,
+                                          TArray<TWeakObjectPtr<USuqsWaypointComponent>>& OutWaypoints)
+{
+	const auto pQuest = WaypointsByQuest.Find(QuestID);
+	return pQuest && AppendTaskWaypoints(pQuest->Waypoints, TaskID, bOnlyEnabled, OutWaypoints);
 }
 
 void USuqsWaypointSubsystem::SetProgression(USuqsProgression* Prog)
@@ -144,7 +182,7 @@ void USuqsWaypointSubsystem::OnProgressionLoaded(USuqsProgression* Prog)
 		// Refresh all waypoints currently loaded
 		for (auto Pair : WaypointsByQuest)
 		{
-			auto Waypoints = Pair.Value;
+			auto Waypoints = Pair.Value.Waypoints;
 			for (auto W : Waypoints)
 			{
 				W->SetIsCurrent(Progression->IsTaskRelevant(W->GetQuestID(), W->GetTaskID()));
@@ -24,10 +24,22 @@ class USuqsWaypointSubsystem : public UGameInstanceSubsystem
 	GENERATED_BODY()
 
 protected:
-	// Indexed by QuestID, then a list grouped by TaskID, ordered within that by SequenceIndex
-	TMap<FName, TArray<USuqsWaypointComponent*>> WaypointsByQuest;
+	struct FQuestWaypoints
+	{
+		/// Grouped by TaskID, ordered within that by SequenceIndex
+		TArray<USuqsWaypointComponent*> Waypoints;
+		/// Changed whenever a waypoint for the task is registered or unregistered, so tasks know when their cached
+		/// waypoints are out of date. Tasks which have never had a waypoint aren't in here, and are generation 0
+		TMap<FName, uint32> TaskGenerations;
+	};
+	// Indexed by QuestID
+	TMap<FName, FQuestWaypoints> WaypointsByQuest;
+	/// Task generations are taken from here, so one task's generation never repeats in this subsystem
+	uint32 NextTaskGeneration = 1;
 
 	TWeakObjectPtr<USuqsProgression> Progression;
+
+	void BumpTaskGeneration(FQuestWaypoints& QuestWaypoints, const FName& TaskID);
 	
 public:
 
@@ -47,6 +59,10 @@ public:
 
 	void SetProgression(USuqsProgression* Prog);
 
+	/// Tasks cache their waypoints along with this value, and re-fetch them when it's changed
+	/// Changes whenever a waypoint is registered or unregistered for this task, and only then
+	uint32 GetTaskGeneration(const FName& QuestID, const FName& TaskID) const;
+
 	/**
 	 * @brief Get a single waypoint for a task
 	 * @param QuestID The quest identifier (required)
@@ -64,6 +80,8 @@ public:
 	 * @param OutWaypoints Array to append to with waypoints (will not be cleared first) 
 	 */
 	bool GetWaypoints(const FName& QuestID, const FName& TaskID, bool bOnlyEnabled, TArray<USuqsWaypointComponent*>& OutWaypoints);
+	/// Same as above, for tasks filling their waypoint cache directly
+	bool GetWaypoints(const FName& QuestID, const FName& TaskID, bool bOnlyEnabled, TArray<TWeakObjectPtr<USuqsWaypointComponent>>& OutWaypoints);
 
 protected:
 	UFUNCTION()
@@ -0,0 +1,63 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include <type_traits>
+
+/**
+ * A view of the items in an array which pass a filter, for iterating in C++ without building a new array.
+ * Use in a ranged for. The filter is tested as you iterate, so the view sees the current state of the items, and
+ * (like TArrayView) it's only valid for as long as the array it views isn't changed.
+ */
+template <typename ItemType>
+class TSuqsFilteredRange
+{
+public:
+	using FilterType = bool(*)(const ItemType&);
+
+	class FIterator
+	{
+	public:
+		FIterator(const TSuqsFilteredRange& InRange, int32 InIndex) : Range(InRange), Index(InIndex) { SkipFiltered(); }
+
+		FIterator& operator++() { ++Index; SkipFiltered(); return *this; }
+		ItemType& operator*() const { return Range.Items[Index]; }
+		bool operator!=(const FIterator& Other) const { return Index != Other.Index; }
+
+	private:
+		void SkipFiltered()
+		{
+			while (Index < Range.Items.Num() && !Range.Filter(Range.Items[Index]))
+				++Index;
+		}
+
+		const TSuqsFilteredRange& Range;
+		int32 Index;
+	};
+
+	TSuqsFilteredRange(TArrayView<ItemType> InItems, FilterType InFilter) : Items(InItems), Filter(InFilter) {}
+
+	FIterator begin() const { return FIterator(*this, 0); }
+	FIterator end() const { return FIterator(*this, Items.Num()); }
+
+	/// Return whether no items pass the filter
+	bool IsEmpty() const { return !(begin() != end()); }
+	/// Count the items which pass the filter
+	int32 Num() const
+	{
+		int32 Count = 0;
+		for (FIterator It = begin(); It != end(); ++It)
+			++Count;
+		return Count;
+	}
+	/// Add the items which pass the filter to an array
+	template <typename AllocatorType>
+	void AppendTo(TArray<std::remove_const_t<ItemType>, AllocatorType>& OutArray) const
+	{
+		for (ItemType& Item : *this)
+			OutArray.Add(Item);
+	}
+
+private:
+	TArrayView<ItemType> Items;
+	FilterType Filter;
+};
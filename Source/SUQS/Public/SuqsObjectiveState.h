@@ -2,10 +2,14 @@
 
 #include "CoreMinimal.h"
 
+#include "SuqsFilteredRange.h"
 #include "SuqsQuestState.h"
 #include "UObject/Object.h"
 #include "SuqsObjectiveState.generated.h"
 
+enum class ESuqsTaskStatus : uint8;
+struct FSuqsCompiledTask;
+class FSuqsTaskStateStore;
 
 UENUM(BlueprintType)
 enum class ESuqsObjectiveStatus : uint8
@@ -20,6 +24,17 @@ enum class ESuqsObjectiveStatus : uint8
     Failed = 20
 };
 
+/// How a task currently counts towards the status of its objective
+enum class ESuqsTaskCount : uint8
+{
+	NotMandatory,
+	Incomplete,
+	/// Completed, but the resolve barrier hasn't been cleared yet
+	CompletedPending,
+	Completed,
+	Failed
+};
+
 /**
  * Objective state
  */
@@ -29,32 +44,119 @@ class SUQS_API USuqsObjectiveState : public UObject
 	GENERATED_BODY()
 
 	friend class USuqsQuestState;
+	friend class USuqsTaskState;
+	friend class USuqsProgression;
 protected:
 	/// Whether this objective has been started, completed, failed (quick access to looking at tasks)
 	UPROPERTY(BlueprintReadOnly, Category="Objective Status")
 	ESuqsObjectiveStatus Status = ESuqsObjectiveStatus::NotStarted;
 
-	/// List of detailed task status
-	UPROPERTY(BlueprintReadOnly, Category="Objective Status")
+	/// Task state objects, indexed as the definition's tasks. Null (or empty) until something asks for them, see GetTask
+	UPROPERTY()
 	TArray<USuqsTaskState*> Tasks;
+	/// Slot of each task in the progression's task state store, indexed as the definition's tasks
+	TArray<int32> TaskSlots;
 	
 	const FSuqsObjective* ObjectiveDefinition;
 	TWeakObjectPtr<USuqsQuestState> ParentQuest;
 	TWeakObjectPtr<USuqsProgression> Progression;
 
 	int MandatoryTasksNeededToComplete;
+	/// Index of this objective in the parent quest
+	int ObjectiveIndex = -1;
+	/// Index of our branch in the parent quest's active branch bits, -1 if not on a branch
+	int BranchIndex = -1;
+	/// Index of our first task in the progression's compiled tasks, -1 if not compiled
+	int FirstCompiledTask = -1;
 
+	// Task counts are maintained incrementally as tasks notify us, rather than re-scanning all tasks every time
+	/// How each task was last counted, indexed as TaskSlots
+	TArray<ESuqsTaskCount> TaskCounts;
+	int MandatoryTasksComplete = 0;
+	int MandatoryTasksFailed = 0;
+	int MandatoryTasksIncomplete = 0;
+	/// Index of the first task counted as mandatory & incomplete, GetNumTasks() if none
+	int NextMandatoryTaskIndex = 0;
+	/// Number of failed mandatory tasks before NextMandatoryTaskIndex
+	int MandatoryTasksFailedBeforeNext = 0;
+	/// Indexes of tasks whose status / barrier has changed since they were last counted
+	TArray<int> UncountedTasks;
 	
 	void Initialise(const FSuqsObjective* ObjDef, USuqsQuestState* QuestState, USuqsProgression* Root);
-	void Tick(float DeltaTime);
+	void RebindDefinition(const FSuqsObjective* ObjDef);
+	void AllocateTaskSlots(int NumTasks);
+	void ReleaseTaskSlots();
+	FSuqsTaskStateStore& GetTaskStore() const;
+	const FSuqsCompiledTask* GetCompiledTask(int TaskIndex) const;
 	// Private fail/complete since users should only ever call task fail/complete
 	void ChangeStatus(ESuqsObjectiveStatus NewStatus);
+	ESuqsTaskCount GetTaskCount(int TaskIndex) const;
+	void AddTaskCount(ESuqsTaskCount Count, int Delta);
+	void RecountTasks();
+	void UpdateTaskCount(int TaskIndex);
+	void UpdateTaskHidden(int TaskIndex);
+	void UpdateStatusFromTaskCounts();
+	void MarkTaskUncounted(int TaskIndex);
+	int GetNextMandatoryTaskIndex() const;
+
+	// Task behaviour, by index so that it doesn't need the task's USuqsTaskState. See USuqsTaskState for details
+	void TickTask(int TaskIndex, float DeltaTime);
+	bool IsTaskTickRequired(int TaskIndex) const;
+	void ChangeTaskStatus(int TaskIndex, ESuqsTaskStatus NewStatus, bool bIgnoreResolveBarriers = false);
+	void QueueTaskStatusChangeNotification(int TaskIndex, bool bIgnoreBarriers);
+	bool IsTaskResolveBlockedOn(int TaskIndex, ESuqsResolveBarrierCondition Barrier) const;
+	void MaybeNotifyTaskStatusChange(int TaskIndex);
+	void FailTask(int TaskIndex, bool bIgnoreResolveBarriers = false);
+	bool CompleteTask(int TaskIndex, bool bIgnoreResolveBarriers = false);
+	void ResolveTask(int TaskIndex);
+	int ProgressTask(int TaskIndex, int Delta);
+	void SetTaskNumber(int TaskIndex, int N);
+	void SetTaskTimeRemaining(int TaskIndex, float T);
+	void SetTaskResolveBarrier(int TaskIndex, const FSuqsResolveBarrier& Barrier);
+	void ResetTask(int TaskIndex);
+	void NotifyTaskGateOpened(int TaskIndex, const FName& GateName);
+	void FinishTaskLoad(int TaskIndex);
 
 public:
 	// C++ access
 	
+	using FTaskRange = TSuqsFilteredRange<USuqsTaskState* const>;
+
 	ESuqsObjectiveStatus GetStatus() const { return Status; }
-	const TArray<USuqsTaskState*>& GetTasks() { return Tasks; }
+	TArrayView<USuqsTaskState* const> GetTasksView() const;
+
+	// Task state by index, without needing the task's USuqsTaskState
+	int GetNumTasks() const { return TaskSlots.Num(); }
+	const FSuqsTask& GetTaskDefinition(int TaskIndex) const { return ObjectiveDefinition->Tasks[TaskIndex]; }
+	/// Task title, formatted if it needs to be (see USuqsTaskState::GetTitle)
+	FText GetTaskTitle(int TaskIndex) const;
+	int GetTaskNumber(int TaskIndex) const;
+	int GetTaskTargetNumber(int TaskIndex) const;
+	float GetTaskTimeRemaining(int TaskIndex) const;
+	ESuqsTaskStatus GetTaskStatus(int TaskIndex) const;
+	bool GetTaskHidden(int TaskIndex) const;
+	const FSuqsResolveBarrier& GetTaskResolveBarrier(int TaskIndex) const;
+	bool IsTaskIncomplete(int TaskIndex) const;
+	bool IsTaskRelevant(int TaskIndex) const;
+	bool IsTaskResolveBlocked(int TaskIndex) const;
+	bool IsTaskHiddenOnCompleteOrFail(int TaskIndex) const;
+	/// Whether the task's USuqsTaskState has been created yet
+	bool HasTaskObject(int TaskIndex) const { return Tasks.IsValidIndex(TaskIndex) && Tasks[TaskIndex] != nullptr; }
+
+	/// Get the state of a task, creating it if nothing has needed it before
+	USuqsTaskState* GetTask(int TaskIndex) const;
+
+	/// Get the states of all tasks, in definition order. Creates any which nothing has needed before
+	UFUNCTION(BlueprintCallable, BlueprintPure)
+	const TArray<USuqsTaskState*>& GetTasks() const;
+	/// Iterate the tasks GetAllRelevantTasks would return, without building an array
+	FTaskRange GetRelevantTasksRange() const;
+	/// Iterate the tasks GetIncompleteTasks would return, without building an array
+	FTaskRange GetIncompleteTasksRange() const;
+	/// Iterate the tasks GetCompletedTasks would return, without building an array
+	FTaskRange GetCompletedTasksRange() const;
+	/// Iterate the tasks GetFailedTasks would return, without building an array
+	FTaskRange GetFailedTasksRange() const;
 
 	/// Objective identifier, which may be blank
 	UFUNCTION(BlueprintCallable, BlueprintPure)
@@ -129,7 +231,37 @@ public:
     bool IsOnActiveBranch() const;
 
 	
-	void NotifyTaskStatusChanged(const USuqsTaskState* ChangedTaskOrNull);
+	/// Re-count the changed task, or all of them if ChangedTaskIndex is INDEX_NONE
+	void NotifyTaskStatusChanged(int ChangedTaskIndex);
 	void NotifyGateOpened(const FName& GateName);
 	void FinishLoad();
+
+	virtual void BeginDestroy() override;
+};
+
+/// A task in an objective state, for keeping track of tasks without needing their USuqsTaskState
+struct FSuqsTaskStateRef
+{
+	TWeakObjectPtr<USuqsObjectiveState> Objective;
+	int TaskIndex = -1;
+
+	FSuqsTaskStateRef() {}
+	FSuqsTaskStateRef(USuqsObjectiveState* InObjective, int InTaskIndex) : Objective(InObjective), TaskIndex(InTaskIndex) {}
+
+	/// Get the objective, if it still exists and still has this task
+	USuqsObjectiveState* GetObjective() const
+	{
+		USuqsObjectiveState* Obj = Objective.Get();
+		return Obj && TaskIndex >= 0 && TaskIndex < Obj->GetNumTasks() ? Obj : nullptr;
+	}
+
+	friend bool operator==(const FSuqsTaskStateRef& A, const FSuqsTaskStateRef& B)
+	{
+		return A.Objective == B.Objective && A.TaskIndex == B.TaskIndex;
+	}
+
+	friend uint32 GetTypeHash(const FSuqsTaskStateRef& Ref)
+	{
+		return HashCombine(GetTypeHash(Ref.Objective), ::GetTypeHash(Ref.TaskIndex));
+	}
 };
@@ -49,6 +49,8 @@ struct SUQS_API FSuqsTaskStateView
 
 	FSuqsTaskStateView();
 	void FromUObject(USuqsTaskState* State);
+	/// Fill from a task by index, without needing its USuqsTaskState
+	void FromState(const USuqsObjectiveState* Objective, int TaskIndex);
 
 	bool IsModified(const FSuqsTaskStateView& Rhs) const
 	{
@@ -2,11 +2,16 @@
 
 #include "CoreMinimal.h"
 #include "SuqsQuest.h"
+#include "SuqsQuestArena.h"
+#include "SuqsQuestHandles.h"
+#include "SuqsObjectiveState.h"
 #include "SuqsQuestState.h"
 #include "Engine/DataTable.h"
+#include "Engine/StreamableManager.h"
 #include "UObject/Object.h"
 #include "SuqsSaveData.h"
 #include "SuqsTaskState.h"
+#include "SuqsTaskStateStore.h"
 #include "SuqsParameterProvider.h"
 #include "SuqsProgression.generated.h"
 
@@ -123,6 +128,24 @@ public:
 	FSuqsProgressionEventDetails(): EventType(), Quest(nullptr), Objective(nullptr), Task(nullptr), Waypoint(nullptr)
 	{
 	}
+
+	friend bool operator==(const FSuqsProgressionEventDetails& A, const FSuqsProgressionEventDetails& B)
+	{
+		return A.EventType == B.EventType &&
+			A.Quest == B.Quest &&
+			A.Objective == B.Objective &&
+			A.Task == B.Task &&
+			A.Waypoint == B.Waypoint;
+	}
+
+	friend uint32 GetTypeHash(const FSuqsProgressionEventDetails& Evt)
+	{
+		uint32 Hash = ::GetTypeHash(static_cast<uint8>(Evt.EventType));
+		Hash = HashCombine(Hash, ::GetTypeHash(Evt.Quest));
+		Hash = HashCombine(Hash, ::GetTypeHash(Evt.Objective));
+		Hash = HashCombine(Hash, ::GetTypeHash(Evt.Task));
+		return HashCombine(Hash, ::GetTypeHash(Evt.Waypoint));
+	}
 };
 
 DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FOnProgressionEvent, const FSuqsProgressionEventDetails&, Details);
@@ -139,12 +162,40 @@ DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FOnQuestAccepted, USuqsQuestState*,
 
 DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FOnProgressionLoaded, USuqsProgression*, Progression);
 DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FOnProgressParameterProvidersChanged, USuqsProgression*, Progression);
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FOnQuestDataReady, USuqsProgression*, Progression);
 
 // C++ only because of non-const struct
 DECLARE_DELEGATE_TwoParams(FOnPreLoad, USuqsProgression*, FSuqsSaveData&);
 
 class USuqsWaypointComponent;
 
+/// Quests and tasks whose resolve barriers are waiting on a single gate
+struct FSuqsGateWaiters
+{
+	TArray<TWeakObjectPtr<USuqsQuestState>> Quests;
+	TArray<FSuqsTaskStateRef> Tasks;
+};
+
+/// Compact state of an archived quest, held instead of a quest state until something needs more than its status.
+/// Only tasks which have moved on from their initial state are recorded
+struct FSuqsArchivedQuestRecord
+{
+	struct FTask
+	{
+		FName Identifier;
+		int32 Number;
+		float TimeRemaining;
+		FSuqsResolveBarrier ResolveBarrier;
+	};
+
+	ESuqsQuestStatus Status;
+	FSuqsResolveBarrier ResolveBarrier;
+	TArray<FName> ActiveBranches;
+	TArray<FTask> Tasks;
+
+	SIZE_T GetAllocatedSize() const { return ActiveBranches.GetAllocatedSize() + Tasks.GetAllocatedSize(); }
+};
+
 /**
  * Progression holds all the state relating to all quests and their objectives/tasks for a single player.
  * Add this somewhere that's useful to you, e.g. your PlayerState or GameInstance.
@@ -163,9 +214,30 @@ protected:
 	UPROPERTY()
 	TArray<UDataTable*> QuestDataTables;
 
-	/// Unified quest defs, combined from all entries in QuestDataTables
-	UPROPERTY()
-	TMap<FName, FSuqsQuest> QuestDefinitions;
+	/// Compiled quest catalog data, see FSuqsQuestCatalog. Loaded in addition to QuestDataTables
+	TArray<uint8> QuestCatalogData;
+
+	/// Whether quest data is being loaded asynchronously, from starting the load until OnQuestDataReady
+	bool bQuestDataLoading = false;
+	/// Content paths being searched for quest datatables by InitWithQuestDataTablesInPathsAsync
+	TArray<FString> QuestDataLoadPaths;
+	/// Registered while waiting for the asset registry to finish its initial scan before searching QuestDataLoadPaths
+	FDelegateHandle AssetRegistryFilesLoadedHandle;
+	/// Handle for quest data tables being streamed in asynchronously, valid only while streaming
+	TSharedPtr<FStreamableHandle> QuestDataLoadHandle;
+	/// Calls which have been held until async quest data loading has finished
+	TArray<TFunction<void()>> CallsWaitingForQuestData;
+
+	/// Unified quest defs, combined from all entries in QuestDataTables and QuestCatalogData
+	/// Quests from datatables are referenced in place, the tables are kept alive by QuestDataTables and must not be
+	/// changed without a rebuild. Other quests point into OwnedQuestDefinitions
+	TMap<FName, const FSuqsQuest*> QuestDefinitions;
+	/// Storage for quest definitions which don't come from datatables (catalogs, runtime created)
+	FSuqsQuestArena OwnedQuestDefinitions;
+	/// Overrides for quests which are instances of templates, by instance quest identifier
+	TMap<FName, FSuqsQuestInstance> QuestInstances;
+	/// The template definition which owns the objectives & tasks of each quest instance, by instance quest identifier
+	TMap<FName, const FSuqsQuest*> QuestTemplates;
 
 	/// Map of active quests
 	UPROPERTY()
@@ -174,31 +246,193 @@ protected:
 	/// Archive of completed / failed quests
 	UPROPERTY()
 	TMap<FName, USuqsQuestState*> QuestArchive;
+	/// Archived quests which are held as compact records rather than in QuestArchive, see CompactArchivedQuests
+	/// A quest state is rebuilt from the record (which is then dropped) the first time one is needed
+	TMap<FName, FSuqsArchivedQuestRecord> ArchivedQuestRecords;
+	/// Whether an archived quest is being rebuilt from its record, which must not repeat its knock-on effects
+	bool bHydratingArchivedQuest = false;
+
+	/// Reverse lookup of task identifier to the tasks with that identifier in active quests, for wildcard task
+	/// operations. Kept in sync with ActiveQuests, which holds the references
+	TMap<FName, TArray<FSuqsTaskStateRef>> ActiveTasksByID;
+	/// State of every task in the quest states of this progression, in a slot per task of each objective state
+	/// Not reset with the quest data, since old quest states may still be around to release their slots
+	FSuqsTaskStateStore TaskStates;
+
+	/// Status of every accepted quest, active or archived, so status queries only need a single lookup
+	/// Kept in sync whenever a quest changes status or moves between ActiveQuests / QuestArchive / ArchivedQuestRecords
+	TMap<FName, ESuqsQuestStatus> QuestStatusLookup;
+
+	/// Compiled quest definitions, indexed by quest handle. Slots of deleted definitions are re-used
+	TArray<FSuqsCompiledQuest> CompiledQuests;
+	/// Compiled task definitions, indexed by task handle. Ranges of deleted or recompiled quests are re-used
+	TArray<FSuqsCompiledTask> CompiledTasks;
+	/// Quest handle indexes freed by deleted definitions, re-used before CompiledQuests grows
+	TArray<int32> FreeQuestIndexes;
+	/// Ranges of CompiledTasks freed by deleted or recompiled quests, as first index & count, sorted and merged
+	TArray<TPair<int32, int32>> FreeTaskRanges;
+	/// Quest identifier to quest handle index
+	TMap<FName, int32> QuestHandleLookup;
+	/// The accepted (active or archived) state of each quest by handle index, or null. Mirrors ActiveQuests and
+	/// QuestArchive, which hold the references
+	TArray<USuqsQuestState*> QuestStatesByHandle;
+	/// Quest states which are no longer accepted, by quest handle index, kept so that accepting or loading that quest
+	/// again re-initialises them in place rather than creating a new object for every quest, objective and task
+	UPROPERTY()
+	TMap<int32, USuqsQuestState*> QuestStatePool;
+	/// Quest states waiting to go into QuestStatePool, because they were removed while events which may refer to
+	/// them (or be running on them) were being raised
+	UPROPERTY()
+	TArray<USuqsQuestState*> PendingQuestStatePool;
+	/// Branch name -> handle indexes of quests with objectives on that branch, so branch changes only visit those
+	TMap<FName, TArray<int32>> QuestsByBranch;
 
 	TArray<FName> GlobalActiveBranches;
 	TSet<FName> OpenGates;
-	// Name of quest completed -> names of other quests that depend on its completion
-	TMultiMap<FName, FName> QuestCompletionDeps;
-	// Name of quest completed -> names of other quests that depend on its failure
-	TMultiMap<FName, FName> QuestFailureDeps;
+	/// Number of prerequisites of each quest which are not currently met, indexed by quest handle
+	/// Maintained as quest statuses change, so dependency checks don't need to look up every prerequisite
+	TArray<int32> UnmetPrerequisiteCounts;
+	/// Prerequisite quest name -> handle indexes of quests depending on its completion, for quests not defined yet
+	TMultiMap<FName, int32> UnresolvedCompletionPrerequisites;
+	/// Prerequisite quest name -> handle indexes of quests depending on its failure, for quests not defined yet
+	TMultiMap<FName, int32> UnresolvedFailurePrerequisites;
+
+	/// Quests which may have a timed resolve barrier counting down. Only these are ticked, so that quests without
+	/// any timers cost nothing per frame. Entries which no longer need ticking are dropped during Tick
+	/// Weak, like GateWaiters, since the states are owned through ActiveQuests; this way the garbage collector
+	/// has no extra references to follow
+	TSet<TWeakObjectPtr<USuqsQuestState>> TickingQuests;
+	/// Tasks which may have a time limit or timed resolve barrier counting down, see TickingQuests
+	TSet<FSuqsTaskStateRef> TickingTasks;
+	/// Gate name -> quests & tasks with resolve barriers waiting on it, so that opening a gate only notifies those.
+	/// Entries can go stale (e.g. barrier has since been reset), which is checked when the gate opens
+	TMap<FName, FSuqsGateWaiters> GateWaiters;
 
 	TArray<TWeakObjectPtr<UObject>> ParameterProviders;
 	UPROPERTY()
 	USuqsNamedFormatParams* FormatParams;
 
 	bool bSuppressEvents = false;
+	/// Depth of event broadcasts in progress
+	int EventBroadcastDepth = 0;
+
+	/// Depth of nested BeginBatch calls
+	int BatchDepth = 0;
+	/// Whether EndBatch is propagating deferred changes; events are still queued until that's done
+	bool bFlushingBatch = false;
+	/// Objectives whose task changes haven't been processed yet because they happened in a batch
+	UPROPERTY()
+	TArray<USuqsObjectiveState*> DeferredObjectiveUpdates;
+	/// Quests whose objective changes haven't been processed yet because they happened in a batch
+	UPROPERTY()
+	TArray<USuqsQuestState*> DeferredQuestUpdates;
+	/// Events waiting to be raised, in order
+	UPROPERTY()
+	TArray<FSuqsProgressionEventDetails> QueuedEvents;
+	/// Events in QueuedEvents which have been superseded by a later identical event and won't be raised
+	TBitArray<> SupersededEvents;
+	/// Index of the latest of each distinct event in QueuedEvents
+	TMap<FSuqsProgressionEventDetails, int32> QueuedEventIndices;
+	/// Whether events are queued and raised once per tick, see SetDeferEvents
+	bool bDeferEvents = false;
+
+	static constexpr uint32 EventTypeBit(ESuqsProgressionEventType EventType) { return 1u << static_cast<uint8>(EventType); }
+	/// Bitmask of event types which may be combined when queued, see SetEventTypeCoalesced
+	uint32 CoalescedEventTypes =
+		EventTypeBit(ESuqsProgressionEventType::ActiveQuestsChanged) |
+		EventTypeBit(ESuqsProgressionEventType::QuestCurrentObjectiveChanged) |
+		EventTypeBit(ESuqsProgressionEventType::TaskAdded) |
+		EventTypeBit(ESuqsProgressionEventType::TaskUpdated) |
+		EventTypeBit(ESuqsProgressionEventType::TaskRemoved) |
+		EventTypeBit(ESuqsProgressionEventType::WaypointMoved) |
+		EventTypeBit(ESuqsProgressionEventType::WaypointEnabledOrDisabled);
+
 	float DefaultQuestResolveTimeDelay = 0;
 	float DefaultTaskResolveTimeDelay = 0;
 	bool bSubcribedToWaypointEvents = false;	
 
+	/// Find the active or archived quest state, rebuilding it from a compact archived record if needed
 	USuqsQuestState* FindQuestState(const FName& QuestID);
+	/// Find the active or archived quest state; compact archived records aren't rebuilt, so may return null for those
 	const USuqsQuestState* FindQuestState(const FName& QuestID) const;
+	/// Find the active or archived quest state without rebuilding it from a compact archived record
+	USuqsQuestState* FindExistingQuestState(const FName& QuestID) const;
 	USuqsTaskState* FindTaskStatus(const FName& QuestID, const FName& TaskID);
-
+	/// Find a task in an active or archived quest, without needing its USuqsTaskState
+	FSuqsTaskStateRef FindTask(const FName& QuestID, const FName& TaskID);
+	/// Find the live task state for a handle, without needing its USuqsTaskState
+	FSuqsTaskStateRef FindTask(FSuqsTaskHandle Task) const;
+
+	FName FindInstanceOfTemplate(const FSuqsQuest* Template) const;
+	/// Replace an existing definition in place, keeping its handle & progress where task IDs still match
+	/// Instance & Template are given if the new definition is a quest instance
+	bool OverwriteQuestDefinition(FSuqsQuest&& NewQuest, const FSuqsQuestInstance* Instance = nullptr, const FSuqsQuest* Template = nullptr);
 	void RebuildAllQuestData();
-	void AddQuestDefinitionInternal(const FSuqsQuest& Quest);
+	void AddQuestDefinitionInternal(FSuqsQuest InQuest);
+	/// Validate, compile & add quest definitions, returning the number of errors found
+	int32 AddQuestDefinitionsInternal(const TArray<const FSuqsQuest*>& Quests, bool bReportErrors = true);
+	void ReportQuestDefinitionErrors(int32 NumErrors) const;
+	void CancelQuestDataLoad();
+	void OnAssetRegistryFilesLoaded();
+	void RequestQuestDataTables();
+	void LoadQuestDataTablesAsync(const TArray<FSoftObjectPath>& TablePaths);
+	void OnQuestDataTablesLoaded(TArray<FSoftObjectPath> TablePaths);
 	bool AutoAcceptQuests(const FName& FinishedQuestID, bool bFailed);
+	void AddActiveQuest(USuqsQuestState* Quest);
+	void RemoveActiveQuest(const FName& QuestID);
+	void UpdateQuestLookups(USuqsQuestState* Quest);
+	int32 AllocateQuestIndex();
+	void ReleaseQuestIndex(int32 QuestIndex);
+	int32 AllocateTaskRange(int32 NumTasks);
+	void ReleaseTaskRange(int32 FirstTask, int32 NumTasks);
+	void StoreCompiledQuest(int32 QuestIndex, FSuqsCompiledQuest&& Quest, TArray<FSuqsCompiledTask>& Tasks);
+	int32 RecompileQuestDefinition(int32 QuestIndex, const FSuqsQuest& Quest);
+	void InvalidateCompiledQuest(int32 QuestIndex);
+	void LinkQuestDependencies(int32 QuestIndex);
+	void UnlinkQuestDependencies(int32 QuestIndex);
+	void UpdateUnmetPrerequisites(const FName& QuestID, ESuqsQuestStatus OldStatus, ESuqsQuestStatus NewStatus);
+	void ResetUnmetPrerequisites();
+	int32 CheckQuestDependencyCycles(const TArray<int32>& StartQuestIndexes) const;
+	static void CompileQuestDefinition(const FSuqsQuest& Quest,
+	                                   const TArray<FSuqsObjective>& Objectives,
+	                                   const FSuqsQuestInstance* Instance,
+	                                   FSuqsCompiledQuest& OutQuest,
+	                                   TArray<FSuqsCompiledTask>& OutTasks,
+	                                   TArray<const FSuqsTask*>& OutDuplicateTasks);
+	static uint32 GetQuestDefinitionHash(const FSuqsQuest& Quest, const TArray<FSuqsObjective>& Objectives,
+	                                     const FSuqsQuestInstance* Instance = nullptr);
+	/// Whether objectives & tasks have the same identifiers in the same positions as the compiled quest
+	bool MatchesCompiledStructure(int32 QuestIndex, const TArray<FSuqsObjective>& Objectives) const;
+	bool DiscardQuestState(int32 QuestIndex, FSuqsQuestStateData* OutData);
+	USuqsQuestState* LoadQuestFromData(const FSuqsQuest* QDef, const FSuqsQuestStateData& QData);
+	USuqsQuestState* NewQuestState(const FSuqsQuest* QDef);
+	void PoolQuestState(USuqsQuestState* Quest);
+	void PoolPendingQuestStates();
+	void UnscheduleQuestState(USuqsQuestState* Quest);
+	bool AddArchivedQuestRecord(const FSuqsQuest* QDef, const FSuqsQuestStateData& QData);
+	USuqsQuestState* HydrateArchivedQuest(const FName& QuestID);
+	static void ArchivedQuestRecordToData(const FName& QuestID, const FSuqsArchivedQuestRecord& Record, FSuqsQuestStateData& QData);
+	// Status of objectives / tasks in compact archived records, the same as they would be if the quest was rebuilt
+	bool IsArchivedBarrierPending(const FSuqsResolveBarrier& Barrier) const;
+	ESuqsTaskStatus GetArchivedTaskStatus(const FName& QuestID, const FSuqsArchivedQuestRecord& Record, const FSuqsTask& TaskDef) const;
+	bool FindArchivedTaskStatus(const FName& QuestID, const FName& TaskID, ESuqsTaskStatus& OutStatus) const;
+	bool FindArchivedObjectiveStatus(const FName& QuestID, const FName& ObjectiveID, ESuqsObjectiveStatus& OutStatus) const;
+	void GetActiveTasks(const FName& TaskID, TArray<FSuqsTaskStateRef>& TasksOut) const;
+	void GetActiveQuestsUsingBranch(const FName& Branch, TArray<USuqsQuestState*>& QuestsOut) const;
+	bool IsActiveQuestInstance(const USuqsQuestState* Quest) const;
+	bool IsTickRequired(const USuqsQuestState* Quest) const;
+	bool IsTickRequired(const FSuqsTaskStateRef& Task) const;
 	static void SaveToData(TMap<FName, USuqsQuestState*> Quests, FSuqsSaveData& Data);
+	static void SaveQuestToData(const USuqsQuestState* Q, const FName& QuestID, TArrayView<const FName> TaskIDs, FSuqsQuestStateData& QData);
+	bool IsQueuingEvents() const { return bDeferEvents || BatchDepth > 0 || bFlushingBatch; }
+	void QueueOrBroadcastEvent(const FSuqsProgressionEventDetails& Evt);
+	void BroadcastEvent(const FSuqsProgressionEventDetails& Evt);
+	void BroadcastQueuedEvents();
+	/// Get the state object of a task to raise an event for, if anything is listening for that event
+	USuqsTaskState* GetTaskForEvent(USuqsObjectiveState* Objective, int TaskIndex, ESuqsProgressionEventType EventType) const;
+	/// Get the state object of a task whose waypoints need updating, null if it can't have any waypoints
+	USuqsTaskState* GetTaskWithWaypoints(USuqsObjectiveState* Objective, int TaskIndex) const;
+	void SetTaskWaypointsCurrent(USuqsObjectiveState* Objective, int TaskIndex, bool bIsCurrent);
 	FText FormatQuestOrTaskText(const FName& QuestID, const FName& TaskID, const FText& FormatText);
 
 	UFUNCTION()
@@ -226,6 +460,71 @@ public:
 	UFUNCTION(BlueprintCallable)
     void InitWithQuestDataTablesInPaths(const TArray<FString>& Paths);
 
+	/**
+	 * Initialise this progress instance with quest definitions contained in all datatables found in the given content
+	 * locations, without blocking. Only quest datatables are loaded, found via the asset registry, and they're
+	 * streamed in asynchronously. If the asset registry is still scanning (editor), the search waits for it to finish.
+	 * OnQuestDataReady is raised once they're available. Until then any existing quest data and progress is left as
+	 * it is, and calls which change progress (accepting, completing, resetting, branches, gates, loading saved
+	 * progress etc) or quest definitions (creating, overwriting, deleting) are held, then run in the order they were
+	 * made once the new quest data is ready.
+	 * Paths must be of the form "/Game/Sub/Folder/Within/Content". Will recurse into subdirectories.
+	 * You must also call this BEFORE calling any other function
+	 */
+	UFUNCTION(BlueprintCallable)
+	void InitWithQuestDataTablesInPathsAsync(const TArray<FString>& Paths);
+
+	/// Initialise this progress instance with quest definitions from a list of datatables, streaming them in
+	/// asynchronously. Otherwise behaves the same as InitWithQuestDataTablesInPathsAsync.
+	UFUNCTION(BlueprintCallable)
+	void InitWithQuestDataTablesAsync(const TArray<TSoftObjectPtr<UDataTable>>& Tables);
+
+	/**
+	 * Reload the quest datatables this progression was initialised with, after they've been changed, without losing
+	 * progress. Only quests whose definitions changed have their state rebuilt, keeping task progress and resolve
+	 * barriers for tasks which still exist; other quests are left alone. New quests are added, and quests which
+	 * are no longer in the tables are removed along with their progress.
+	 * Task handles for changed quests must be looked up again afterwards, quest handles remain valid.
+	 * Intended for live iteration on quest data, e.g. after reimporting quest JSON during PIE.
+	 */
+	UFUNCTION(BlueprintCallable)
+	void ReloadQuestData();
+
+	/// Replace the quest datatables this progression uses and reload them the same way as ReloadQuestData, rather
+	/// than resetting all progress like InitWithQuestDataTables.
+	UFUNCTION(BlueprintCallable)
+	void ReloadQuestDataTables(TArray<UDataTable*> Tables);
+
+	/// Return whether quest data is currently being loaded asynchronously
+	UFUNCTION(BlueprintCallable, BlueprintPure)
+	bool IsQuestDataLoading() const { return bQuestDataLoading; }
+
+	/// Call a function once quest data is ready. If quest data isn't being loaded asynchronously, it's called immediately.
+	/// Held calls run in the order they were made, along with calls held by progression functions themselves
+	void CallWhenQuestDataReady(TFunction<void()> Func);
+
+	/**
+	 * Initialise this progress instance with quest definitions from a compiled quest catalog (see FSuqsQuestCatalog),
+	 * which is much faster to load than importing from JSON / DataTables.
+	 * You should only call this once at startup. Calling it again will reset all progress data.
+	 * You must also call this BEFORE calling any other function
+	 * @param CatalogData Catalog data previously produced by WriteQuestCatalog
+	 * @return Whether the catalog was valid
+	 */
+	bool InitWithQuestCatalog(const TArray<uint8>& CatalogData);
+
+	/// Initialise this progress instance with quest definitions from a compiled quest catalog file.
+	/// See InitWithQuestCatalog
+	UFUNCTION(BlueprintCallable)
+	bool InitWithQuestCatalogFile(const FString& Filename);
+
+	/// Write all current quest definitions to a compiled quest catalog, which can later be loaded with InitWithQuestCatalog
+	void WriteQuestCatalog(TArray<uint8>& OutData) const;
+
+	/// Write all current quest definitions to a compiled quest catalog file, see WriteQuestCatalog
+	UFUNCTION(BlueprintCallable)
+	bool SaveQuestCatalogFile(const FString& Filename) const;
+
 	/**
 	 * Get a copy of a Quest Definition. This is mostly so that you can modify it and register it
 	 * as a new runtime quest
@@ -243,13 +542,59 @@ public:
 	 * @param bOverwriteIfExists If a quest with this ID already exists, overwrite it if this is true.
 	 * Otherwise, report an error and do nothing.
 	 * @return Whether the quest was added
-	 * @note If you overwrite an existing quest, stored progression against it will be reset.
+	 * @note Overwriting an existing quest keeps its handle, and any progress against it is kept where task
+	 * identifiers still match, just like a changed quest when quest data is reloaded.
 	 * @note Quest definitions added at runtime will be lost by calling any of the Init..() functions, or by
 	 * forcing a quest system rebuild with the optional parameter to GetQuestDefinitions
 	 */
 	UFUNCTION(BlueprintCallable)
 	bool CreateQuestDefinition(const FSuqsQuest& NewQuest, bool bOverwriteIfExists = false);
 
+	/**
+	 * Create runtime quest definitions directly from JSON (see docs/questschema.json). This streams the JSON straight
+	 * into quest definitions, which is much faster for large quest libraries than MakeQuestDataTableFromJSON.
+	 * @param JsonString JSON text containing an array of quests
+	 * @param bOverwriteIfExists If quests with the same IDs already exist, overwrite them if this is true.
+	 * Otherwise, report an error and skip them.
+	 * @return Whether every quest in the JSON was added. If the JSON was invalid nothing is added, and the error is
+	 * logged with line & column. If some quests were skipped (duplicates, or existing quests when not overwriting)
+	 * the rest are still added, but this returns false
+	 * @note Like other runtime created quests, these are lost by calling any of the Init..() functions
+	 */
+	UFUNCTION(BlueprintCallable)
+	bool CreateQuestDefinitionsFromJSON(const FString& JsonString, bool bOverwriteIfExists = false);
+
+	/**
+	 * Create a new quest as an instance of an existing template quest. The instance shares the template's objectives
+	 * and tasks rather than copying them, so this is much cheaper than GetQuestDefinitionCopy / CreateQuestDefinition
+	 * when you need lots of similar procedural quests. Instances behave like any other quest otherwise.
+	 * @param TemplateQuestID The identifier of the quest to use as a template
+	 * @param Instance The identifier & overrides for the new quest
+	 * @param bOverwriteIfExists If a quest with this ID already exists, overwrite it if this is true. As with
+	 * CreateQuestDefinition the handle is kept, and any progress is kept where task identifiers still match.
+	 * @return Whether the quest instance was created
+	 * @note Like runtime created quests, instances are lost on calling any of the Init..() functions, so you must
+	 * re-create them before loading saved progress against them. Templates cannot be deleted while instances of
+	 * them exist.
+	 */
+	UFUNCTION(BlueprintCallable)
+	bool CreateQuestInstance(FName TemplateQuestID, const FSuqsQuestInstance& Instance, bool bOverwriteIfExists = false);
+
+	/// Get the overrides for a quest if it's an instance of a template, or null if not
+	const FSuqsQuestInstance* GetQuestInstance(const FName& QuestID) const;
+	/// Get the template definition for a quest if it's an instance, or null if not
+	const FSuqsQuest* GetQuestTemplate(const FName& QuestID) const;
+	/// Get the identifier of the template for a quest if it's an instance, or None if not
+	UFUNCTION(BlueprintCallable)
+	FName GetQuestTemplateIdentifier(FName QuestID) const;
+	/// Get the objectives of a quest definition. Quest instances share their template's objectives, so the
+	/// Objectives of the definition itself are empty; always use this rather than reading them directly
+	const TArray<FSuqsObjective>& GetQuestObjectives(const FSuqsQuest& Quest) const;
+	/// Get a copy of the objectives of a quest definition, including those an instance shares with its template
+	/// @returns Whether the quest definition exists
+	UFUNCTION(BlueprintCallable)
+	bool GetQuestDefinitionObjectives(FName QuestID, TArray<FSuqsObjective>& OutObjectives) const;
+
 	/**
 	 * Delete an existing quest definition from the system
 	 * @param QuestID The identifier of the quest
@@ -314,6 +659,10 @@ public:
 	UPROPERTY(BlueprintAssignable)
 	FOnProgressParameterProvidersChanged OnParameterProvidersChanged;
 
+	/// Raised when quest data loaded by InitWithQuestDataTablesInPathsAsync is ready to use
+	UPROPERTY(BlueprintAssignable)
+	FOnQuestDataReady OnQuestDataReady;
+
 	/// Use this from C++ to receive access to the loaded quest data before it's applied to this progression
 	/// You can therefore change the quest data if you need to adapt it due to quest changes
 	FOnPreLoad OnPreLoad;
@@ -324,14 +673,35 @@ public:
 	 * represents all of the quests available.
 	 * @param bForceRebuild If true, force the internal rebuild of quest definitions. Only needed if you have changed the
 	 *   QuestDataTables property at runtime after using other methods on this instance, which is highly discouraged.
-	 * @return The quest definitions
+	 * @return The quest definitions. Definitions from datatables are the table rows themselves, not copies
+	 */
+	const TMap<FName, const FSuqsQuest*>& GetQuestDefinitions(bool bForceRebuild = false);
+
+	/**
+	 * Blueprint version of GetQuestDefinitions, which returns copies of the definitions rather than pointers.
+	 * Quest instances are copied with their template's objectives. This copies every definition, so for large quest
+	 * libraries prefer GetQuestDefinitionIDs and GetQuestDefinitionCopy.
+	 * Existing "Get Quest Definitions" Blueprint nodes are redirected to this.
 	 */
+	UFUNCTION(BlueprintCallable, meta=(DisplayName="Get Quest Definitions"))
+	TMap<FName, FSuqsQuest> GetQuestDefinitionsCopy(bool bForceRebuild = false);
+
+	/// Get the identifiers of all the quest definitions available. Use GetQuestDefinitionCopy for details
 	UFUNCTION(BlueprintCallable)
-	const TMap<FName, FSuqsQuest>& GetQuestDefinitions(bool bForceRebuild = false);
+	void GetQuestDefinitionIDs(TArray<FName>& OutQuestIDs) const;
 
 	/// Get the overall status of a named quest
 	UFUNCTION(BlueprintCallable)
 	ESuqsQuestStatus GetQuestStatus(FName QuestID) const;
+	/// Get the overall status of a quest by handle
+	ESuqsQuestStatus GetQuestStatus(FSuqsQuestHandle Quest) const;
+
+	/// Resolve a quest identifier to a handle, for use with the handle versions of functions in native code
+	FSuqsQuestHandle GetQuestHandle(const FName& QuestID) const;
+	/// Resolve an objective identifier to a handle, for use with the handle versions of functions in native code
+	FSuqsObjectiveHandle GetObjectiveHandle(const FName& QuestID, const FName& ObjectiveID) const;
+	/// Resolve a task identifier to a handle, for use with the handle versions of functions in native code
+	FSuqsTaskHandle GetTaskHandle(const FName& QuestID, const FName& TaskID) const;
 
 	/// Return whether the quest is or has been accepted for the player (may also be completed / failed)
 	UFUNCTION(BlueprintCallable)
@@ -363,17 +733,60 @@ public:
     void GetArchivedQuestIdentifiers(TArray<FName>& ArchivedQuestIDsOut) const;
 
 	/// Get the state of a quest
+	/// If the quest is archived and held as a compact record, its state is rebuilt, see CompactArchivedQuests
 	UFUNCTION(BlueprintCallable)
     USuqsQuestState* GetQuest(FName QuestID);
+	/// Get the state of a quest by handle, if it has been accepted
+	/// Returns null for archived quests held as compact records, use GetQuest(QuestID) to rebuild them
+	USuqsQuestState* GetQuest(FSuqsQuestHandle Quest) const;
+	/// Get the compiled data for a quest definition by handle
+	const FSuqsCompiledQuest* GetCompiledQuest(FSuqsQuestHandle Quest) const;
+	/// Get compiled information about a task definition
+	const FSuqsCompiledTask* GetCompiledTask(FSuqsTaskHandle Task) const;
+	/// Get the current handle for a task index from compiled quest data, e.g. FSuqsCompiledQuest::TaskLookup
+	FSuqsTaskHandle GetTaskHandleByIndex(int32 TaskIndex) const;
+	/// Get the state of an objective by handle, if its quest has been accepted
+	USuqsObjectiveState* GetObjective(FSuqsObjectiveHandle Objective) const;
 
 	/// Get a list of the currently accepted quests
 	UFUNCTION(BlueprintCallable)
     void GetAcceptedQuests(TArray<USuqsQuestState*>& AcceptedQuestsOut) const;
 
 	/// Get a list of the archived quests (those that were completed or failed)
+	/// Archived quests held as compact records aren't included, see CompactArchivedQuests. Use
+	/// GetArchivedQuestIdentifiers to list every archived quest, and GetQuest to get the state of one
 	UFUNCTION(BlueprintCallable)
     void GetArchivedQuests(TArray<USuqsQuestState*>& ArchivedQuestsOut) const;
 
+	/// Accepted quests by identifier, for iterating from C++ without building an array
+	const TMap<FName, USuqsQuestState*>& GetAcceptedQuestMap() const { return ActiveQuests; }
+	/// Archived quests by identifier, for iterating from C++ without building an array
+	/// Like GetArchivedQuests, this doesn't include those held as compact records, see ForEachArchivedQuest
+	const TMap<FName, USuqsQuestState*>& GetArchivedQuestMap() const { return QuestArchive; }
+	/// Call a function with the identifier of each archived quest, without building an array or rebuilding any
+	/// compact archived quests
+	void ForEachArchivedQuestIdentifier(TFunctionRef<void(const FName&)> Func) const;
+	/// Call a function for each archived quest with its identifier, plus either its state or its compact record
+	/// (the other is null). Nothing is rebuilt
+	void ForEachArchivedQuest(TFunctionRef<void(const FName&, const USuqsQuestState*, const FSuqsArchivedQuestRecord*)> Func) const;
+	/// Get the compact record of an archived quest, or null if it isn't archived or is held as a quest state
+	const FSuqsArchivedQuestRecord* GetArchivedQuestRecord(const FName& QuestID) const { return ArchivedQuestRecords.Find(QuestID); }
+
+	/**
+	 * Convert the states of archived quests into compact records, releasing their quest, objective and task objects.
+	 * Status queries for quests, objectives, tasks and branches are answered from the records. A state is only rebuilt
+	 * by GetQuest(QuestID) or by something which changes the quest (e.g. accepting, resetting, or changing a task).
+	 * Other functions returning states skip compact archived quests. Archived quests restored from saved data
+	 * start off compacted. Does nothing while events are being raised or in a batch, since those may refer to states.
+	 * @return The number of quests which were compacted
+	 */
+	UFUNCTION(BlueprintCallable)
+	int32 CompactArchivedQuests();
+	/// Get the number of archived quests which are currently held as compact records
+	int32 GetNumCompactArchivedQuests() const { return ArchivedQuestRecords.Num(); }
+	/// Memory allocated for compact archived quest records
+	SIZE_T GetArchivedQuestRecordsAllocatedSize() const;
+
 	/**
 	 * Accept a quest and track its state (if possible)
 	 * Note: you don't need to do this for quests which are set to auto-accept based on the completion of other quests.
@@ -382,7 +795,8 @@ public:
 	 * @param bResetIfFailed If this quest has failed, whether to reset it (default true)
 	 * @param bResetIfComplete If this quest has been previously completed, whether to reset it. Default false (do nothing)
 	 * @param bResetIfInProgress If this quest is already in progress, whether to reset it. If not, do nothing
-	 * @returns Whether the quest was successfully accepted
+	 * @returns Whether the quest was successfully accepted. If quest data is still loading asynchronously, the accept
+	 * is held until it's ready and this returns true
 	 */
 	UFUNCTION(BlueprintCallable)
 	bool AcceptQuest(FName QuestID, bool bResetIfFailed = true, bool bResetIfComplete = false, bool bResetIfInProgress = false);
@@ -435,10 +849,13 @@ public:
 	 * cascades upwards to the quest if that's the last mandatory objective.
 	 * @param QuestID The ID of the quest. If None, will scan all active quests and complete any task with TaskIdentifier
 	 * @param TaskIdentifier The identifier of the task within the quest (required)
-	 * @returns Whether the task was successfully completed
+	 * @returns Whether the task was successfully completed. If quest data is still loading asynchronously, the call
+	 * is held until it's ready and this returns true
 	 */
 	UFUNCTION(BlueprintCallable)
 	bool CompleteTask(FName QuestID, FName TaskIdentifier);
+	/// Fully complete a task by handle, see CompleteTask(FName, FName)
+	bool CompleteTask(FSuqsTaskHandle Task);
 
 	/**
 	 * Increment task progress. Increases the number value on a task, clamping it to the min/max numbers in the quest
@@ -446,10 +863,13 @@ public:
 	 * @param QuestID The ID of the quest. If None, will scan all active quests and progress any task with TaskIdentifier
 	 * @param TaskIdentifier The identifier of the task within the quest
 	 * @param Delta The change to make to the number on the task
-	 * @returns The number of "things" outstanding on the task after progress was applied
+	 * @returns The number of "things" outstanding on the task after progress was applied. If quest data is still
+	 * loading asynchronously, the call is held until it's ready and this returns -1
 	 */
 	UFUNCTION(BlueprintCallable)
 	int ProgressTask(FName QuestID, FName TaskIdentifier, int Delta);
+	/// Increment task progress by handle, see ProgressTask(FName, FName, int)
+	int ProgressTask(FSuqsTaskHandle Task, int Delta);
 
 	/**
 	 * Directly set the current completed number on a specific task. An alternative to the delta version ProgressTask. 
@@ -512,10 +932,14 @@ public:
 	/// Return whether a task is "Relevant" i.e. current and incomplete
 	UFUNCTION(BlueprintCallable)
 	bool IsTaskRelevant(FName QuestID, FName TaskID) const;
+	/// Return whether a task is "Relevant" by handle
+	bool IsTaskRelevant(FSuqsTaskHandle Task) const;
 	
 	/// Shortcut to getting the whole task state for a specific quest
 	UFUNCTION(BlueprintCallable)
 	USuqsTaskState* GetTaskState(FName QuestID, FName TaskID) const;
+	/// Get the task state by handle, if its quest has been accepted
+	USuqsTaskState* GetTaskState(FSuqsTaskHandle Task) const;
 
 	/// Reset a single task in the quest
 	UFUNCTION(BlueprintCallable)
@@ -577,12 +1001,52 @@ public:
 	UFUNCTION(BlueprintCallable)
 	void RemoveAllParameterProviders();	
 
+	/**
+	 * Begin a batch of changes, for when you want to make many changes at once. Until the matching EndBatch call,
+	 * changes to tasks are applied but their effect on objectives and quests is deferred, and events are queued.
+	 * When the outermost batch ends, objectives and quests are updated once and a single consolidated set of events
+	 * is raised, with duplicates removed.
+	 * Batches can be nested. In C++ you can use FSuqsBatchScope to make sure EndBatch is called.
+	 * Note that because objective and quest status isn't updated until the batch ends, you can't (for example)
+	 * complete tasks on an objective which only becomes current because of other changes in the same batch.
+	 */
+	UFUNCTION(BlueprintCallable)
+	void BeginBatch();
+	/// End a batch of changes started with BeginBatch, see BeginBatch
+	UFUNCTION(BlueprintCallable)
+	void EndBatch();
+	/// Return whether a batch of changes is in progress, see BeginBatch
+	UFUNCTION(BlueprintCallable, BlueprintPure)
+	bool IsInBatch() const { return BatchDepth > 0; }
+
+	/**
+	 * Set whether events are raised immediately (the default), or queued and raised together once per Tick.
+	 * Deferring events reduces the number raised by frequent changes, such as task time limits counting down,
+	 * because queued events of the types set by SetEventTypeCoalesced are combined so only the latest of each
+	 * identical event is raised. Quest state is still always updated immediately, only events are deferred.
+	 */
+	UFUNCTION(BlueprintCallable)
+	void SetDeferEvents(bool bDefer);
+	/// Return whether events are being queued and raised once per Tick, see SetDeferEvents
+	UFUNCTION(BlueprintCallable, BlueprintPure)
+	bool GetDeferEvents() const { return bDeferEvents; }
+	/**
+	 * Set whether queued events of a given type may be combined, when events are deferred or in a batch.
+	 * By default ActiveQuestsChanged, QuestCurrentObjectiveChanged, TaskAdded, TaskUpdated, TaskRemoved and the
+	 * waypoint events are combined; status changes such as completion / failure are always raised individually.
+	 */
+	UFUNCTION(BlueprintCallable)
+	void SetEventTypeCoalesced(ESuqsProgressionEventType EventType, bool bCoalesce);
+	/// Return whether queued events of a given type may be combined, see SetEventTypeCoalesced
+	UFUNCTION(BlueprintCallable, BlueprintPure)
+	bool IsEventTypeCoalesced(ESuqsProgressionEventType EventType) const { return (CoalescedEventTypes & EventTypeBit(EventType)) != 0; }
 
-	void RaiseTaskUpdated(USuqsTaskState* Task);
-	void RaiseTaskFailed(USuqsTaskState* Task);
-	void RaiseTaskCompleted(USuqsTaskState* Task);
-	void RaiseTaskAdded(USuqsTaskState* Task);
-	void RaiseTaskRemoved(USuqsTaskState* Task);
+
+	void RaiseTaskUpdated(USuqsObjectiveState* Objective, int TaskIndex);
+	void RaiseTaskFailed(USuqsObjectiveState* Objective, int TaskIndex);
+	void RaiseTaskCompleted(USuqsObjectiveState* Objective, int TaskIndex);
+	void RaiseTaskAdded(USuqsObjectiveState* Objective, int TaskIndex);
+	void RaiseTaskRemoved(USuqsObjectiveState* Objective, int TaskIndex);
 	void RaiseObjectiveCompleted(USuqsObjectiveState* Objective);
 	void RaiseObjectiveFailed(USuqsObjectiveState* Objective);
 	void RaiseQuestCompleted(USuqsQuestState* Quest);
@@ -595,7 +1059,30 @@ public:
 	
 	void ProcessQuestStatusChange(USuqsQuestState* Quest);
 
-	const FSuqsQuest* GetQuestDefinition(const FName& QuestID);
+	/// If in a batch, defer processing of task changes on an objective until the batch ends
+	/// @returns Whether processing was deferred, if not the caller should process it immediately
+	bool DeferObjectiveUpdate(USuqsObjectiveState* Objective);
+	/// If in a batch, defer processing of objective changes on a quest until the batch ends
+	/// @returns Whether processing was deferred, if not the caller should process it immediately
+	bool DeferQuestUpdate(USuqsQuestState* Quest);
+	/// Process any deferred updates for objectives in a quest, because the quest is about to re-scan them
+	/// @returns Whether there were any deferred updates for the quest or its objectives
+	bool ProcessDeferredObjectiveUpdates(USuqsQuestState* Quest);
+
+	const FSuqsQuest* GetQuestDefinition(const FName& QuestID) const;
+
+	/// Let progression know that a quest may have started a timer and so needs ticking
+	void ScheduleTick(USuqsQuestState* Quest);
+	/// Let progression know that a task may have started a timer and so needs ticking
+	void ScheduleTick(USuqsObjectiveState* Objective, int TaskIndex);
+	/// Let progression know that a quest's resolve barrier may be waiting on a gate
+	void WaitForGate(USuqsQuestState* Quest);
+	/// Let progression know that a task's resolve barrier may be waiting on a gate
+	void WaitForGate(USuqsObjectiveState* Objective, int TaskIndex);
+
+	/// The state of every task in the quest states of this progression, see FSuqsTaskStateStore
+	FSuqsTaskStateStore& GetTaskStateStore() { return TaskStates; }
+	const FSuqsTaskStateStore& GetTaskStateStore() const { return TaskStates; }
 
 	/// Given a task definition and status, return progression barrier information
 	FSuqsResolveBarrier GetResolveBarrierForTask(const FSuqsTask* Task, ESuqsTaskStatus Status) const;
@@ -612,6 +1099,7 @@ public:
 
 	// FTickableGameObject begin
 	virtual void Tick(float DeltaTime) override;
+	virtual bool IsTickable() const override;
 	virtual TStatId GetStatId() const override;
 	// FTickableGameObject end
 
@@ -634,3 +1122,26 @@ public:
 	/// Determine if some text needs formatting (has parameters)
 	static bool GetTextNeedsFormatting(const FText& Text);
 };
+
+/// Scoped batch of progression changes, calls BeginBatch / EndBatch on construction / destruction. See USuqsProgression::BeginBatch
+struct FSuqsBatchScope
+{
+	explicit FSuqsBatchScope(USuqsProgression* InProgression)
+		: Progression(InProgression)
+	{
+		if (Progression.IsValid())
+			Progression->BeginBatch();
+	}
+
+	~FSuqsBatchScope()
+	{
+		if (Progression.IsValid())
+			Progression->EndBatch();
+	}
+
+	FSuqsBatchScope(const FSuqsBatchScope&) = delete;
+	FSuqsBatchScope& operator=(const FSuqsBatchScope&) = delete;
+
+private:
+	TWeakObjectPtr<USuqsProgression> Progression;
+};
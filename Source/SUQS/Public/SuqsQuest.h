@@ -213,9 +213,41 @@ public:
 	FName ResolveGate;
 	
 	/// List of objectives involved in the quest. They are all sequential, and mandatory, but may be hidden to provide some branching
+	/// Empty for quest instances (see USuqsProgression::CreateQuestInstance), which share their template's objectives;
+	/// use USuqsProgression::GetQuestObjectives / GetQuestDefinitionObjectives to read them
 	UPROPERTY(EditDefaultsOnly, BlueprintReadWrite, Category="Quest")
 	TArray<FSuqsObjective> Objectives;
 
 	/// Attempt to get an objective by its identifier
 	const FSuqsObjective* FindObjective(const FName& Identifier) const;
 };
+
+/// Per-instance overrides for a quest created from a template with USuqsProgression::CreateQuestInstance
+/// Instances share the objectives & tasks of the template, so are cheap to create in large numbers
+USTRUCT(BlueprintType)
+struct SUQS_API FSuqsQuestInstance
+{
+	GENERATED_BODY()
+
+public:
+	/// The unique Identifier of the quest instance, mandatory
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Quest Instance")
+	FName Identifier;
+
+	/// Target numbers of tasks to override, by task identifier
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Quest Instance")
+	TMap<FName, int> TaskTargetNumbers;
+
+	/// Named parameters to substitute into the quest & task text for this instance. Parameter providers are
+	/// called afterwards so can still override these
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Quest Instance")
+	TMap<FString, FText> Parameters;
+
+	/// Whether to use DefaultActiveBranches below instead of those from the template
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Quest Instance")
+	bool bOverrideDefaultActiveBranches = false;
+
+	/// Quest branches which are active by default, if bOverrideDefaultActiveBranches is true
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Quest Instance")
+	TArray<FName> DefaultActiveBranches;
+};
@@ -0,0 +1,44 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "SuqsQuest.h"
+
+/**
+ * Storage for quest definitions owned by a USuqsProgression (those not referenced in place from datatables).
+ * Quests are stored in fixed size chunks which never move once allocated, so the address of a quest is stable for
+ * as long as it's in the arena, and quest / objective / task states can safely point at it. Adding a quest is O(1)
+ * and never invalidates other quests. Slots freed by removal are reused. The slot of each quest is recorded, so
+ * Contains / Remove are O(1) too.
+ */
+class SUQS_API FSuqsQuestArena
+{
+public:
+	static constexpr int32 ChunkSize = 256;
+
+	/// Move a quest into the arena, returning its stable address
+	FSuqsQuest* Add(FSuqsQuest&& Quest);
+	/// Remove a quest from the arena. Has no effect if the quest isn't owned by this arena
+	/// @returns Whether the quest was removed
+	bool Remove(const FSuqsQuest* Quest);
+	/// Return whether a quest is stored in this arena
+	bool Contains(const FSuqsQuest* Quest) const;
+	/// Get a mutable pointer to a quest stored in this arena, or null if it isn't owned by this arena
+	FSuqsQuest* FindMutable(const FSuqsQuest* Quest);
+	/// Make sure there's room for at least this many more quests without allocating
+	void Reserve(int32 NumExtra);
+	/// Remove all quests and release memory
+	void Empty();
+
+	int32 Num() const { return SlotIndexes.Num(); }
+
+protected:
+	TArray<TUniquePtr<FSuqsQuest[]>> Chunks;
+	/// Slots handed out so far, across all chunks, including those now free
+	int32 NumUsedSlots = 0;
+	/// Indexes of slots freed by removal
+	TArray<int32> FreeSlots;
+	/// Slot index of every quest currently in the arena
+	TMap<const FSuqsQuest*, int32> SlotIndexes;
+
+	FSuqsQuest* GetSlot(int32 SlotIndex) const { return &Chunks[SlotIndex / ChunkSize][SlotIndex % ChunkSize]; }
+};
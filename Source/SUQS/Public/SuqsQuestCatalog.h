@@ -0,0 +1,26 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+struct FSuqsQuest;
+
+/**
+ * A compiled quest catalog is a flat, versioned binary form of quest definitions, which can be loaded without going
+ * through JSON or DataTable import. Names and texts are stored once each in tables, and quests, objectives and tasks
+ * are fixed-size records which refer to those tables (and each other) by index, so loading is a handful of bulk reads.
+ * Dependencies between quests are stored as name references like all other name lists.
+ *
+ * Create one from existing definitions with USuqsProgression::WriteQuestCatalog (e.g. in a build step), and load it
+ * with USuqsProgression::InitWithQuestCatalog.
+ * Records are stored in native (little-endian) byte order.
+ */
+class SUQS_API FSuqsQuestCatalog
+{
+public:
+	/// Write quest definitions to catalog data
+	static void Write(const TArray<const FSuqsQuest*>& Quests, TArray<uint8>& OutData);
+
+	/// Read quest definitions from catalog data
+	/// @returns False if the data isn't a valid catalog of the current version
+	static bool Read(const TArray<uint8>& Data, TArray<FSuqsQuest>& OutQuests);
+};
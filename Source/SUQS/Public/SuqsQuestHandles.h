@@ -0,0 +1,118 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * Handles are dense integer identifiers assigned to quest, objective and task definitions when they're added to a
+ * USuqsProgression. Native code can resolve names to handles once and then use the handle overloads on
+ * USuqsProgression, which index arrays directly instead of looking up names.
+ * Handles are only valid for the progression which issued them, and only until its quest data is rebuilt.
+ * Indexes freed by deleted definitions are re-used, so handles also carry the generation of their slot; a handle to
+ * a deleted definition stops resolving rather than resolving to whatever took its place.
+ */
+struct SUQS_API FSuqsQuestHandle
+{
+	int32 Index = INDEX_NONE;
+	uint32 Generation = 0;
+
+	FSuqsQuestHandle() {}
+	explicit FSuqsQuestHandle(int32 InIndex, uint32 InGeneration = 0) : Index(InIndex), Generation(InGeneration) {}
+
+	bool IsValid() const { return Index != INDEX_NONE; }
+
+	friend bool operator==(const FSuqsQuestHandle& A, const FSuqsQuestHandle& B) { return A.Index == B.Index && A.Generation == B.Generation; }
+	friend bool operator!=(const FSuqsQuestHandle& A, const FSuqsQuestHandle& B) { return !(A == B); }
+	friend uint32 GetTypeHash(const FSuqsQuestHandle& H) { return HashCombine(::GetTypeHash(H.Index), ::GetTypeHash(H.Generation)); }
+};
+
+/// Handle to an objective; objectives aren't unique across quests so this is the quest handle plus the objective index
+struct SUQS_API FSuqsObjectiveHandle
+{
+	FSuqsQuestHandle Quest;
+	int32 ObjectiveIndex = INDEX_NONE;
+
+	FSuqsObjectiveHandle() {}
+	FSuqsObjectiveHandle(FSuqsQuestHandle InQuest, int32 InObjectiveIndex) : Quest(InQuest), ObjectiveIndex(InObjectiveIndex) {}
+
+	bool IsValid() const { return Quest.IsValid() && ObjectiveIndex != INDEX_NONE; }
+
+	friend bool operator==(const FSuqsObjectiveHandle& A, const FSuqsObjectiveHandle& B) { return A.Quest == B.Quest && A.ObjectiveIndex == B.ObjectiveIndex; }
+	friend bool operator!=(const FSuqsObjectiveHandle& A, const FSuqsObjectiveHandle& B) { return !(A == B); }
+	friend uint32 GetTypeHash(const FSuqsObjectiveHandle& H) { return HashCombine(GetTypeHash(H.Quest), ::GetTypeHash(H.ObjectiveIndex)); }
+};
+
+/// Handle to a task, dense across all quests in a progression
+/// Task handles change whenever their quest is recompiled, so the generation is bumped then as well as on deletion
+struct SUQS_API FSuqsTaskHandle
+{
+	int32 Index = INDEX_NONE;
+	uint32 Generation = 0;
+
+	FSuqsTaskHandle() {}
+	explicit FSuqsTaskHandle(int32 InIndex, uint32 InGeneration = 0) : Index(InIndex), Generation(InGeneration) {}
+
+	bool IsValid() const { return Index != INDEX_NONE; }
+
+	friend bool operator==(const FSuqsTaskHandle& A, const FSuqsTaskHandle& B) { return A.Index == B.Index && A.Generation == B.Generation; }
+	friend bool operator!=(const FSuqsTaskHandle& A, const FSuqsTaskHandle& B) { return !(A == B); }
+	friend uint32 GetTypeHash(const FSuqsTaskHandle& H) { return HashCombine(::GetTypeHash(H.Index), ::GetTypeHash(H.Generation)); }
+};
+
+/// Compiled information about a quest definition, indexed by quest handle
+struct SUQS_API FSuqsCompiledQuest
+{
+	/// Quest identifier, None if the definition has since been deleted
+	FName Identifier;
+	/// Range of task handles belonging to this quest, in objective / task order
+	int32 FirstTask = 0;
+	int32 NumTasks = 0;
+	int32 NumObjectives = 0;
+	/// Identifier of each objective, so the structure can be checked against a reloaded definition
+	TArray<FName> ObjectiveIdentifiers;
+	/// Task identifier to task handle index
+	TMap<FName, int32> TaskLookup;
+	/// Branches used by objectives in this quest, to the index of the bit representing them in quest state
+	TMap<FName, int32> BranchLookup;
+	/// Branch bit index of each objective, INDEX_NONE if the objective isn't on a branch
+	TArray<int32> ObjectiveBranches;
+	/// Number of mandatory tasks needed to complete each objective
+	TArray<int32> ObjectiveMandatoryTasksNeeded;
+	/// Whether quest texts contain parameters, so need formatting
+	bool bTitleNeedsFormatting = false;
+	bool bActiveDescriptionNeedsFormatting = false;
+	bool bCompletedDescriptionNeedsFormatting = false;
+	/// Whether this quest is accepted automatically once its prerequisites are met
+	bool bAutoAccept = false;
+	/// Total number of prerequisite quest completions / failures
+	int32 NumPrerequisites = 0;
+	/// Prerequisite quests, kept here so that dependencies can be unlinked without the definition
+	TArray<FName> PrerequisiteQuests;
+	TArray<FName> PrerequisiteQuestFailures;
+	/// Handle indexes of quests which have this quest's completion as a prerequisite
+	TArray<int32> DependentsOnCompletion;
+	/// Handle indexes of quests which have this quest's failure as a prerequisite
+	TArray<int32> DependentsOnFailure;
+
+	/// Hash of the whole definition, used to detect changes when quest data is reloaded
+	uint32 DefinitionHash = 0;
+	/// Generation of this quest handle slot, bumped when the definition is deleted so old handles stop resolving
+	uint32 Generation = 0;
+
+	bool IsValid() const { return !Identifier.IsNone(); }
+};
+
+/// Compiled information about a task definition, indexed by task handle
+struct SUQS_API FSuqsCompiledTask
+{
+	FName Identifier;
+	int32 QuestIndex = INDEX_NONE;
+	int32 ObjectiveIndex = INDEX_NONE;
+	/// Index of the task within its objective
+	int32 TaskIndex = INDEX_NONE;
+	/// Whether the task title contains parameters, so needs formatting
+	bool bTitleNeedsFormatting = false;
+	/// Whether the task is hidden once completed / failed, see USuqsTaskState::IsHiddenOnCompleteOrFail
+	bool bHiddenOnCompleteOrFail = false;
+	/// Generation of this task handle slot, bumped when its quest is recompiled or deleted
+	uint32 Generation = 0;
+};
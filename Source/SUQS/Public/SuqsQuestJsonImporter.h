@@ -0,0 +1,23 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+struct FSuqsQuest;
+
+/**
+ * Streaming importer for quest definitions in JSON (as described by docs/questschema.json). The JSON is read token
+ * by token straight into FSuqsQuest structures, without building a DOM or going via a DataTable, so it's suitable for
+ * very large quest exports from external tools. Unknown properties are ignored, as with DataTable import.
+ */
+class SUQS_API FSuqsQuestJsonImporter
+{
+public:
+	/**
+	 * Import quest definitions from a JSON string
+	 * @param JsonString JSON text, an array of quest objects
+	 * @param OutQuests The quests which were read
+	 * @param OutError If the import fails, a description of the problem including line & column
+	 * @return Whether the import was successful
+	 */
+	static bool Import(const FString& JsonString, TArray<FSuqsQuest>& OutQuests, FString& OutError);
+};
@@ -3,6 +3,7 @@
 #include "CoreMinimal.h"
 
 #include "SuqsQuest.h"
+#include "SuqsQuestHandles.h"
 #include "SuqsSaveData.h"
 #include "UObject/Object.h"
 
@@ -137,6 +138,9 @@ protected:
 	/// List of active branches, which affects which objectives will be considered
 	UPROPERTY(BlueprintReadOnly, Category="Quest Status")
 	TArray<FName> ActiveBranches;
+	/// Whether each branch used by our objectives is active, indexed by FSuqsCompiledQuest::BranchLookup
+	/// ActiveBranches may also contain branches no objective uses, which can't affect anything
+	TBitArray<> ActiveBranchBits;
 
 	/// The index of the current objective. -1 if quest completed
 	UPROPERTY(BlueprintReadOnly, Category="Quest Status")
@@ -146,14 +150,19 @@ protected:
 	UPROPERTY(BlueprintReadOnly, Category="Quest Status")
 	FSuqsResolveBarrier ResolveBarrier;
 
-	UPROPERTY()
-	TMap<FName, USuqsTaskState*> FastTaskLookup;
-
 	// Pointer to quest definition, for convenience (this is static data)
 	const FSuqsQuest* QuestDefinition;
+	/// Handle to the compiled definition in progression
+	FSuqsQuestHandle Handle;
+	/// Index of our first task in the progression's compiled tasks when we were initialised, -1 if not compiled
+	int32 FirstCompiledTask = -1;
+	/// Generation of that first task handle, since task ranges are re-used when quests are recompiled
+	uint32 FirstCompiledTaskGeneration = 0;
 	TWeakObjectPtr<USuqsProgression> Progression;
 
 	bool bSuppressObjectiveChangeEvent = false;
+	/// Whether the objectives before the current one mean the quest has failed, so re-scans can start at the current one
+	bool bPreviousObjectivesFailQuest = false;
 
 	// Whether we need to format the text is calculated at startup
 	bool bTitleNeedsFormatting;
@@ -164,11 +173,19 @@ protected:
 	bool bIsLoading = false;
 
 	void Initialise(const FSuqsQuest* Def, USuqsProgression* Root);
+	/// Point this state at an identical definition which has moved, e.g. because its datatable was reimported
+	void RebindDefinition(const FSuqsQuest* Def);
 	void Tick(float DeltaTime);
 	void ChangeStatus(ESuqsQuestStatus NewStatus);
 	void QueueStatusChangeNotification();
 	bool IsResolveBlockedOn(ESuqsResolveBarrierCondition Barrier) const;
 	void MaybeNotifyStatusChange();
+	void ScheduleCurrentObjectiveTick();
+	const FSuqsCompiledQuest* GetCompiledDefinition() const;
+	/// Whether we were initialised from the current compiled definition, rather than one since deleted or recompiled
+	bool IsCompiledDefinitionCurrent() const;
+	int32 GetBranchIndex(const FName& Branch) const;
+	void UpdateActiveBranchBits();
 
 	bool TitleNeedsFormatting() const;
 	bool DescriptionNeedsFormatting() const;
@@ -213,6 +230,11 @@ public:
 	UFUNCTION(BlueprintCallable)
     bool IsBranchActive(FName Branch);
 
+	/// Return whether any objectives in this quest are on a given branch
+	bool UsesBranch(const FName& Branch) const { return GetBranchIndex(Branch) != INDEX_NONE; }
+	/// Return whether an objective in this quest is on an active branch (or no branch)
+	bool IsObjectiveOnActiveBranch(const USuqsObjectiveState* Objective) const;
+
 	/**
 	 * Fully complete a task. If this is the last mandatory task in an objective, also completes the objective, and
 	 * cascades upwards to the quest if that's the last mandatory objective.
@@ -358,8 +380,11 @@ public:
 	/// Find a task with the given identifier in this quest
 	UFUNCTION(BlueprintCallable)
 	USuqsTaskState* GetTask(const FName& TaskID) const;
+	/// Find a task with the given identifier in this quest, without needing its USuqsTaskState
+	/// @returns Whether the task was found
+	bool FindTask(const FName& TaskID, USuqsObjectiveState*& OutObjective, int& OutTaskIndex) const;
 
-	void NotifyObjectiveStatusChanged();
+	void NotifyObjectiveStatusChanged(const USuqsObjectiveState* ChangedObjectiveOrNull = nullptr);
 
 	void OverrideStatus(ESuqsQuestStatus OverrideStatus);
 	void NotifyGateOpened(const FName& GateName);
@@ -369,4 +394,6 @@ public:
 	void StartLoad();
 	void FinishLoad();
 	bool IsLoading() const { return bIsLoading; }
+	/// Whether this quest has a timer running which needs it to be ticked
+	bool IsTickRequired() const;
 };
@@ -7,6 +7,7 @@
 #include "SuqsTaskState.generated.h"
 
 class USuqsWaypointComponent;
+class USuqsWaypointSubsystem;
 UENUM(BlueprintType)
 enum class ESuqsTaskStatus : uint8
 {
@@ -20,9 +21,10 @@ enum class ESuqsTaskStatus : uint8
     Failed = 20
 };
 
-
 /**
- * Record of the state of a task in a quest objective
+ * Record of the state of a task in a quest objective.
+ * These are only created when something asks for them (see USuqsObjectiveState::GetTask); the state itself is
+ * held by the progression in a FSuqsTaskStateStore, so this is a view onto the objective's task.
  */
 UCLASS(BlueprintType)
 class SUQS_API USuqsTaskState : public UObject
@@ -30,49 +32,64 @@ class SUQS_API USuqsTaskState : public UObject
 	GENERATED_BODY()
 
 	friend class USuqsObjectiveState;
+	friend class USuqsProgression;
 protected:
-	/// Current number (vs target number)
-	UPROPERTY(BlueprintReadOnly, Category="Task State")
-	int Number;
+	const FSuqsTask* TaskDefinition;
+	/// Held strongly, so that the objective state (and with it, the state of this task) lasts as long as this does
+	UPROPERTY()
+	USuqsObjectiveState* ParentObjective;
+	TWeakObjectPtr<USuqsProgression> Progression;
+	/// Index of this task in the parent objective
+	int TaskIndex = -1;
+
+	bool bTitleNeedsFormatting;
+
+	/// All waypoints for this task, cached from the waypoint subsystem. Held weakly since they belong to the level
+	TArray<TWeakObjectPtr<USuqsWaypointComponent>> CachedWaypoints;
+	/// Subsystem CachedWaypoints came from, and its generation for this task then; out of date once either changes
+	TWeakObjectPtr<USuqsWaypointSubsystem> CachedWaypointSubsystem;
+	uint32 CachedWaypointsGeneration = 0;
+	bool bWaypointsCached = false;
+
+	// Blueprint-visible properties, kept so existing Blueprints still find them. Reads go through the getters below
+	// to the objective's task in the store; the fields themselves are never written, so don't read them from C++
+
+	/// Current number (vs target number of quest)
+	UPROPERTY(Transient, BlueprintGetter=GetNumber, Category="Task State")
+	int Number = 0;
 	/// Current time remaining, if task has a time limit
-	UPROPERTY(BlueprintReadOnly, Category="Task State")
+	UPROPERTY(Transient, BlueprintGetter=GetTimeRemaining, Category="Task State")
 	float TimeRemaining = 0;
 	/// Whether this task has been started, completed, failed
-	UPROPERTY(BlueprintReadOnly, Category="Task State")
+	UPROPERTY(Transient, BlueprintGetter=GetStatus, Category="Task State")
 	ESuqsTaskStatus Status = ESuqsTaskStatus::NotStarted;
-	/// Whether we suggest that this task is hidden from the player right now
-	/// This is the case for mandatory, sequential, incomplete tasks beyond the first one
-	UPROPERTY(BlueprintReadOnly, Category="Task State")
-	bool bHidden;
-
-
+	/// Whether this task should be hidden, e.g. because tasks are sequential in this objective
+	UPROPERTY(Transient, BlueprintGetter=GetHidden, Category="Task State")
+	bool bHidden = false;
 	/// A barrier is set when status changes but parent hasn't been notified yet
-	UPROPERTY(BlueprintReadOnly, Category="Task State")
+	UPROPERTY(Transient, BlueprintGetter=GetResolveBarrier, Category="Task State")
 	FSuqsResolveBarrier ResolveBarrier;
 	
-	const FSuqsTask* TaskDefinition;
-	TWeakObjectPtr<USuqsObjectiveState> ParentObjective;
-	TWeakObjectPtr<USuqsProgression> Progression;
-
-	bool bTitleNeedsFormatting;
-	
-	void Initialise(const FSuqsTask* TaskDef, USuqsObjectiveState* ObjState, USuqsProgression* Root);
-	void Tick(float DeltaTime);
-	void ChangeStatus(ESuqsTaskStatus NewStatus, bool bIgnoreResolveBarriers = false);
-	void QueueParentStatusChangeNotification(bool bIgnoreBarriers);
-	bool IsResolveBlockedOn(ESuqsResolveBarrierCondition Barrier) const;
-	void MaybeNotifyParentStatusChange();
+	void Initialise(const FSuqsTask* TaskDef, const FSuqsCompiledTask* CompiledTask, USuqsObjectiveState* ObjState, USuqsProgression* Root);
+	/// Stop viewing the objective's task, because the objective has been re-initialised with different tasks
+	void Detach();
 public:
-	// expose BP properties for C++ 
-	
 	/// Current number (vs target number of quest)
-	int GetNumber() const { return Number; }
+	UFUNCTION(BlueprintGetter)
+	int GetNumber() const;
 	/// Current time remaining, if task has a time limit
-	float GetTimeRemaining() const { return TimeRemaining; }
-	ESuqsTaskStatus GetStatus() const {  return Status; }
+	UFUNCTION(BlueprintGetter)
+	float GetTimeRemaining() const;
+	/// Whether this task has been started, completed, failed
+	UFUNCTION(BlueprintGetter)
+	ESuqsTaskStatus GetStatus() const;
 	/// Return whether this task should be hidden, e.g. because tasks are sequential in this objective
-	bool GetHidden() const { return bHidden; }
-	const FSuqsResolveBarrier& GetResolveBarrier() const { return ResolveBarrier; }
+	/// This is the case for mandatory, sequential, incomplete tasks beyond the first one
+	UFUNCTION(BlueprintGetter)
+	bool GetHidden() const;
+	/// A barrier is set when status changes but parent hasn't been notified yet
+	UFUNCTION(BlueprintGetter)
+	FSuqsResolveBarrier GetResolveBarrier() const;
 
 	UFUNCTION(BlueprintCallable, BlueprintPure)
     const FName& GetIdentifier() const { return TaskDefinition->Identifier; }
@@ -86,13 +103,13 @@ public:
 	FText GetTitle() const;
 	/// The target number of things to be achieved
 	UFUNCTION(BlueprintCallable, BlueprintPure)
-	int GetTargetNumber() const { return TaskDefinition->TargetNumber; }
+	int GetTargetNumber() const;
 	/// Return whether or not this task has a number of things to achieve rather than just 1 discrete completion
 	UFUNCTION(BlueprintCallable, BlueprintPure)
 	bool HasTargetNumber() const { return GetTargetNumber() > 1; }
 
 	UFUNCTION(BlueprintCallable, BlueprintPure)
-	USuqsObjectiveState* GetParentObjective() const { return ParentObjective.Get(); }
+	USuqsObjectiveState* GetParentObjective() const { return ParentObjective; }
 
 	UFUNCTION(BlueprintCallable, BlueprintPure)
 	USuqsProgression* GetRootProgression() const { return Progression.Get(); }
@@ -142,15 +159,15 @@ public:
 
 	/// Return whether a task is neither complete nor failed 
 	UFUNCTION(BlueprintCallable, BlueprintPure)
-    bool IsIncomplete() const { return Status != ESuqsTaskStatus::Completed && Status != ESuqsTaskStatus::Failed; }
+    bool IsIncomplete() const { return !IsCompleted() && !IsFailed(); }
 
 	/// Return whether a task is completed 
 	UFUNCTION(BlueprintCallable, BlueprintPure)
-    bool IsCompleted() const { return Status == ESuqsTaskStatus::Completed; }
+    bool IsCompleted() const { return GetStatus() == ESuqsTaskStatus::Completed; }
 
 	/// Return whether a task is failed 
 	UFUNCTION(BlueprintCallable, BlueprintPure)
-    bool IsFailed() const { return Status == ESuqsTaskStatus::Failed; }
+    bool IsFailed() const { return GetStatus() == ESuqsTaskStatus::Failed; }
 
 	/// Return whether this task is "relevant" i.e. it's on the current objective, incomplete and next in line
 	UFUNCTION(BlueprintCallable, BlueprintPure)
@@ -164,7 +181,6 @@ public:
 	UFUNCTION(BlueprintCallable)
 	bool IsResolveBlocked() const;
 	
-	void NotifyGateOpened(const FName& GateName);
 	/**
 	 * Return whether this task will become hidden on completion/failure or not. Reasons not to are that it's optional
 	 * or the tasks are non-sequential, so stick around until the objective is completed/failed
@@ -184,5 +200,11 @@ public:
 	 */
 	UFUNCTION(BlueprintCallable)
 	TArray<USuqsWaypointComponent*> GetWaypoints(bool bOnlyEnabled = true);
-	void FinishLoad();
+	/// Iterate the waypoints GetWaypoints would return, without building an array. Like GetAllWaypoints, this is
+	/// only valid until waypoints are next registered or unregistered. Waypoints which no longer exist are skipped
+	TSuqsFilteredRange<const TWeakObjectPtr<USuqsWaypointComponent>> GetWaypointsRange(bool bOnlyEnabled = true);
+
+	/// Get all waypoints for this task, enabled or not, from a cache. The array is only valid until
+	/// waypoints are next registered or unregistered, so don't hold on to it
+	const TArray<TWeakObjectPtr<USuqsWaypointComponent>>& GetAllWaypoints();
 };
@@ -0,0 +1,42 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "SuqsTaskState.h"
+
+/**
+ * The mutable state of every live task state in a USuqsProgression, held as parallel arrays rather than in one
+ * UObject per task, so that accepted quests don't need a USuqsTaskState for each of their tasks.
+ * Each task of each objective state has its own slot, allocated when the objective state is initialised and released
+ * when it's destroyed. Slots aren't tied to compiled task handles, so separate states of the same quest never share
+ * one. Slots freed by release are reused before the arrays grow.
+ */
+class SUQS_API FSuqsTaskStateStore
+{
+public:
+	/// Current number (vs TargetNumber)
+	TArray<int> Number;
+	/// Target number, from the definition unless overridden by a quest instance
+	TArray<int> TargetNumber;
+	/// Time remaining, if the task has a time limit
+	TArray<float> TimeRemaining;
+	TArray<ESuqsTaskStatus> Status;
+	/// Whether we suggest that the task is hidden from the player right now, see USuqsTaskState::GetHidden
+	TBitArray<> Hidden;
+	/// A barrier is set when status changes but the parent objective hasn't been notified yet
+	TArray<FSuqsResolveBarrier> ResolveBarrier;
+
+	/// Allocate a slot, in the initial state
+	int32 Allocate();
+	/// Release a slot for reuse
+	void Release(int32 Slot);
+	/// Return a slot to the initial state
+	void ResetSlot(int32 Slot);
+	/// Number of slots currently allocated
+	int32 Num() const { return Number.Num() - FreeSlots.Num(); }
+	/// Memory held by the store
+	SIZE_T GetAllocatedSize() const;
+
+protected:
+	/// Indexes of slots freed by release
+	TArray<int32> FreeSlots;
+};
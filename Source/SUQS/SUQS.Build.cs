@@ -32,6 +32,8 @@ public class SUQS : ModuleRules
 		PrivateDependencyModuleNames.AddRange(
 			new string[]
 			{
+				"AssetRegistry",
+				"Json"
 			}
 			);
 		
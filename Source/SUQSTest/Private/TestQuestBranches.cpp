@@ -531,5 +531,114 @@ bool FTestQuestDefaultBranches::RunTest(const FString& Parameters)
 	}
 	
 	
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FTestQuestGlobalBranchChanges, "SUQSTest.QuestGlobalBranchChanges",
+                                 EAutomationTestFlags::EditorContext |
+                                 EAutomationTestFlags::ClientContext |
+                                 EAutomationTestFlags::ProductFilter)
+
+bool FTestQuestGlobalBranchChanges::RunTest(const FString& Parameters)
+{
+	const TArray<UDataTable*> QuestTables {
+		USuqsProgression::MakeQuestDataTableFromJSON(BranchingQuestJson),
+		USuqsProgression::MakeQuestDataTableFromJSON(BranchingQuest2Json)
+	};
+	USuqsProgression* Progression = NewObject<USuqsProgression>();
+	Progression->InitWithQuestDataTables(QuestTables);
+
+	TArray<USuqsObjectiveState*> ActiveObjectives;
+
+	// Flip global branches before any quest which uses them is accepted
+	Progression->SetGlobalQuestBranchActive("BranchA", true);
+	Progression->SetGlobalQuestBranchActive("BranchA", false);
+	Progression->SetGlobalQuestBranchActive("BranchB", true);
+
+	TestTrue("Accept quest OK", Progression->AcceptQuest("Q_Branching3"));
+	auto Q3 = Progression->GetQuest("Q_Branching3");
+	Q3->GetActiveObjectives(ActiveObjectives);
+	TestEqual("Q3 should only have BranchB objectives", ActiveObjectives.Num(), 2);
+	TestEqual("BranchB should be second objective", ActiveObjectives[1]->GetIdentifier(), FName("O_BranchB_Q3"));
+	TestFalse("BranchA should not be active on Q3", Q3->IsBranchActive("BranchA"));
+	TestTrue("BranchB should be active on Q3", Q3->IsBranchActive("BranchB"));
+
+	TestTrue("Accept quest OK", Progression->AcceptQuest("Q_Branching"));
+	auto Q1 = Progression->GetQuest("Q_Branching");
+	Q1->GetActiveObjectives(ActiveObjectives);
+	TestEqual("Q1 should have BranchB objectives", ActiveObjectives.Num(), 4);
+	TestEqual("BranchB should be second objective", ActiveObjectives[1]->GetIdentifier(), FName("O_BranchB_1"));
+
+	// Branches which no objective in the quest uses
+	TestFalse("Unused branch which was never set should not be active", Q3->IsBranchActive("BranchUnused"));
+	Progression->SetGlobalQuestBranchActive("BranchUnused", true);
+	TestTrue("Unused global branch should still be active on the quest", Q3->IsBranchActive("BranchUnused"));
+	Q3->GetActiveObjectives(ActiveObjectives);
+	TestEqual("Unused branch should not change objectives", ActiveObjectives.Num(), 2);
+	Progression->SetGlobalQuestBranchActive("BranchUnused", false);
+	TestFalse("Unused global branch should be inactive again", Q3->IsBranchActive("BranchUnused"));
+	Q3->SetBranchActive("BranchLocalUnused", true);
+	TestTrue("Unused quest branch should be active", Q3->IsBranchActive("BranchLocalUnused"));
+	TestTrue("Unused quest branch should be remembered", Q3->GetActiveBranches().Contains(FName("BranchLocalUnused")));
+	Q3->GetActiveObjectives(ActiveObjectives);
+	TestEqual("Unused branch should not change objectives", ActiveObjectives.Num(), 2);
+
+	// Round trip through saved data
+	FSuqsSaveData Data;
+	Progression->SaveToData(Data);
+
+	USuqsProgression* Loaded = NewObject<USuqsProgression>();
+	Loaded->InitWithQuestDataTables(QuestTables);
+	Loaded->LoadFromData(Data);
+
+	TestFalse("BranchA should not be active after load", Loaded->IsGlobalQuestBranchActive("BranchA"));
+	TestTrue("BranchB should be active after load", Loaded->IsGlobalQuestBranchActive("BranchB"));
+	auto LQ3 = Loaded->GetQuest("Q_Branching3");
+	if (!LQ3)
+	{
+		AddError("Q_Branching3 should be loaded");
+		return false;
+	}
+	LQ3->GetActiveObjectives(ActiveObjectives);
+	TestEqual("Loaded Q3 should have BranchB objectives", ActiveObjectives.Num(), 2);
+	TestEqual("BranchB should be second objective", ActiveObjectives[1]->GetIdentifier(), FName("O_BranchB_Q3"));
+	TestTrue("Unused quest branch should be loaded", LQ3->IsBranchActive("BranchLocalUnused"));
+
+	// Global changes should still reach loaded quests, and quests accepted after loading
+	Loaded->SetGlobalQuestBranchActive("BranchB", false);
+	LQ3->GetActiveObjectives(ActiveObjectives);
+	TestEqual("Loaded Q3 should be back to main branch", ActiveObjectives.Num(), 1);
+	Loaded->SetGlobalQuestBranchActive("BranchA", true);
+	LQ3->GetActiveObjectives(ActiveObjectives);
+	TestEqual("Loaded Q3 should have BranchA objectives", ActiveObjectives.Num(), 2);
+	TestEqual("BranchA should be second objective", ActiveObjectives[1]->GetIdentifier(), FName("O_BranchA_Q3"));
+
+	TestTrue("Accept quest OK", Loaded->AcceptQuest("Q_Branching2"));
+	auto LQ2 = Loaded->GetQuest("Q_Branching2");
+	LQ2->GetActiveObjectives(ActiveObjectives);
+	TestEqual("Q2 accepted after load should have BranchA objectives", ActiveObjectives.Num(), 2);
+	TestEqual("BranchA should be second objective", ActiveObjectives[1]->GetIdentifier(), FName("O_BranchA_Q2"));
+
+	// Archived quests answer the same whether they're hydrated or held as compact records
+	Loaded->FailQuest("Q_Branching3");
+	Loaded->SetGlobalQuestBranchActive("BranchUnused", true);
+	auto CheckArchivedBranches = [this, Loaded](const FString& Context)
+	{
+		TestTrue(Context + ": used branch should be active", Loaded->IsQuestBranchActive("Q_Branching3", "BranchA"));
+		TestFalse(Context + ": used branch should not be active", Loaded->IsQuestBranchActive("Q_Branching3", "BranchB"));
+		TestTrue(Context + ": quest branch should be active", Loaded->IsQuestBranchActive("Q_Branching3", "BranchLocalUnused"));
+		TestTrue(Context + ": unused global branch should be active", Loaded->IsQuestBranchActive("Q_Branching3", "BranchUnused"));
+		TestFalse(Context + ": unknown branch should not be active", Loaded->IsQuestBranchActive("Q_Branching3", "BranchNever"));
+	};
+	CheckArchivedBranches("Hydrated");
+	TestEqual("Failed quest should be compacted", Loaded->CompactArchivedQuests(), 1);
+	CheckArchivedBranches("Record");
+	// Global changes only reach active quests, except for branches the quest doesn't use
+	Loaded->SetGlobalQuestBranchActive("BranchB", true);
+	TestFalse("Used branch should not follow global changes once archived", Loaded->IsQuestBranchActive("Q_Branching3", "BranchB"));
+	Loaded->SetGlobalQuestBranchActive("BranchUnused", false);
+	TestFalse("Unused global branch should be inactive again", Loaded->IsQuestBranchActive("Q_Branching3", "BranchUnused"));
+	TestEqual("Branch queries should not rebuild the quest", Loaded->GetNumCompactArchivedQuests(), 1);
+
 	return true;
 }
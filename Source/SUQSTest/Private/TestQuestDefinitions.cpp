@@ -1,7 +1,10 @@
 #include "Misc/AutomationTest.h"
 #include "Engine.h"
 #include "SuqsProgression.h"
+#include "SuqsProgressView.h"
 #include "TestQuestData.h"
+#include "Serialization/MemoryReader.h"
+#include "Serialization/MemoryWriter.h"
 
 IMPLEMENT_SIMPLE_AUTOMATION_TEST(FTestCreateQuestDefinitions, "SUQSTest.CreateQuestDefinitions",
                                  EAutomationTestFlags::EditorContext |
@@ -53,11 +56,10 @@ bool FTestRuntimeQuestDefinitions::RunTest(const FString& Parameters)
 	TestFalse("Shouldn't be able to create a quest with no ID", Progression->CreateQuestDefinition(EmptyQuest));
 
 	// Copy a template
-	Progression->InitWithQuestDataTables(
-		TArray<UDataTable*> {
-			USuqsProgression::MakeQuestDataTableFromJSON(SimpleMainQuestJson)
-		}
-	);
+	UDataTable* QuestTable = USuqsProgression::MakeQuestDataTableFromJSON(SimpleMainQuestJson);
+	Progression->InitWithQuestDataTables(TArray<UDataTable*> { QuestTable });
+	TestTrue("Definitions should reference datatable rows in place",
+		Progression->GetQuestDefinitions().FindRef("Q_Main1") == QuestTable->FindRow<FSuqsQuest>("Q_Main1", ""));
 	FSuqsQuest QuestCopy;
 	if (TestTrue("Copy should work", Progression->GetQuestDefinitionCopy("Q_Main1", QuestCopy)))
 	{
@@ -77,3 +79,501 @@ bool FTestRuntimeQuestDefinitions::RunTest(const FString& Parameters)
 	}
 	return true;
 }
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FTestQuestCatalog, "SUQSTest.QuestCatalog",
+								 EAutomationTestFlags::EditorContext |
+								 EAutomationTestFlags::ClientContext |
+								 EAutomationTestFlags::ProductFilter)
+
+bool FTestQuestCatalog::RunTest(const FString& Parameters)
+{
+	USuqsProgression* Source = NewObject<USuqsProgression>();
+	Source->InitWithQuestDataTables(
+		TArray<UDataTable*> {
+			USuqsProgression::MakeQuestDataTableFromJSON(SimpleMainQuestJson),
+			USuqsProgression::MakeQuestDataTableFromJSON(BranchingQuestJson)
+		}
+	);
+
+	TArray<uint8> CatalogData;
+	Source->WriteQuestCatalog(CatalogData);
+	TestTrue("Catalog should have data", CatalogData.Num() > 0);
+
+	USuqsProgression* Progression = NewObject<USuqsProgression>();
+	if (!TestTrue("Catalog should load", Progression->InitWithQuestCatalog(CatalogData)))
+		return false;
+
+	const auto& SourceDefs = Source->GetQuestDefinitions();
+	const auto& Defs = Progression->GetQuestDefinitions();
+	TestEqual("Should have same number of quests", Defs.Num(), SourceDefs.Num());
+	for (auto& Pair : SourceDefs)
+	{
+		const FSuqsQuest& Expected = *Pair.Value;
+		const FSuqsQuest* Quest = Defs.FindRef(Pair.Key);
+		if (!TestNotNull("Quest should be in catalog", Quest))
+			continue;
+
+		TestEqual("Quest title", Quest->Title.ToString(), Expected.Title.ToString());
+		TestEqual("Quest description", Quest->DescriptionWhenActive.ToString(), Expected.DescriptionWhenActive.ToString());
+		TestEqual("Quest auto accept", Quest->AutoAccept, Expected.AutoAccept);
+		TestEqual("Quest prerequisites", Quest->PrerequisiteQuests, Expected.PrerequisiteQuests);
+		TestEqual("Quest default branches", Quest->DefaultActiveBranches, Expected.DefaultActiveBranches);
+		if (!TestEqual("Objective count", Quest->Objectives.Num(), Expected.Objectives.Num()))
+			continue;
+		for (int i = 0; i < Expected.Objectives.Num(); ++i)
+		{
+			const auto& ExpectedObj = Expected.Objectives[i];
+			const auto& Obj = Quest->Objectives[i];
+			TestEqual("Objective ID", Obj.Identifier, ExpectedObj.Identifier);
+			TestEqual("Objective branch", Obj.Branch, ExpectedObj.Branch);
+			TestEqual("Objective sequential", Obj.bSequentialTasks, ExpectedObj.bSequentialTasks);
+			TestEqual("Objective mandatory tasks", Obj.NumberOfMandatoryTasksRequired, ExpectedObj.NumberOfMandatoryTasksRequired);
+			if (!TestEqual("Task count", Obj.Tasks.Num(), ExpectedObj.Tasks.Num()))
+				continue;
+			for (int t = 0; t < ExpectedObj.Tasks.Num(); ++t)
+			{
+				const auto& ExpectedTask = ExpectedObj.Tasks[t];
+				const auto& Task = Obj.Tasks[t];
+				TestEqual("Task ID", Task.Identifier, ExpectedTask.Identifier);
+				TestEqual("Task title", Task.Title.ToString(), ExpectedTask.Title.ToString());
+				TestEqual("Task mandatory", Task.bMandatory, ExpectedTask.bMandatory);
+				TestEqual("Task target number", Task.TargetNumber, ExpectedTask.TargetNumber);
+				TestEqual("Task time limit", Task.TimeLimit, ExpectedTask.TimeLimit);
+			}
+		}
+	}
+
+	// Quests loaded from a catalog should work just the same
+	TestTrue("Should be able to accept quest from catalog", Progression->AcceptQuest("Q_Main1"));
+	TestTrue("Task should complete", Progression->CompleteTask("Q_Main1", "T_ReachThePlace"));
+
+	// Bad data should be rejected
+	TArray<uint8> Truncated(CatalogData.GetData(), CatalogData.Num() / 2);
+	AddExpectedError("truncated or corrupt", EAutomationExpectedMessageFlags::Contains, 1, false);
+	TestFalse("Truncated catalog should fail to load", Progression->InitWithQuestCatalog(Truncated));
+	TestEqual("No quests should be loaded from bad catalog", Progression->GetQuestDefinitions().Num(), 0);
+
+	// Corrupt counts in the header should be rejected without trying to allocate for them
+	// Header is magic, version, then name / text / name ref / quest / objective / task counts
+	auto CorruptCount = [&CatalogData](int32 Offset, int32 Count)
+	{
+		TArray<uint8> Corrupt = CatalogData;
+		FMemory::Memcpy(Corrupt.GetData() + Offset, &Count, sizeof(Count));
+		return Corrupt;
+	};
+	AddExpectedError("header is corrupt", EAutomationExpectedMessageFlags::Contains, 2, false);
+	TestFalse("Huge name count should fail to load", Progression->InitWithQuestCatalog(CorruptCount(8, MAX_int32)));
+	TestFalse("Negative name count should fail to load", Progression->InitWithQuestCatalog(CorruptCount(8, -1)));
+	AddExpectedError("truncated or corrupt", EAutomationExpectedMessageFlags::Contains, 2, false);
+	TestFalse("Huge text count should fail to load", Progression->InitWithQuestCatalog(CorruptCount(12, MAX_int32)));
+	TestFalse("Huge quest count should fail to load", Progression->InitWithQuestCatalog(CorruptCount(20, MAX_int32)));
+	TestEqual("No quests should be loaded from corrupt catalog", Progression->GetQuestDefinitions().Num(), 0);
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FTestQuestCatalogLoadTime, "SUQSTest.Perf.QuestCatalogLoadTime",
+								 EAutomationTestFlags::EditorContext |
+								 EAutomationTestFlags::ClientContext |
+								 EAutomationTestFlags::PerfFilter)
+
+bool FTestQuestCatalogLoadTime::RunTest(const FString& Parameters)
+{
+	constexpr int NumQuests = 10000;
+
+	// Generate a large number of quests based on a simple template
+	FString Json = TEXT("[");
+	for (int i = 0; i < NumQuests; ++i)
+	{
+		Json += FString::Printf(TEXT(R"RAWJSON(%s{
+			"Name": "Q_Gen%d",
+			"Identifier": "Q_Gen%d",
+			"Title": "NSLOCTEXT(\"TestQuests\", \"GenTitle%d\", \"Generated Quest %d\")",
+			"AutoAccept": false,
+			"Objectives": [
+				{
+					"Identifier": "O1",
+					"Title": "NSLOCTEXT(\"TestQuests\", \"GenObjTitle%d\", \"Objective\")",
+					"Tasks": [
+						{ "Identifier": "T_1", "Title": "NSLOCTEXT(\"TestQuests\", \"GenTask1_%d\", \"Task 1\")", "TargetNumber": 1 },
+						{ "Identifier": "T_2", "Title": "NSLOCTEXT(\"TestQuests\", \"GenTask2_%d\", \"Task 2\")", "TargetNumber": 5 }
+					]
+				}
+			]
+		})RAWJSON"), i > 0 ? TEXT(",") : TEXT(""), i, i, i, i, i, i, i);
+	}
+	Json += TEXT("]");
+
+	USuqsProgression* Progression = NewObject<USuqsProgression>();
+
+	double StartTime = FPlatformTime::Seconds();
+	Progression->InitWithQuestDataTables(
+		TArray<UDataTable*> {
+			USuqsProgression::MakeQuestDataTableFromJSON(Json)
+		}
+	);
+	const double JsonTime = FPlatformTime::Seconds() - StartTime;
+	TestEqual("All quests should load from JSON", Progression->GetQuestDefinitions().Num(), NumQuests);
+
+	TArray<uint8> CatalogData;
+	Progression->WriteQuestCatalog(CatalogData);
+
+	StartTime = FPlatformTime::Seconds();
+	Progression->InitWithQuestCatalog(CatalogData);
+	const double CatalogTime = FPlatformTime::Seconds() - StartTime;
+	TestEqual("All quests should load from catalog", Progression->GetQuestDefinitions().Num(), NumQuests);
+
+	AddInfo(FString::Printf(TEXT("%d quests: JSON + DataTable init %.1fms, catalog init %.1fms (%d bytes)"),
+		NumQuests, JsonTime * 1000.0, CatalogTime * 1000.0, CatalogData.Num()));
+
+	return true;
+}
+
+/// Approximate heap + inline size of a quest definition (excluding shared text data)
+static SIZE_T GetQuestDefinitionSize(const FSuqsQuest& Quest)
+{
+	SIZE_T Size = sizeof(FSuqsQuest) + Quest.Labels.GetAllocatedSize() + Quest.PrerequisiteQuests.GetAllocatedSize() +
+		Quest.PrerequisiteQuestFailures.GetAllocatedSize() + Quest.DefaultActiveBranches.GetAllocatedSize() +
+		Quest.Objectives.GetAllocatedSize();
+	for (const auto& Obj : Quest.Objectives)
+	{
+		Size += Obj.Tasks.GetAllocatedSize();
+		for (const auto& Task : Obj.Tasks)
+		{
+			Size += Task.Labels.GetAllocatedSize();
+		}
+	}
+	return Size;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FTestQuestRebuildTime, "SUQSTest.Perf.QuestRebuildTime",
+								 EAutomationTestFlags::EditorContext |
+								 EAutomationTestFlags::ClientContext |
+								 EAutomationTestFlags::PerfFilter)
+
+bool FTestQuestRebuildTime::RunTest(const FString& Parameters)
+{
+	USuqsProgression* Progression = NewObject<USuqsProgression>();
+
+	for (int NumQuests : { 1000, 5000, 20000 })
+	{
+		UDataTable* Table = NewObject<UDataTable>();
+		Table->RowStruct = FSuqsQuest::StaticStruct();
+		for (int i = 0; i < NumQuests; ++i)
+		{
+			FSuqsQuest Quest;
+			Quest.Identifier = FName("Q_Gen", i);
+			Quest.Title = FText::AsNumber(i);
+			// Chain some quests together so dependencies are indexed too
+			if (i > 0 && i % 4 != 0)
+			{
+				Quest.AutoAccept = true;
+				Quest.PrerequisiteQuests.Add(FName("Q_Gen", i - 1));
+			}
+			for (int o = 0; o < 3; ++o)
+			{
+				FSuqsObjective& Obj = Quest.Objectives.AddDefaulted_GetRef();
+				Obj.Identifier = FName("O", o);
+				Obj.Branch = o == 2 ? FName("BranchA") : NAME_None;
+				for (int t = 0; t < 3; ++t)
+				{
+					FSuqsTask& Task = Obj.Tasks.AddDefaulted_GetRef();
+					Task.Identifier = FName("T", o * 3 + t);
+				}
+			}
+			Table->AddRow(Quest.Identifier, Quest);
+		}
+
+		const double StartTime = FPlatformTime::Seconds();
+		Progression->InitWithQuestDataTables(TArray<UDataTable*> { Table });
+		const double RebuildTime = FPlatformTime::Seconds() - StartTime;
+
+		TestEqual("All quests should be loaded", Progression->GetQuestDefinitions().Num(), NumQuests);
+
+		// Definitions are referenced in place in the table, so this is what a copy would have cost
+		SIZE_T DefinitionSize = 0;
+		for (const auto& Pair : Progression->GetQuestDefinitions())
+		{
+			DefinitionSize += GetQuestDefinitionSize(*Pair.Value);
+		}
+		AddInfo(FString::Printf(TEXT("%d quests: rebuild %.1fms, %.1fKB of definitions not duplicated"),
+			NumQuests, RebuildTime * 1000.0, DefinitionSize / 1024.0));
+	}
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FTestManyRuntimeQuestDefinitions, "SUQSTest.ManyRuntimeQuestDefinitions",
+								 EAutomationTestFlags::EditorContext |
+								 EAutomationTestFlags::ClientContext |
+								 EAutomationTestFlags::ProductFilter)
+
+bool FTestManyRuntimeQuestDefinitions::RunTest(const FString& Parameters)
+{
+	USuqsProgression* Progression = NewObject<USuqsProgression>();
+
+	auto MakeQuest = [](int i)
+	{
+		FSuqsQuest Quest;
+		Quest.Identifier = FName("Q_Procedural", i);
+		Quest.Title = FText::Format(INVTEXT("Procedural Quest {0}"), i);
+		FSuqsObjective& Obj = Quest.Objectives.AddDefaulted_GetRef();
+		FSuqsTask& Task = Obj.Tasks.AddDefaulted_GetRef();
+		Task.Identifier = "T_Task";
+		Task.Title = INVTEXT("A Task");
+		return Quest;
+	};
+
+	TestTrue("First quest should be created", Progression->CreateQuestDefinition(MakeQuest(0)));
+	TestTrue("Should be able to accept first quest", Progression->AcceptQuest(FName("Q_Procedural", 0)));
+	const FSuqsQuest* FirstDef = Progression->GetQuestDefinitions().FindRef(FName("Q_Procedural", 0));
+	USuqsQuestState* FirstState = Progression->GetQuest(FName("Q_Procedural", 0));
+	if (!TestNotNull("Quest state should exist", FirstState))
+		return false;
+
+	// Adding lots more definitions must not move existing ones out from under quest states
+	for (int i = 1; i < 2000; ++i)
+	{
+		Progression->CreateQuestDefinition(MakeQuest(i));
+	}
+	TestEqual("Should have all quests", Progression->GetQuestDefinitions().Num(), 2000);
+	TestTrue("First definition should not have moved", Progression->GetQuestDefinitions().FindRef(FName("Q_Procedural", 0)) == FirstDef);
+	TestEqual("First quest state should still be valid", FirstState->GetTitle().ToString(), FString("Procedural Quest 0"));
+	TestTrue("First quest task should still complete", Progression->CompleteTask(FName("Q_Procedural", 0), "T_Task"));
+	TestTrue("First quest should be complete", Progression->IsQuestCompleted(FName("Q_Procedural", 0)));
+
+	// Removed slots are reused
+	const FSuqsQuest* MidDef = Progression->GetQuestDefinitions().FindRef(FName("Q_Procedural", 1000));
+	TestTrue("Delete should work", Progression->DeleteQuestDefinition(FName("Q_Procedural", 1000)));
+	TestTrue("Should be able to recreate", Progression->CreateQuestDefinition(MakeQuest(5000)));
+	TestTrue("Freed definition slot should be reused", Progression->GetQuestDefinitions().FindRef(FName("Q_Procedural", 5000)) == MidDef);
+	TestTrue("Should be able to accept reused quest", Progression->AcceptQuest(FName("Q_Procedural", 5000)));
+
+	// Overwriting an identical definition just points the existing state at it
+	USuqsQuestState* ReusedState = Progression->GetQuest(FName("Q_Procedural", 5000));
+	const FSuqsQuestHandle ReusedHandle = Progression->GetQuestHandle(FName("Q_Procedural", 5000));
+	TestTrue("Identical overwrite should work", Progression->CreateQuestDefinition(MakeQuest(5000), true));
+	TestEqual("Quest state should be kept", Progression->GetQuest(FName("Q_Procedural", 5000)), ReusedState);
+	TestEqual("Quest handle should be kept", Progression->GetQuestHandle(FName("Q_Procedural", 5000)), ReusedHandle);
+	// The old definition's slot has been cleared, so this only works if the state was rebound
+	TestEqual("Quest state should use the new definition", ReusedState->GetIdentifier(), FName("Q_Procedural", 5000));
+	TestEqual("Should still have all quests", Progression->GetQuestDefinitions().Num(), 2000);
+
+	// Overwriting a changed definition keeps progress where tasks still match, rather than resetting it
+	FSuqsQuest Changed = MakeQuest(5000);
+	Changed.Objectives[0].Tasks[0].TargetNumber = 3;
+	TestTrue("Changed overwrite should work", Progression->CreateQuestDefinition(Changed, true));
+	TestEqual("Progress should work", Progression->ProgressTask(FName("Q_Procedural", 5000), "T_Task", 1), 2);
+	Changed.Title = INVTEXT("Changed Quest");
+	Changed.Objectives[0].Tasks.AddDefaulted_GetRef().Identifier = "T_Extra";
+	TestTrue("Changed overwrite should work", Progression->CreateQuestDefinition(Changed, true));
+	TestEqual("Quest handle should be kept", Progression->GetQuestHandle(FName("Q_Procedural", 5000)), ReusedHandle);
+	TestTrue("Quest should still be accepted", Progression->IsQuestAccepted(FName("Q_Procedural", 5000)));
+	TestEqual("Quest title should be updated", Progression->GetQuest(FName("Q_Procedural", 5000))->GetTitle().ToString(), FString("Changed Quest"));
+	TestEqual("Task progress should be kept", Progression->GetTaskState(FName("Q_Procedural", 5000), "T_Task")->GetNumber(), 1);
+	TestNotNull("New task should exist", Progression->GetTaskState(FName("Q_Procedural", 5000), "T_Extra"));
+	TestEqual("Should still have all quests", Progression->GetQuestDefinitions().Num(), 2000);
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FTestQuestInstances, "SUQSTest.QuestInstances",
+								 EAutomationTestFlags::EditorContext |
+								 EAutomationTestFlags::ClientContext |
+								 EAutomationTestFlags::ProductFilter)
+
+bool FTestQuestInstances::RunTest(const FString& Parameters)
+{
+	FSuqsQuest Template;
+	Template.Identifier = "Q_Template";
+	Template.Title = INVTEXT("Collect {Thing}");
+	FSuqsObjective& Obj = Template.Objectives.Add_GetRef(FSuqsObjective());
+	Obj.Identifier = "O_1";
+	FSuqsTask& Task = Obj.Tasks.Add_GetRef(FSuqsTask());
+	Task.Identifier = "T_Collect";
+	Task.Title = INVTEXT("Collect some {Thing}");
+	Task.TargetNumber = 1;
+
+	FSuqsQuestInstance Instance;
+	Instance.Identifier = "Q_Radiant1";
+	Instance.TaskTargetNumbers.Add("T_Collect", 7);
+	Instance.Parameters.Add("Thing", INVTEXT("Gems"));
+
+	auto SetupProgression = [&](USuqsProgression* P)
+	{
+		P->CreateQuestDefinition(Template);
+		return P->CreateQuestInstance("Q_Template", Instance);
+	};
+
+	USuqsProgression* Progression = NewObject<USuqsProgression>();
+	TestTrue("Instance should be created", SetupProgression(Progression));
+	TestFalse("Shouldn't be able to create instance twice", Progression->CreateQuestInstance("Q_Template", Instance));
+	AddExpectedError("does not exist", EAutomationExpectedMessageFlags::Contains, 1, false);
+	TestFalse("Shouldn't be able to instance a missing template", Progression->CreateQuestInstance("Q_Missing", Instance));
+
+	const FSuqsQuest* TemplateDef = Progression->GetQuestDefinitions().FindRef("Q_Template");
+	const FSuqsQuest* InstanceDef = Progression->GetQuestDefinitions().FindRef("Q_Radiant1");
+	if (!TestNotNull("Instance definition should exist", InstanceDef))
+		return false;
+	TestEqual("Instance should have no objectives of its own", InstanceDef->Objectives.Num(), 0);
+	TestTrue("Instance should share template objectives", Progression->GetQuestObjectives(*InstanceDef).GetData() == TemplateDef->Objectives.GetData());
+	TestEqual("Instance should know its template", Progression->GetQuestTemplateIdentifier("Q_Radiant1"), FName("Q_Template"));
+	TestEqual("Template should not have a template", Progression->GetQuestTemplateIdentifier("Q_Template"), FName());
+	TArray<FSuqsObjective> InstanceObjectives;
+	TestTrue("Should be able to get instance objectives", Progression->GetQuestDefinitionObjectives("Q_Radiant1", InstanceObjectives));
+	if (TestEqual("Instance objectives should come from template", InstanceObjectives.Num(), 1))
+		TestEqual("Instance objective task", InstanceObjectives[0].Tasks[0].Identifier, FName("T_Collect"));
+	const TMap<FName, FSuqsQuest> DefinitionCopies = Progression->GetQuestDefinitionsCopy();
+	TestEqual("Definition copies should include every quest", DefinitionCopies.Num(), Progression->GetQuestDefinitions().Num());
+	if (TestTrue("Definition copies should include instance", DefinitionCopies.Contains("Q_Radiant1")))
+		TestEqual("Instance copy should have template objectives", DefinitionCopies["Q_Radiant1"].Objectives.Num(), 1);
+
+	TestTrue("Should be able to accept instance", Progression->AcceptQuest("Q_Radiant1"));
+	auto QuestState = Progression->GetQuest("Q_Radiant1");
+	auto TaskState = Progression->GetTaskState("Q_Radiant1", "T_Collect");
+	if (!TestNotNull("Quest state should exist", QuestState) || !TestNotNull("Task state should exist", TaskState))
+		return false;
+	TestEqual("Instance parameters should be used in quest title", QuestState->GetTitle().ToString(), FString("Collect Gems"));
+	TestEqual("Instance parameters should be used in task title", TaskState->GetTitle().ToString(), FString("Collect some Gems"));
+	TestEqual("Instance should override target number", TaskState->GetTargetNumber(), 7);
+	TestEqual("Template target number should be unchanged", TemplateDef->Objectives[0].Tasks[0].TargetNumber, 1);
+	TaskState->Progress(3);
+
+	FSuqsProgressView View;
+	View.FromUObject(Progression, false);
+	if (TestEqual("Progress view should have instance", View.ActiveQuests.Num(), 1))
+	{
+		TestEqual("Progress view quest ID", View.ActiveQuests[0].Identifier, FName("Q_Radiant1"));
+		if (TestEqual("Progress view tasks", View.ActiveQuests[0].CurrentTasks.Num(), 1))
+			TestEqual("Progress view task target", View.ActiveQuests[0].CurrentTasks[0].TargetNumber, 7);
+	}
+
+	AddExpectedError("is the template for instance", EAutomationExpectedMessageFlags::Contains, 1, false);
+	TestFalse("Shouldn't be able to delete a template with instances", Progression->DeleteQuestDefinition("Q_Template"));
+
+	// Save and load into a progression with the instance re-created
+	TArray<uint8> Data;
+	FMemoryWriter Writer(Data);
+	Progression->Serialize(Writer);
+
+	USuqsProgression* LoadedProgression = NewObject<USuqsProgression>();
+	SetupProgression(LoadedProgression);
+	FMemoryReader Reader(Data);
+	LoadedProgression->Serialize(Reader);
+	auto LoadedTask = LoadedProgression->GetTaskState("Q_Radiant1", "T_Collect");
+	if (TestNotNull("Loaded task should exist", LoadedTask))
+	{
+		TestEqual("Loaded task progress", LoadedTask->GetNumber(), 3);
+		TestEqual("Loaded task target", LoadedTask->GetTargetNumber(), 7);
+	}
+
+	// Overwriting an accepted instance keeps its handle & progress, and picks up the new overrides
+	const FSuqsQuestHandle InstanceHandle = Progression->GetQuestHandle("Q_Radiant1");
+	TestTrue("Unchanged instance overwrite should work", Progression->CreateQuestInstance("Q_Template", Instance, true));
+	TestEqual("Unchanged instance overwrite should keep the state", Progression->GetQuest("Q_Radiant1"), QuestState);
+	FSuqsQuestInstance ChangedInstance = Instance;
+	ChangedInstance.TaskTargetNumbers.Add("T_Collect", 9);
+	ChangedInstance.Parameters.Add("Thing", INVTEXT("Coins"));
+	TestTrue("Changed instance overwrite should work", Progression->CreateQuestInstance("Q_Template", ChangedInstance, true));
+	TestEqual("Instance handle should be kept", Progression->GetQuestHandle("Q_Radiant1"), InstanceHandle);
+	TestTrue("Instance should still be accepted", Progression->IsQuestAccepted("Q_Radiant1"));
+	TestEqual("Instance should still use the template", Progression->GetQuestTemplateIdentifier("Q_Radiant1"), FName("Q_Template"));
+	auto OverwrittenTask = Progression->GetTaskState("Q_Radiant1", "T_Collect");
+	if (TestNotNull("Overwritten instance task should exist", OverwrittenTask))
+	{
+		TestEqual("Overwritten instance progress should be kept", OverwrittenTask->GetNumber(), 3);
+		TestEqual("Overwritten instance should use new target number", OverwrittenTask->GetTargetNumber(), 9);
+	}
+	TestEqual("Overwritten instance should use new parameters", Progression->GetQuest("Q_Radiant1")->GetTitle().ToString(), FString("Collect Coins"));
+
+	// Copying an instance gives an independent quest
+	FSuqsQuest Copy;
+	if (TestTrue("Should be able to copy instance", Progression->GetQuestDefinitionCopy("Q_Radiant1", Copy)))
+	{
+		TestEqual("Copy should have its own objectives", Copy.Objectives.Num(), 1);
+		Copy.Identifier = "Q_RadiantCopy";
+		TestTrue("Copy should be created", Progression->CreateQuestDefinition(Copy));
+		TestEqual("Copy should not refer to template", Progression->GetQuestTemplateIdentifier("Q_RadiantCopy"), FName());
+	}
+
+	return true;
+}
+
+const FString ReloadQuestsJson = R"RAWJSON([
+	{
+		"Identifier": "Q_Keep",
+		"Title": "NSLOCTEXT(\"TestQuests\", \"ReloadKeepTitle\", \"Keep\")",
+		"Objectives": [ { "Identifier": "O1", "Tasks": [ { "Identifier": "T_Keep", "TargetNumber": 5 } ] } ]
+	},
+	{
+		"Identifier": "Q_Change",
+		"Objectives": [ { "Identifier": "O1", "Tasks": [ { "Identifier": "T_Change1", "TargetNumber": 5 }, { "Identifier": "T_Change2" } ] } ]
+	},
+	{
+		"Identifier": "Q_Remove",
+		"Objectives": [ { "Identifier": "O1", "Tasks": [ { "Identifier": "T_Remove" } ] } ]
+	}
+])RAWJSON";
+
+const FString ReloadQuestsChangedJson = R"RAWJSON([
+	{
+		"Identifier": "Q_Keep",
+		"Title": "NSLOCTEXT(\"TestQuests\", \"ReloadKeepTitle\", \"Keep\")",
+		"Objectives": [ { "Identifier": "O1", "Tasks": [ { "Identifier": "T_Keep", "TargetNumber": 5 } ] } ]
+	},
+	{
+		"Identifier": "Q_Change",
+		"Objectives": [ { "Identifier": "O1", "Tasks": [ { "Identifier": "T_Change1", "TargetNumber": 10 }, { "Identifier": "T_Change3" } ] } ]
+	},
+	{
+		"Identifier": "Q_Add",
+		"Objectives": [ { "Identifier": "O1", "Tasks": [ { "Identifier": "T_Add" } ] } ]
+	}
+])RAWJSON";
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FTestReloadQuestData, "SUQSTest.ReloadQuestData",
+								 EAutomationTestFlags::EditorContext |
+								 EAutomationTestFlags::ClientContext |
+								 EAutomationTestFlags::ProductFilter)
+
+bool FTestReloadQuestData::RunTest(const FString& Parameters)
+{
+	UDataTable* QuestTable = USuqsProgression::MakeQuestDataTableFromJSON(ReloadQuestsJson);
+	USuqsProgression* Progression = NewObject<USuqsProgression>();
+	Progression->InitWithQuestDataTables(TArray<UDataTable*> { QuestTable });
+
+	TestTrue("Accept quest OK", Progression->AcceptQuest("Q_Keep"));
+	TestTrue("Accept quest OK", Progression->AcceptQuest("Q_Change"));
+	TestTrue("Accept quest OK", Progression->AcceptQuest("Q_Remove"));
+	Progression->ProgressTask("Q_Keep", "T_Keep", 2);
+	Progression->ProgressTask("Q_Change", "T_Change1", 3);
+	const USuqsQuestState* KeepState = Progression->GetQuest("Q_Keep");
+	const FSuqsQuestHandle ChangeHandle = Progression->GetQuestHandle("Q_Change");
+
+	// Reimporting frees the old rows, so this also checks that nothing uses the old definitions
+	QuestTable->CreateTableFromJSONString(ReloadQuestsChangedJson);
+	Progression->ReloadQuestData();
+
+	TestEqual("Unchanged quest state should be left alone", Progression->GetQuest("Q_Keep"), KeepState);
+	TestEqual("Unchanged quest progress should be kept", Progression->GetTaskState("Q_Keep", "T_Keep")->GetNumber(), 2);
+	TestEqual("Unchanged quest should use new definition", KeepState->GetTitle().ToString(), FString("Keep"));
+
+	TestTrue("Changed quest should still be accepted", Progression->IsQuestAccepted("Q_Change"));
+	auto ChangeTask1 = Progression->GetTaskState("Q_Change", "T_Change1");
+	if (!TestNotNull("Changed quest should still have task", ChangeTask1))
+		return false;
+	TestEqual("Changed quest progress should be kept", ChangeTask1->GetNumber(), 3);
+	TestEqual("Changed quest should use new definition", ChangeTask1->GetTargetNumber(), 10);
+	TestNull("Removed task should be gone", Progression->GetTaskState("Q_Change", "T_Change2"));
+	TestNotNull("Added task should exist", Progression->GetTaskState("Q_Change", "T_Change3"));
+	TestEqual("Quest handle should still be valid", Progression->GetQuest(ChangeHandle), Progression->GetQuest("Q_Change"));
+	TestEqual("Task handle should be valid once looked up again",
+		Progression->GetTaskState(Progression->GetTaskHandle("Q_Change", "T_Change1")), ChangeTask1);
+
+	TestFalse("Removed quest should not be accepted", Progression->IsQuestAccepted("Q_Remove"));
+	TestNull("Removed quest should not be defined", Progression->GetQuestDefinition("Q_Remove"));
+	TestNotNull("Added quest should be defined", Progression->GetQuestDefinition("Q_Add"));
+	TestTrue("Added quest can be accepted", Progression->AcceptQuest("Q_Add"));
+
+	return true;
+}
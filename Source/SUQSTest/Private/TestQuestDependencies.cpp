@@ -229,4 +229,70 @@ bool FTestQuestMixedDependencies::RunTest(const FString& Parameters)
 	TestTrue("Dependent quest should NOW be auto accepted", Progression->IsQuestAccepted("Q_MixedDeps"));
 
 	return true;
-}
\ No newline at end of file
+}
+const FString CyclicDependentQuestsJson = R"RAWJSON([
+	{
+		"Identifier": "Q_CycleA",
+		"AutoAccept": true,
+		"PrerequisiteQuests": ["Q_CycleB"],
+		"Objectives": [ { "Identifier": "O1", "Tasks": [ { "Identifier": "T_CycleA" } ] } ]
+	},
+	{
+		"Identifier": "Q_CycleB",
+		"AutoAccept": true,
+		"PrerequisiteQuests": ["Q_CycleA"],
+		"Objectives": [ { "Identifier": "O1", "Tasks": [ { "Identifier": "T_CycleB" } ] } ]
+	},
+	{
+		"Identifier": "Q_LateDeps",
+		"AutoAccept": true,
+		"PrerequisiteQuests": ["Q_TriggerQuest1", "Q_NotDefinedYet"],
+		"Objectives": [ { "Identifier": "O1", "Tasks": [ { "Identifier": "T_LateDep" } ] } ]
+	}
+])RAWJSON";
+
+const FString LateTriggerQuestJson = R"RAWJSON([
+	{
+		"Identifier": "Q_NotDefinedYet",
+		"Objectives": [ { "Identifier": "O1", "Tasks": [ { "Identifier": "T_Late" } ] } ]
+	}
+])RAWJSON";
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FTestQuestDependencyGraph, "SUQSTest.QuestDependencyGraph",
+                                 EAutomationTestFlags::EditorContext |
+                                 EAutomationTestFlags::ClientContext |
+                                 EAutomationTestFlags::ProductFilter)
+
+bool FTestQuestDependencyGraph::RunTest(const FString& Parameters)
+{
+	USuqsProgression* Progression = NewObject<USuqsProgression>();
+	Progression->InitWithQuestDataTables(
+		TArray<UDataTable*> {
+			USuqsProgression::MakeQuestDataTableFromJSON(TriggerQuestsJson)
+		}
+	);
+
+	// Prerequisite already met before the dependent quest is defined
+	TestTrue("Accept quest OK", Progression->AcceptQuest("Q_TriggerQuest1"));
+	Progression->CompleteQuest("Q_TriggerQuest1");
+
+	AddExpectedError("form a cycle", EAutomationExpectedMessageFlags::Contains, 1, false);
+	TestTrue("Create quests OK", Progression->CreateQuestDefinitionsFromJSON(CyclicDependentQuestsJson));
+	TestFalse("Cyclic dependencies can't be met", Progression->QuestDependenciesMet("Q_CycleA"));
+	TestFalse("Missing prerequisite can't be met", Progression->QuestDependenciesMet("Q_LateDeps"));
+
+	// Defining the missing quest links it up
+	TestTrue("Create quest OK", Progression->CreateQuestDefinitionsFromJSON(LateTriggerQuestJson));
+	TestFalse("Late prerequisite isn't met yet", Progression->QuestDependenciesMet("Q_LateDeps"));
+	TestTrue("Accept quest OK", Progression->AcceptQuest("Q_NotDefinedYet"));
+	Progression->CompleteQuest("Q_NotDefinedYet");
+	TestTrue("Dependent quest should now be auto accepted", Progression->IsQuestAccepted("Q_LateDeps"));
+
+	// Counts must follow the quest state back again
+	Progression->RemoveQuest("Q_NotDefinedYet");
+	TestFalse("Removed prerequisite is no longer met", Progression->QuestDependenciesMet("Q_LateDeps"));
+	Progression->DeleteQuestDefinition("Q_NotDefinedYet");
+	TestFalse("Deleted prerequisite is no longer met", Progression->QuestDependenciesMet("Q_LateDeps"));
+
+	return true;
+}
@@ -615,4 +615,120 @@ bool FTestQuestDetailEvents::RunTest(const FString& Parameters)
 	return true;
 }
 
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FTestQuestBatchEvents, "SUQSTest.QuestBatchEvents",
+                                 EAutomationTestFlags::EditorContext |
+                                 EAutomationTestFlags::ClientContext |
+                                 EAutomationTestFlags::ProductFilter)
+
+bool FTestQuestBatchEvents::RunTest(const FString& Parameters)
+{
+	USuqsProgression* Progression = NewObject<USuqsProgression>();
+	Progression->InitWithQuestDataTables(
+		TArray<UDataTable*>{
+			USuqsProgression::MakeQuestDataTableFromJSON(SimpleMainQuestJson),
+			USuqsProgression::MakeQuestDataTableFromJSON(UnorderedTasksQuestJson)
+		}
+	);
+
+	UCallbackCatcher* CallbackObj = NewObject<UCallbackCatcher>();
+	CallbackObj->Subscribe(Progression);
+
+	TestTrue("Accept quest OK", Progression->AcceptQuest("Q_Main1"));
+	TestTrue("Accept quest OK", Progression->AcceptQuest("Q_Unordered"));
+	CallbackObj->UpdatedTasks.Empty();
+	CallbackObj->ProgressionEvents.Empty();
+
+	{
+		FSuqsBatchScope Batch(Progression);
+		TestTrue("Should be in batch", Progression->IsInBatch());
+
+		// Repeated updates to the same task should be combined
+		Progression->ProgressTask("Q_Main1", "T_CollectDoobries", 1);
+		Progression->ProgressTask("Q_Main1", "T_CollectDoobries", 1);
+		Progression->ProgressTask("Q_Main1", "T_CollectDoobries", 1);
+
+		Progression->CompleteTask("Q_Unordered", "T_1");
+		Progression->CompleteTask("Q_Unordered", "T_2");
+		Progression->CompleteTask("Q_Unordered", "T_3");
+
+		TestTrue("Task status should change immediately", Progression->IsTaskCompleted("Q_Unordered", "T_3"));
+		TestTrue("Quest status should be deferred", Progression->IsQuestIncomplete("Q_Unordered"));
+		TestEqual("Events should be deferred", CallbackObj->ProgressionEvents.Num(), 0);
+		TestEqual("Events should be deferred", CallbackObj->CompletedTasks.Num(), 0);
+	}
+
+	TestFalse("Should not be in batch", Progression->IsInBatch());
+	TestTrue("Quest should be completed after batch", Progression->IsQuestCompleted("Q_Unordered"));
+	TestEqual("Task progress should be correct", Progression->GetTaskState("Q_Main1", "T_CollectDoobries")->GetNumber(), 3);
+	TestEqual("Should have one task updated event", CallbackObj->UpdatedTasks.Num(), 1);
+	TestEqual("Should have 3 task completed events", CallbackObj->CompletedTasks.Num(), 3);
+	TestEqual("Should have 1 objective completed event", CallbackObj->CompletedObjectives.Num(), 1);
+	if (TestEqual("Should have 1 quest completed event", CallbackObj->CompletedQuests.Num(), 1))
+		TestEqual("Should be correct quest", CallbackObj->CompletedQuests[0]->GetIdentifier(), FName("Q_Unordered"));
+
+	int NumListChanged = 0;
+	for (auto& Evt : CallbackObj->ProgressionEvents)
+	{
+		if (Evt.EventType == ESuqsProgressionEventType::ActiveQuestsChanged)
+			++NumListChanged;
+	}
+	TestEqual("Active quest list changes should be combined", NumListChanged, 1);
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FTestQuestDeferredEvents, "SUQSTest.QuestDeferredEvents",
+                                 EAutomationTestFlags::EditorContext |
+                                 EAutomationTestFlags::ClientContext |
+                                 EAutomationTestFlags::ProductFilter)
+
+bool FTestQuestDeferredEvents::RunTest(const FString& Parameters)
+{
+	USuqsProgression* Progression = NewObject<USuqsProgression>();
+	Progression->InitWithQuestDataTables(
+		TArray<UDataTable*>{
+			USuqsProgression::MakeQuestDataTableFromJSON(TimeLimitQuestJson)
+		}
+	);
+
+	UCallbackCatcher* CallbackObj = NewObject<UCallbackCatcher>();
+	CallbackObj->Subscribe(Progression);
+	Progression->SetDeferEvents(true);
+
+	TestTrue("Accept quest OK", Progression->AcceptQuest("Q_TimeLimits"));
+	TestEqual("Events should be deferred", CallbackObj->ProgressionEvents.Num(), 0);
+	TestEqual("Events should be deferred", CallbackObj->AcceptedQuests.Num(), 0);
+	Progression->Tick(1);
+	TestEqual("Accept event should be raised on tick", CallbackObj->AcceptedQuests.Num(), 1);
+	TestEqual("Should have one task update from tick", CallbackObj->UpdatedTasks.Num(), 1);
+
+	CallbackObj->UpdatedTasks.Empty();
+	auto T = Progression->GetTaskState("Q_TimeLimits", "T_Single");
+	T->SetTimeRemaining(90);
+	T->SetTimeRemaining(80);
+	T->SetTimeRemaining(70);
+	TestEqual("Updates should be deferred", CallbackObj->UpdatedTasks.Num(), 0);
+	Progression->Tick(0);
+	TestEqual("Updates should have been combined", CallbackObj->UpdatedTasks.Num(), 1);
+
+	// Turn off combining for updates
+	CallbackObj->UpdatedTasks.Empty();
+	Progression->SetEventTypeCoalesced(ESuqsProgressionEventType::TaskUpdated, false);
+	T->SetTimeRemaining(60);
+	T->SetTimeRemaining(50);
+	T->SetTimeRemaining(40);
+	Progression->Tick(0);
+	TestEqual("Updates should not have been combined", CallbackObj->UpdatedTasks.Num(), 3);
+
+	// Turning off deferral should raise outstanding events
+	CallbackObj->UpdatedTasks.Empty();
+	T->SetTimeRemaining(30);
+	Progression->SetDeferEvents(false);
+	TestEqual("Outstanding events should be raised", CallbackObj->UpdatedTasks.Num(), 1);
+	T->SetTimeRemaining(20);
+	TestEqual("Events should be immediate again", CallbackObj->UpdatedTasks.Num(), 2);
+
+	return true;
+}
+
 UE_ENABLE_OPTIMIZATION_SHIP
\ No newline at end of file
@@ -0,0 +1,250 @@
+#include "Misc/AutomationTest.h"
+#include "Engine.h"
+#include "SuqsProgression.h"
+#include "TestQuestData.h"
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FTestQuestHandles, "SUQSTest.QuestHandles",
+                                 EAutomationTestFlags::EditorContext |
+                                 EAutomationTestFlags::ClientContext |
+                                 EAutomationTestFlags::ProductFilter)
+
+bool FTestQuestHandles::RunTest(const FString& Parameters)
+{
+	USuqsProgression* Progression = NewObject<USuqsProgression>();
+	Progression->InitWithQuestDataTables(
+        TArray<UDataTable*> {
+        	USuqsProgression::MakeQuestDataTableFromJSON(SimpleMainQuestJson),
+        	USuqsProgression::MakeQuestDataTableFromJSON(SimpleSideQuestJson)
+        }
+    );
+
+	const FSuqsQuestHandle MainQ = Progression->GetQuestHandle("Q_Main1");
+	const FSuqsQuestHandle SideQ = Progression->GetQuestHandle("Q_Side1");
+	TestTrue("Main quest handle should be valid", MainQ.IsValid());
+	TestTrue("Side quest handle should be valid", SideQ.IsValid());
+	TestTrue("Quest handles should be different", MainQ != SideQ);
+	TestFalse("Unknown quest handle should be invalid", Progression->GetQuestHandle("Q_DoesNotExist").IsValid());
+
+	const FSuqsTaskHandle ReachThePlace = Progression->GetTaskHandle("Q_Main1", "T_ReachThePlace");
+	const FSuqsTaskHandle DoTheThing = Progression->GetTaskHandle("Q_Main1", "T_DoTheThing");
+	const FSuqsTaskHandle CollectDoobries = Progression->GetTaskHandle("Q_Main1", "T_CollectDoobries");
+	TestTrue("Task handle should be valid", ReachThePlace.IsValid());
+	TestFalse("Task in wrong quest should be invalid", Progression->GetTaskHandle("Q_Side1", "T_ReachThePlace").IsValid());
+	const FSuqsObjectiveHandle O2 = Progression->GetObjectiveHandle("Q_Main1", "O2");
+	TestTrue("Objective handle should be valid", O2.IsValid());
+
+	// Handles can be resolved before quests are accepted, but there's no state yet
+	TestEqual("Main quest should be unavailable", Progression->GetQuestStatus(MainQ), ESuqsQuestStatus::Unavailable);
+	TestNull("Task state should not exist yet", Progression->GetTaskState(ReachThePlace));
+	TestFalse("Task should not be relevant", Progression->IsTaskRelevant(ReachThePlace));
+
+	TestTrue("Should be able to accept main quest", Progression->AcceptQuest("Q_Main1"));
+	TestEqual("Main quest should be incomplete", Progression->GetQuestStatus(MainQ), ESuqsQuestStatus::Incomplete);
+	TestEqual("Side quest should be unavailable", Progression->GetQuestStatus(SideQ), ESuqsQuestStatus::Unavailable);
+	TestEqual("Handle should resolve to same quest", Progression->GetQuest(MainQ), Progression->GetQuest("Q_Main1"));
+	TestEqual("Handle should resolve to same task", Progression->GetTaskState(DoTheThing), Progression->GetTaskState("Q_Main1", "T_DoTheThing"));
+	TestEqual("Handle should resolve to same objective", Progression->GetObjective(O2), Progression->GetQuest("Q_Main1")->GetObjective("O2"));
+
+	TestTrue("First task should be relevant", Progression->IsTaskRelevant(ReachThePlace));
+	TestTrue("Should be able to complete task by handle", Progression->CompleteTask(ReachThePlace));
+	TestTrue("Task should be completed", Progression->IsTaskCompleted("Q_Main1", "T_ReachThePlace"));
+	TestEqual("Progress by handle should work", Progression->ProgressTask(CollectDoobries, 2), 3);
+	TestEqual("Task number should be updated", Progression->GetTaskState("Q_Main1", "T_CollectDoobries")->GetNumber(), 2);
+
+	// Handles should follow quests to the archive
+	Progression->FailQuest("Q_Main1");
+	TestEqual("Main quest should be failed", Progression->GetQuestStatus(MainQ), ESuqsQuestStatus::Failed);
+	TestNotNull("Archived task should still resolve", Progression->GetTaskState(DoTheThing));
+	Progression->RemoveQuest("Q_Main1");
+	TestEqual("Removed quest should be unavailable", Progression->GetQuestStatus(MainQ), ESuqsQuestStatus::Unavailable);
+	TestNull("Removed task should not resolve", Progression->GetTaskState(DoTheThing));
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FTestQuestHandleReuse, "SUQSTest.QuestHandleReuse",
+                                 EAutomationTestFlags::EditorContext |
+                                 EAutomationTestFlags::ClientContext |
+                                 EAutomationTestFlags::ProductFilter)
+
+bool FTestQuestHandleReuse::RunTest(const FString& Parameters)
+{
+	USuqsProgression* Progression = NewObject<USuqsProgression>();
+	Progression->InitWithQuestDataTables(
+        TArray<UDataTable*> {
+        	USuqsProgression::MakeQuestDataTableFromJSON(SimpleMainQuestJson)
+        }
+    );
+	const FSuqsQuestHandle MainQ = Progression->GetQuestHandle("Q_Main1");
+	const FSuqsTaskHandle MainTask = Progression->GetTaskHandle("Q_Main1", "T_ReachThePlace");
+
+	FSuqsQuest Template;
+	TestTrue("Copy should work", Progression->GetQuestDefinitionCopy("Q_Main1", Template));
+	Template.Identifier = "Q_Runtime0";
+	TestTrue("Runtime quest should be created", Progression->CreateQuestDefinition(Template));
+	const FSuqsQuestHandle FirstQ = Progression->GetQuestHandle("Q_Runtime0");
+	const FSuqsTaskHandle FirstTask = Progression->GetTaskHandle("Q_Runtime0", "T_ReachThePlace");
+	TestTrue("Should be able to accept runtime quest", Progression->AcceptQuest("Q_Runtime0"));
+	TestNotNull("Runtime task should resolve", Progression->GetTaskState(FirstTask));
+
+	// Delete / create cycles re-use the same slots rather than growing the handle tables
+	FSuqsQuestHandle PrevQ = FirstQ;
+	FSuqsTaskHandle PrevTask = FirstTask;
+	for (int32 i = 1; i <= 10; ++i)
+	{
+		TestTrue("Delete runtime quest should work", Progression->DeleteQuestDefinition(Template.Identifier));
+		Template.Identifier = FName(FString::Printf(TEXT("Q_Runtime%d"), i));
+		TestTrue("Runtime quest should be created", Progression->CreateQuestDefinition(Template));
+		const FSuqsQuestHandle NewQ = Progression->GetQuestHandle(Template.Identifier);
+		const FSuqsTaskHandle NewTask = Progression->GetTaskHandle(Template.Identifier, "T_ReachThePlace");
+		TestEqual("Quest handle slot should be re-used", NewQ.Index, FirstQ.Index);
+		TestEqual("Task handle slot should be re-used", NewTask.Index, FirstTask.Index);
+		TestTrue("Re-used quest handle should not equal the old one", NewQ != PrevQ);
+		TestTrue("Re-used task handle should not equal the old one", NewTask != PrevTask);
+		PrevQ = NewQ;
+		PrevTask = NewTask;
+	}
+
+	// Stale handles don't resolve to whatever re-used their slot
+	TestTrue("Should be able to accept re-created quest", Progression->AcceptQuest(Template.Identifier));
+	TestNull("Stale quest handle should not resolve compiled quest", Progression->GetCompiledQuest(FirstQ));
+	TestNull("Stale quest handle should not resolve state", Progression->GetQuest(FirstQ));
+	TestEqual("Stale quest handle should be unavailable", Progression->GetQuestStatus(FirstQ), ESuqsQuestStatus::Unavailable);
+	TestNull("Stale task handle should not resolve compiled task", Progression->GetCompiledTask(FirstTask));
+	TestNull("Stale task handle should not resolve state", Progression->GetTaskState(FirstTask));
+	TestFalse("Stale task handle should not complete", Progression->CompleteTask(FirstTask));
+	TestFalse("New task should be untouched", Progression->IsTaskCompleted(Template.Identifier, "T_ReachThePlace"));
+	TestEqual("Current handle should resolve", Progression->GetQuest(PrevQ), Progression->GetQuest(Template.Identifier));
+	TestNotNull("Current task handle should resolve", Progression->GetTaskState(PrevTask));
+
+	// Smaller quests fit in the freed task range too, and handles to other quests are unaffected
+	TestTrue("Delete runtime quest should work", Progression->DeleteQuestDefinition(Template.Identifier));
+	Template.Identifier = "Q_Small";
+	Template.Objectives.SetNum(1);
+	TestTrue("Small quest should be created", Progression->CreateQuestDefinition(Template));
+	TestEqual("Small quest should re-use the freed task range",
+		Progression->GetTaskHandle("Q_Small", "T_ReachThePlace").Index, FirstTask.Index);
+	TestEqual("Other quest handle should be unchanged", Progression->GetQuestHandle("Q_Main1"), MainQ);
+	TestEqual("Other task handle should be unchanged", Progression->GetTaskHandle("Q_Main1", "T_ReachThePlace"), MainTask);
+	TestTrue("Should be able to accept main quest", Progression->AcceptQuest("Q_Main1"));
+	TestTrue("Should be able to complete task by handle", Progression->CompleteTask(MainTask));
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FTestCompiledQuestFlags, "SUQSTest.CompiledQuestFlags",
+                                 EAutomationTestFlags::EditorContext |
+                                 EAutomationTestFlags::ClientContext |
+                                 EAutomationTestFlags::ProductFilter)
+
+bool FTestCompiledQuestFlags::RunTest(const FString& Parameters)
+{
+	USuqsProgression* Progression = NewObject<USuqsProgression>();
+	Progression->InitWithQuestDataTables(
+        TArray<UDataTable*> {
+        	USuqsProgression::MakeQuestDataTableFromJSON(SimpleMainQuestJson)
+        }
+    );
+
+	// Derived flags are computed when the definition is compiled
+	const FSuqsCompiledTask* ReachThePlace = Progression->GetCompiledTask(Progression->GetTaskHandle("Q_Main1", "T_ReachThePlace"));
+	const FSuqsCompiledTask* CollectDoobries = Progression->GetCompiledTask(Progression->GetTaskHandle("Q_Main1", "T_CollectDoobries"));
+	const FSuqsCompiledTask* Something1 = Progression->GetCompiledTask(Progression->GetTaskHandle("Q_Main1", "T_Something1"));
+	if (!TestNotNull("Compiled task should exist", ReachThePlace) ||
+		!TestNotNull("Compiled task should exist", CollectDoobries) ||
+		!TestNotNull("Compiled task should exist", Something1))
+		return false;
+	TestTrue("Mandatory sequential task should hide on complete", ReachThePlace->bHiddenOnCompleteOrFail);
+	TestFalse("Optional task should not hide on complete", CollectDoobries->bHiddenOnCompleteOrFail);
+	TestFalse("Non-sequential task should not hide on complete", Something1->bHiddenOnCompleteOrFail);
+
+	// States should pick up the same values as deriving them from the definition
+	TestTrue("Should be able to accept main quest", Progression->AcceptQuest("Q_Main1"));
+	const FSuqsQuest* QDef = Progression->GetQuestDefinition("Q_Main1");
+	const FSuqsCompiledQuest* CQ = Progression->GetCompiledQuest(Progression->GetQuestHandle("Q_Main1"));
+	if (!TestNotNull("Compiled quest should exist", CQ))
+		return false;
+	TestEqual("Title formatting flag", CQ->bTitleNeedsFormatting, USuqsProgression::GetTextNeedsFormatting(QDef->Title));
+	auto Q = Progression->GetQuest("Q_Main1");
+	for (int32 ObjIndex = 0; ObjIndex < Q->GetObjectives().Num(); ++ObjIndex)
+	{
+		auto Obj = Q->GetObjectives()[ObjIndex];
+		const FSuqsObjective& ObjDef = QDef->Objectives[ObjIndex];
+		int ExpectedMandatory = ObjDef.NumberOfMandatoryTasksRequired;
+		if (ExpectedMandatory == -1)
+		{
+			ExpectedMandatory = 0;
+			for (const auto& TaskDef : ObjDef.Tasks)
+			{
+				if (TaskDef.bMandatory)
+					++ExpectedMandatory;
+			}
+		}
+		TestEqual("Mandatory tasks needed should match definition", Obj->NumberOfMandatoryTasksRequired(), ExpectedMandatory);
+
+		for (int32 TaskIndex = 0; TaskIndex < ObjDef.Tasks.Num(); ++TaskIndex)
+		{
+			const FSuqsTask& TaskDef = ObjDef.Tasks[TaskIndex];
+			const bool bExpectedHidden = !TaskDef.bAlwaysVisible && TaskDef.bMandatory && ObjDef.bSequentialTasks;
+			TestEqual("Hidden on complete should match definition", Obj->GetTasks()[TaskIndex]->IsHiddenOnCompleteOrFail(), bExpectedHidden);
+		}
+	}
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FTestTaskStateProperties, "SUQSTest.TaskStateProperties",
+                                 EAutomationTestFlags::EditorContext |
+                                 EAutomationTestFlags::ClientContext |
+                                 EAutomationTestFlags::ProductFilter)
+
+bool FTestTaskStateProperties::RunTest(const FString& Parameters)
+{
+	USuqsProgression* Progression = NewObject<USuqsProgression>();
+	Progression->InitWithQuestDataTables(
+        TArray<UDataTable*> {
+        	USuqsProgression::MakeQuestDataTableFromJSON(SimpleMainQuestJson)
+        }
+    );
+
+	// Task state is exposed to Blueprints as properties, make sure they're still there and read through to the state
+	for (const FName PropName : { FName("Number"), FName("TimeRemaining"), FName("Status"), FName("bHidden"), FName("ResolveBarrier") })
+	{
+		const FProperty* Prop = FindFProperty<FProperty>(USuqsTaskState::StaticClass(), PropName);
+		if (TestNotNull(PropName.ToString() + " property should exist", Prop))
+		{
+			TestTrue(PropName.ToString() + " property should be visible to Blueprints", Prop->HasAnyPropertyFlags(CPF_BlueprintVisible));
+			TestTrue(PropName.ToString() + " property should be read-only", Prop->HasAnyPropertyFlags(CPF_BlueprintReadOnly));
+#if WITH_EDITORONLY_DATA
+			const FString& Getter = Prop->GetMetaData("BlueprintGetter");
+			TestNotNull(PropName.ToString() + " property should have a getter", USuqsTaskState::StaticClass()->FindFunctionByName(FName(Getter)));
+#endif
+		}
+	}
+
+	TestTrue("Should be able to accept main quest", Progression->AcceptQuest("Q_Main1"));
+	const FSuqsTaskHandle ReachThePlace = Progression->GetTaskHandle("Q_Main1", "T_ReachThePlace");
+	const FSuqsTaskHandle CollectDoobries = Progression->GetTaskHandle("Q_Main1", "T_CollectDoobries");
+
+	Progression->ProgressTask(CollectDoobries, 2);
+	USuqsTaskState* Doobries = Progression->GetTaskState(CollectDoobries);
+	TestEqual("Number should be updated", Doobries->GetNumber(), 2);
+	TestEqual("Status should be updated", Doobries->GetStatus(), ESuqsTaskStatus::InProgress);
+	Progression->CompleteTask(ReachThePlace);
+	USuqsTaskState* Place = Progression->GetTaskState(ReachThePlace);
+	TestEqual("Status should be updated", Place->GetStatus(), ESuqsTaskStatus::Completed);
+	TestTrue("Hidden should be updated", Place->GetHidden());
+
+	// A task state fetched before a change sees it, since it reads from the objective
+	Progression->ProgressTask(CollectDoobries, 1);
+	TestEqual("Existing task state should see changes", Doobries->GetNumber(), 3);
+
+	// Accepting again starts from scratch
+	Progression->RemoveQuest("Q_Main1");
+	TestTrue("Should be able to accept main quest again", Progression->AcceptQuest("Q_Main1"));
+	Doobries = Progression->GetTaskState(CollectDoobries);
+	TestEqual("Number should be reset", Doobries->GetNumber(), 0);
+	TestEqual("Status should be reset", Progression->GetTaskState(ReachThePlace)->GetStatus(), ESuqsTaskStatus::NotStarted);
+
+	return true;
+}
@@ -0,0 +1,129 @@
+#include "Misc/AutomationTest.h"
+#include "Engine.h"
+#include "SuqsProgression.h"
+#include "SuqsQuestJsonImporter.h"
+#include "TestQuestData.h"
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FTestQuestJsonImport, "SUQSTest.QuestJsonImport",
+								 EAutomationTestFlags::EditorContext |
+								 EAutomationTestFlags::ClientContext |
+								 EAutomationTestFlags::ProductFilter)
+
+bool FTestQuestJsonImport::RunTest(const FString& Parameters)
+{
+	// Compare against the DataTable import of the same JSON
+	for (const FString& Json : { SimpleMainQuestJson, BranchingQuestJson, NonAutoResolveQuestsJson })
+	{
+		UDataTable* Table = USuqsProgression::MakeQuestDataTableFromJSON(Json);
+
+		TArray<FSuqsQuest> Quests;
+		FString Error;
+		if (!TestTrue("Import should succeed", FSuqsQuestJsonImporter::Import(Json, Quests, Error)))
+		{
+			AddError(Error);
+			continue;
+		}
+		TestEqual("Should import same number of quests", Quests.Num(), Table->GetRowMap().Num());
+		for (const auto& Quest : Quests)
+		{
+			const FSuqsQuest* Expected = Table->FindRow<FSuqsQuest>(Quest.Identifier, "");
+			if (!TestNotNull("Quest should be in table", Expected))
+				continue;
+
+			TestEqual("Quest title", Quest.Title.ToString(), Expected->Title.ToString());
+			TestEqual("Quest auto accept", Quest.AutoAccept, Expected->AutoAccept);
+			TestEqual("Quest resolve automatically", Quest.bResolveAutomatically, Expected->bResolveAutomatically);
+			TestEqual("Quest resolve gate", Quest.ResolveGate, Expected->ResolveGate);
+			TestEqual("Quest prerequisites", Quest.PrerequisiteQuests, Expected->PrerequisiteQuests);
+			if (!TestEqual("Objective count", Quest.Objectives.Num(), Expected->Objectives.Num()))
+				continue;
+			for (int o = 0; o < Quest.Objectives.Num(); ++o)
+			{
+				const auto& Obj = Quest.Objectives[o];
+				const auto& ExpectedObj = Expected->Objectives[o];
+				TestEqual("Objective ID", Obj.Identifier, ExpectedObj.Identifier);
+				TestEqual("Objective branch", Obj.Branch, ExpectedObj.Branch);
+				TestEqual("Objective sequential", Obj.bSequentialTasks, ExpectedObj.bSequentialTasks);
+				if (!TestEqual("Task count", Obj.Tasks.Num(), ExpectedObj.Tasks.Num()))
+					continue;
+				for (int t = 0; t < Obj.Tasks.Num(); ++t)
+				{
+					TestEqual("Task ID", Obj.Tasks[t].Identifier, ExpectedObj.Tasks[t].Identifier);
+					TestEqual("Task title", Obj.Tasks[t].Title.ToString(), ExpectedObj.Tasks[t].Title.ToString());
+					TestEqual("Task target number", Obj.Tasks[t].TargetNumber, ExpectedObj.Tasks[t].TargetNumber);
+					TestEqual("Task mandatory", Obj.Tasks[t].bMandatory, ExpectedObj.Tasks[t].bMandatory);
+					TestEqual("Task resolve delay", Obj.Tasks[t].ResolveDelay, ExpectedObj.Tasks[t].ResolveDelay);
+				}
+			}
+		}
+	}
+
+	// Errors should report where they are
+	TArray<FSuqsQuest> Quests;
+	FString Error;
+	TestFalse("Bad value type should fail", FSuqsQuestJsonImporter::Import(TEXT("[\n  {\n    \"Identifier\": 3\n  }\n]"), Quests, Error));
+	TestTrue("Error should include line", Error.Contains(TEXT("line 3")));
+	TestFalse("Malformed JSON should fail", FSuqsQuestJsonImporter::Import(TEXT("[ { \"Identifier\": \"Q_Bad\", "), Quests, Error));
+	TestFalse("Error should be reported", Error.IsEmpty());
+	TestEqual("No quests on failure", Quests.Num(), 0);
+
+	// Progression entry point
+	USuqsProgression* Progression = NewObject<USuqsProgression>();
+	TestTrue("Create from JSON should work", Progression->CreateQuestDefinitionsFromJSON(SimpleMainQuestJson));
+	TestTrue("Should be able to accept quest created from JSON", Progression->AcceptQuest("Q_Main1"));
+	TestTrue("Task should complete", Progression->CompleteTask("Q_Main1", "T_ReachThePlace"));
+	AddExpectedError("not overwriting", EAutomationExpectedMessageFlags::Contains, 2, false);
+	TestFalse("Create again should report skipped quests", Progression->CreateQuestDefinitionsFromJSON(SimpleMainQuestJson));
+	TestTrue("Skipped quest should keep its progress", Progression->IsTaskCompleted("Q_Main1", "T_ReachThePlace"));
+	TestTrue("Create again with overwrite should add everything", Progression->CreateQuestDefinitionsFromJSON(SimpleMainQuestJson, true));
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FTestQuestJsonImportTime, "SUQSTest.Perf.QuestJsonImportTime",
+								 EAutomationTestFlags::EditorContext |
+								 EAutomationTestFlags::ClientContext |
+								 EAutomationTestFlags::PerfFilter)
+
+bool FTestQuestJsonImportTime::RunTest(const FString& Parameters)
+{
+	constexpr int NumQuests = 10000;
+
+	FString Json = TEXT("[");
+	for (int i = 0; i < NumQuests; ++i)
+	{
+		Json += FString::Printf(TEXT(R"RAWJSON(%s{
+			"Identifier": "Q_Gen%d",
+			"Title": "NSLOCTEXT(\"TestQuests\", \"GenTitle%d\", \"Generated Quest %d\")",
+			"AutoAccept": false,
+			"Objectives": [
+				{
+					"Identifier": "O1",
+					"Title": "NSLOCTEXT(\"TestQuests\", \"GenObjTitle%d\", \"Objective\")",
+					"Tasks": [
+						{ "Identifier": "T_1", "Title": "NSLOCTEXT(\"TestQuests\", \"GenTask1_%d\", \"Task 1\")", "TargetNumber": 1 },
+						{ "Identifier": "T_2", "Title": "NSLOCTEXT(\"TestQuests\", \"GenTask2_%d\", \"Task 2\")", "TargetNumber": 5 }
+					]
+				}
+			]
+		})RAWJSON"), i > 0 ? TEXT(",") : TEXT(""), i, i, i, i, i, i);
+	}
+	Json += TEXT("]");
+
+	double StartTime = FPlatformTime::Seconds();
+	UDataTable* Table = USuqsProgression::MakeQuestDataTableFromJSON(Json);
+	const double TableTime = FPlatformTime::Seconds() - StartTime;
+	TestEqual("All quests should be in table", Table->GetRowMap().Num(), NumQuests);
+
+	TArray<FSuqsQuest> Quests;
+	FString Error;
+	StartTime = FPlatformTime::Seconds();
+	FSuqsQuestJsonImporter::Import(Json, Quests, Error);
+	const double StreamTime = FPlatformTime::Seconds() - StartTime;
+	TestEqual("All quests should be imported", Quests.Num(), NumQuests);
+
+	AddInfo(FString::Printf(TEXT("%d quests (%d KB JSON): CreateTableFromJSONString %.1fms, streaming import %.1fms"),
+		NumQuests, Json.Len() * sizeof(TCHAR) / 1024, TableTime * 1000.0, StreamTime * 1000.0));
+
+	return true;
+}
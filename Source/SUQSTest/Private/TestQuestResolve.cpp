@@ -103,3 +103,313 @@ bool FTestQuestManualResolve::RunTest(const FString& Parameters)
 	
 	return true;
 }
+
+const FString GatedQuestsJson = R"RAWJSON([
+{
+    "Identifier": "Q_GateOrder",
+    "bPlayerVisible": true,
+    "Title": "NSLOCTEXT(\"TestQuests\", \"GateOrderTitle\", \"Quest and optional task on the same gate\")",
+    "DescriptionWhenActive": "",
+    "DescriptionWhenCompleted": "",
+    "AutoAccept": false,
+    "PrerequisiteQuests": [],
+    "PrerequisiteQuestFailures": [],
+    "ResolveGate": "G_Order",
+    "Objectives": [
+        {
+            "Identifier": "O_Single",
+            "Title": "NSLOCTEXT(\"TestQuests\", \"GateOrderO1\", \"Single objective\")",
+            "bSequentialTasks": false,
+            "Tasks": [
+                {
+                    "Identifier": "T_Mandatory",
+                    "Title": "NSLOCTEXT(\"TestQuests\", \"GateOrderT1\", \"Ungated mandatory task\")",
+                    "bMandatory": true
+                },
+                {
+                    "Identifier": "T_Optional",
+                    "Title": "NSLOCTEXT(\"TestQuests\", \"GateOrderT2\", \"Gated optional task\")",
+                    "bMandatory": false,
+                    "ResolveGate": "G_Order"
+                }
+            ]
+        }
+    ]
+},
+{
+    "Identifier": "Q_GateArchive",
+    "bPlayerVisible": true,
+    "Title": "NSLOCTEXT(\"TestQuests\", \"GateArchiveTitle\", \"Quest with an ungated quest and gated optional task\")",
+    "DescriptionWhenActive": "",
+    "DescriptionWhenCompleted": "",
+    "AutoAccept": false,
+    "PrerequisiteQuests": [],
+    "PrerequisiteQuestFailures": [],
+    "Objectives": [
+        {
+            "Identifier": "O_Single",
+            "Title": "NSLOCTEXT(\"TestQuests\", \"GateArchiveO1\", \"Single objective\")",
+            "bSequentialTasks": false,
+            "Tasks": [
+                {
+                    "Identifier": "T_Mandatory",
+                    "Title": "NSLOCTEXT(\"TestQuests\", \"GateArchiveT1\", \"Ungated mandatory task\")",
+                    "bMandatory": true
+                },
+                {
+                    "Identifier": "T_Optional",
+                    "Title": "NSLOCTEXT(\"TestQuests\", \"GateArchiveT2\", \"Gated optional task\")",
+                    "bMandatory": false,
+                    "ResolveGate": "G_Archive"
+                }
+            ]
+        }
+    ]
+},
+{
+    "Identifier": "Q_GateChainA",
+    "bPlayerVisible": true,
+    "Title": "NSLOCTEXT(\"TestQuests\", \"GateChainATitle\", \"First quest in a gated chain\")",
+    "DescriptionWhenActive": "",
+    "DescriptionWhenCompleted": "",
+    "AutoAccept": false,
+    "PrerequisiteQuests": [],
+    "PrerequisiteQuestFailures": [],
+    "Objectives": [
+        {
+            "Identifier": "O_Single",
+            "Title": "NSLOCTEXT(\"TestQuests\", \"GateChainAO1\", \"Single objective\")",
+            "Tasks": [
+                {
+                    "Identifier": "T_A",
+                    "Title": "NSLOCTEXT(\"TestQuests\", \"GateChainAT1\", \"Gated task\")",
+                    "bMandatory": true,
+                    "ResolveGate": "G_Chain"
+                }
+            ]
+        }
+    ]
+},
+{
+    "Identifier": "Q_GateChainB",
+    "bPlayerVisible": true,
+    "Title": "NSLOCTEXT(\"TestQuests\", \"GateChainBTitle\", \"Second quest in a gated chain\")",
+    "DescriptionWhenActive": "",
+    "DescriptionWhenCompleted": "",
+    "AutoAccept": true,
+    "PrerequisiteQuests": ["Q_GateChainA"],
+    "PrerequisiteQuestFailures": [],
+    "ResolveGate": "G_Chain",
+    "Objectives": [
+        {
+            "Identifier": "O_Single",
+            "Title": "NSLOCTEXT(\"TestQuests\", \"GateChainBO1\", \"Single objective\")",
+            "Tasks": [
+                {
+                    "Identifier": "T_B",
+                    "Title": "NSLOCTEXT(\"TestQuests\", \"GateChainBT1\", \"Gated task\")",
+                    "bMandatory": true,
+                    "ResolveGate": "G_Chain"
+                }
+            ]
+        }
+    ]
+}
+])RAWJSON";
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FTestQuestGateOpenBeforeBarrier,
+								 "SUQSTest.QuestGateOpenBeforeBarrier",
+								 EAutomationTestFlags::EditorContext |
+								 EAutomationTestFlags::ClientContext |
+								 EAutomationTestFlags::ProductFilter)
+
+bool FTestQuestGateOpenBeforeBarrier::RunTest(const FString& Parameters)
+{
+	USuqsProgression* Progression = NewObject<USuqsProgression>();
+
+	Progression->InitWithQuestDataTables(
+		TArray<UDataTable*> {
+			USuqsProgression::MakeQuestDataTableFromJSON(NonAutoResolveQuestsJson)
+		}
+	);
+
+	// Gate is open before anything waits on it, so nothing should be blocked
+	Progression->SetGateOpen("TestGate", true);
+	TestTrue("Gate should be open", Progression->IsGateOpen("TestGate"));
+	TestTrue("Accept gated resolve quest", Progression->AcceptQuest("Q_GatedResolve"));
+	TestTrue("Complete task", Progression->CompleteTask("Q_GatedResolve", "T_Single"));
+	TestTrue("Quest should be complete straight away", Progression->IsQuestCompleted("Q_GatedResolve"));
+	TestFalse("Quest should be archived straight away", Progression->IsQuestActive("Q_GatedResolve"));
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FTestQuestGateCloseReopen,
+								 "SUQSTest.QuestGateCloseReopen",
+								 EAutomationTestFlags::EditorContext |
+								 EAutomationTestFlags::ClientContext |
+								 EAutomationTestFlags::ProductFilter)
+
+bool FTestQuestGateCloseReopen::RunTest(const FString& Parameters)
+{
+	USuqsProgression* Progression = NewObject<USuqsProgression>();
+
+	Progression->InitWithQuestDataTables(
+		TArray<UDataTable*> {
+			USuqsProgression::MakeQuestDataTableFromJSON(NonAutoResolveQuestsJson)
+		}
+	);
+
+	Progression->SetGateOpen("TestGate", true);
+	Progression->SetGateOpen("TestGate", false);
+	TestFalse("Gate should be closed", Progression->IsGateOpen("TestGate"));
+
+	TestTrue("Accept gated resolve quest", Progression->AcceptQuest("Q_GatedResolve"));
+	TestTrue("Complete task", Progression->CompleteTask("Q_GatedResolve", "T_Single"));
+	TestTrue("Task resolve should be blocked by the closed gate", Progression->GetTaskState("Q_GatedResolve", "T_Single")->IsResolveBlocked());
+	TestFalse("Quest shouldn't be complete yet", Progression->IsQuestCompleted("Q_GatedResolve"));
+
+	Progression->SetGateOpen("TestGate", true);
+	TestTrue("Quest should be complete after gate reopened", Progression->IsQuestCompleted("Q_GatedResolve"));
+	TestFalse("Quest should be archived", Progression->IsQuestActive("Q_GatedResolve"));
+
+	// Opening again with nothing waiting does nothing
+	Progression->SetGateOpen("TestGate", true);
+	TestTrue("Gate should still be open", Progression->IsGateOpen("TestGate"));
+
+	// Closing again should block the same quest when it's repeated
+	Progression->SetGateOpen("TestGate", false);
+	TestTrue("Accept completed quest again", Progression->AcceptQuest("Q_GatedResolve", true, true));
+	TestTrue("Complete task", Progression->CompleteTask("Q_GatedResolve", "T_Single"));
+	TestTrue("Task resolve should be blocked again", Progression->GetTaskState("Q_GatedResolve", "T_Single")->IsResolveBlocked());
+	TestTrue("Quest should still be active", Progression->IsQuestActive("Q_GatedResolve"));
+	Progression->SetGateOpen("TestGate", true);
+	TestTrue("Quest should be complete after gate reopened again", Progression->IsQuestCompleted("Q_GatedResolve"));
+	TestFalse("Quest should be archived again", Progression->IsQuestActive("Q_GatedResolve"));
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FTestQuestGateWaiterRemoved,
+								 "SUQSTest.QuestGateWaiterRemoved",
+								 EAutomationTestFlags::EditorContext |
+								 EAutomationTestFlags::ClientContext |
+								 EAutomationTestFlags::ProductFilter)
+
+bool FTestQuestGateWaiterRemoved::RunTest(const FString& Parameters)
+{
+	USuqsProgression* Progression = NewObject<USuqsProgression>();
+
+	Progression->InitWithQuestDataTables(
+		TArray<UDataTable*> {
+			USuqsProgression::MakeQuestDataTableFromJSON(NonAutoResolveQuestsJson),
+			USuqsProgression::MakeQuestDataTableFromJSON(GatedQuestsJson)
+		}
+	);
+
+	// Waiting task whose quest is removed
+	TestTrue("Accept gated resolve quest", Progression->AcceptQuest("Q_GatedResolve"));
+	TestTrue("Complete task", Progression->CompleteTask("Q_GatedResolve", "T_Single"));
+	Progression->RemoveQuest("Q_GatedResolve");
+	Progression->SetGateOpen("TestGate", true);
+	TestFalse("Removed quest should not be active", Progression->IsQuestActive("Q_GatedResolve"));
+	TestFalse("Removed quest should not be completed by the gate", Progression->IsQuestCompleted("Q_GatedResolve"));
+	Progression->SetGateOpen("TestGate", false);
+
+	// Removed while waiting then accepted again, which re-uses the same quest state
+	TestTrue("Accept gated resolve quest", Progression->AcceptQuest("Q_GatedResolve"));
+	TestTrue("Complete task", Progression->CompleteTask("Q_GatedResolve", "T_Single"));
+	Progression->RemoveQuest("Q_GatedResolve");
+	TestTrue("Accept gated resolve quest again", Progression->AcceptQuest("Q_GatedResolve"));
+	TestFalse("Re-accepted task should not be complete", Progression->IsTaskCompleted("Q_GatedResolve", "T_Single"));
+	Progression->SetGateOpen("TestGate", true);
+	TestTrue("Re-accepted quest should still be active", Progression->IsQuestActive("Q_GatedResolve"));
+	TestFalse("Re-accepted quest should not be completed by the stale waiter", Progression->IsQuestCompleted("Q_GatedResolve"));
+	TestTrue("Complete task", Progression->CompleteTask("Q_GatedResolve", "T_Single"));
+	TestTrue("Re-accepted quest should complete through the open gate", Progression->IsQuestCompleted("Q_GatedResolve"));
+
+	// Waiting task whose quest is archived
+	TestTrue("Accept archive quest", Progression->AcceptQuest("Q_GateArchive"));
+	TestTrue("Complete optional task", Progression->CompleteTask("Q_GateArchive", "T_Optional"));
+	Progression->FailTask("Q_GateArchive", "T_Mandatory");
+	TestTrue("Quest should have failed", Progression->IsQuestFailed("Q_GateArchive"));
+	TestFalse("Quest should be archived", Progression->IsQuestActive("Q_GateArchive"));
+	Progression->SetGateOpen("G_Archive", true);
+	TestTrue("Archived quest should still be failed", Progression->IsQuestFailed("Q_GateArchive"));
+	TestFalse("Archived quest should still be archived", Progression->IsQuestActive("Q_GateArchive"));
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FTestQuestGateCascade,
+								 "SUQSTest.QuestGateCascade",
+								 EAutomationTestFlags::EditorContext |
+								 EAutomationTestFlags::ClientContext |
+								 EAutomationTestFlags::ProductFilter)
+
+bool FTestQuestGateCascade::RunTest(const FString& Parameters)
+{
+	USuqsProgression* Progression = NewObject<USuqsProgression>();
+
+	Progression->InitWithQuestDataTables(
+		TArray<UDataTable*> {
+			USuqsProgression::MakeQuestDataTableFromJSON(GatedQuestsJson)
+		}
+	);
+
+	TestTrue("Accept first chain quest", Progression->AcceptQuest("Q_GateChainA"));
+	TestTrue("Complete task", Progression->CompleteTask("Q_GateChainA", "T_A"));
+	TestFalse("First chain quest shouldn't be complete yet", Progression->IsQuestCompleted("Q_GateChainA"));
+	TestFalse("Second chain quest shouldn't be accepted yet", Progression->IsQuestAccepted("Q_GateChainB"));
+
+	// Opening completes the first quest while notifying, which auto-accepts the second; that waits on the same gate
+	Progression->SetGateOpen("G_Chain", true);
+	TestTrue("First chain quest should be complete", Progression->IsQuestCompleted("Q_GateChainA"));
+	TestTrue("Second chain quest should have been accepted", Progression->IsQuestActive("Q_GateChainB"));
+	TestTrue("Complete task", Progression->CompleteTask("Q_GateChainB", "T_B"));
+	TestFalse("Task on the open gate should not be blocked", Progression->GetTaskState("Q_GateChainB", "T_B")->IsResolveBlocked());
+	TestTrue("Second chain quest should complete through the open gate", Progression->IsQuestCompleted("Q_GateChainB"));
+	TestFalse("Second chain quest should be archived", Progression->IsQuestActive("Q_GateChainB"));
+
+	// Closing and reopening the same gate after a cascade still works
+	Progression->SetGateOpen("G_Chain", false);
+	TestTrue("Accept second chain quest again", Progression->AcceptQuest("Q_GateChainB", true, true));
+	TestTrue("Complete task", Progression->CompleteTask("Q_GateChainB", "T_B"));
+	TestTrue("Task should be blocked again", Progression->GetTaskState("Q_GateChainB", "T_B")->IsResolveBlocked());
+	Progression->SetGateOpen("G_Chain", true);
+	TestTrue("Second chain quest should complete after reopening", Progression->IsQuestCompleted("Q_GateChainB"));
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FTestQuestGateTasksBeforeQuests,
+								 "SUQSTest.QuestGateTasksBeforeQuests",
+								 EAutomationTestFlags::EditorContext |
+								 EAutomationTestFlags::ClientContext |
+								 EAutomationTestFlags::ProductFilter)
+
+bool FTestQuestGateTasksBeforeQuests::RunTest(const FString& Parameters)
+{
+	USuqsProgression* Progression = NewObject<USuqsProgression>();
+
+	Progression->InitWithQuestDataTables(
+		TArray<UDataTable*> {
+			USuqsProgression::MakeQuestDataTableFromJSON(GatedQuestsJson)
+		}
+	);
+
+	TestTrue("Accept order quest", Progression->AcceptQuest("Q_GateOrder"));
+	// Optional task waits on the gate first, then the quest completes and waits on the same gate
+	TestTrue("Complete optional task", Progression->CompleteTask("Q_GateOrder", "T_Optional"));
+	TestTrue("Optional task should be blocked", Progression->GetTaskState("Q_GateOrder", "T_Optional")->IsResolveBlocked());
+	TestTrue("Complete mandatory task", Progression->CompleteTask("Q_GateOrder", "T_Mandatory"));
+	TestTrue("Quest should be complete", Progression->IsQuestCompleted("Q_GateOrder"));
+	TestTrue("Quest should be blocked on the gate", Progression->GetQuest("Q_GateOrder")->IsResolveBlocked());
+
+	// Tasks are released before quests, otherwise the quest would be archived with its task still blocked
+	Progression->SetGateOpen("G_Order", true);
+	TestFalse("Quest should be archived", Progression->IsQuestActive("Q_GateOrder"));
+	TestFalse("Optional task should have been resolved before the quest", Progression->GetTaskState("Q_GateOrder", "T_Optional")->IsResolveBlocked());
+
+	return true;
+}
@@ -178,5 +178,166 @@ bool FTestQuestSerialize::RunTest(const FString& Parameters)
 	
 	
 	
+	return true;
+}
+
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FTestArchivedQuestRecords, "SUQSTest.ArchivedQuestRecords",
+                                 EAutomationTestFlags::EditorContext |
+                                 EAutomationTestFlags::ClientContext |
+                                 EAutomationTestFlags::ProductFilter)
+
+bool FTestArchivedQuestRecords::RunTest(const FString& Parameters)
+{
+	USuqsProgression* Progression = NewObject<USuqsProgression>();
+	TArray<UDataTable*> QuestTables
+	{
+		USuqsProgression::MakeQuestDataTableFromJSON(SmallestPossibleQuestJson),
+		USuqsProgression::MakeQuestDataTableFromJSON(OrderedTasksQuestJson),
+		USuqsProgression::MakeQuestDataTableFromJSON(TargetNumberQuestJson)
+	};
+	Progression->InitWithQuestDataTables(QuestTables);
+
+	TestTrue("Accept quest should work", Progression->AcceptQuest("Q_Smol"));
+	TestTrue("Accept quest should work", Progression->AcceptQuest("Q_Ordered"));
+	TestTrue("Accept quest should work", Progression->AcceptQuest("Q_TargetNumbers"));
+	TestTrue("Complete smol task should work", Progression->CompleteTask("Q_Smol", "T_Smol"));
+	TestTrue("Complete ordered task should work", Progression->CompleteTask("Q_Ordered", "T_1"));
+	TestTrue("Complete ordered task should work", Progression->CompleteTask("Q_Ordered", "T_2"));
+	TestTrue("Complete ordered task should work", Progression->CompleteTask("Q_Ordered", "T_3"));
+	Progression->FailTask("Q_Ordered", "T_11");
+	TestTrue("Ordered quest should have failed", Progression->IsQuestFailed("Q_Ordered"));
+	TestEqual("Remaining number should be correct", Progression->ProgressTask("Q_TargetNumbers", "T_TargetOf3", 2), 1);
+	TestEqual("Nothing should be compacted before loading", Progression->GetNumCompactArchivedQuests(), 0);
+
+	FSuqsSaveData Data;
+	Progression->SaveToData(Data);
+
+	USuqsProgression* Loaded = NewObject<USuqsProgression>();
+	Loaded->InitWithQuestDataTables(QuestTables);
+	Loaded->LoadFromData(Data);
+
+	// Archived quests are loaded as records, active ones as states
+	TestEqual("Archived quests should be compact after loading", Loaded->GetNumCompactArchivedQuests(), 2);
+	TestTrue("Record memory should be reported", Loaded->GetArchivedQuestRecordsAllocatedSize() > 0);
+	TestTrue("Smol quest should be completed", Loaded->IsQuestCompleted("Q_Smol"));
+	TestTrue("Ordered quest should be failed", Loaded->IsQuestFailed("Q_Ordered"));
+	TestEqual("Status by handle should be failed", Loaded->GetQuestStatus(Loaded->GetQuestHandle("Q_Ordered")), ESuqsQuestStatus::Failed);
+	TArray<FName> ArchivedIDs;
+	Loaded->GetArchivedQuestIdentifiers(ArchivedIDs);
+	TestEqual("Both archived quests should be listed", ArchivedIDs.Num(), 2);
+	TestTrue("Target number quest should be active", Loaded->IsQuestActive("Q_TargetNumbers"));
+	TestEqual("Status queries shouldn't rebuild states", Loaded->GetNumCompactArchivedQuests(), 2);
+
+	// Saving doesn't need the states either, and must keep everything
+	FSuqsSaveData Resaved;
+	Loaded->SaveToData(Resaved);
+	TestEqual("Resaved data should have all quests", Resaved.QuestData.Num(), Data.QuestData.Num());
+	TestEqual("Saving shouldn't rebuild states", Loaded->GetNumCompactArchivedQuests(), 2);
+
+	UCallbackCatcher* CallbackCatcher = NewObject<UCallbackCatcher>();
+	CallbackCatcher->Subscribe(Loaded);
+
+	// Objective, task and branch queries are answered from the records, and must match the rebuilt state
+	TestTrue("Task 3 should be completed", Loaded->IsTaskCompleted("Q_Ordered", "T_3"));
+	// Task status isn't saved, it's derived from progress; T_11 was failed without any, so it loads as incomplete
+	TestTrue("Task 11 should be incomplete", Loaded->IsTaskIncomplete("Q_Ordered", "T_11"));
+	TestTrue("Task 12 should be untouched", Loaded->IsTaskIncomplete("Q_Ordered", "T_12"));
+	TestFalse("Unknown task should not be incomplete", Loaded->IsTaskIncomplete("Q_Ordered", "T_DoesNotExist"));
+	const FSuqsQuest* OrderedDef = Loaded->GetQuestDefinition("Q_Ordered");
+	TArray<bool> ObjectivesCompleted, ObjectivesFailed, TasksCompleted, TasksFailed, TasksIncomplete;
+	for (const auto& ObjDef : OrderedDef->Objectives)
+	{
+		ObjectivesCompleted.Add(Loaded->IsObjectiveCompleted("Q_Ordered", ObjDef.Identifier));
+		ObjectivesFailed.Add(Loaded->IsObjectiveFailed("Q_Ordered", ObjDef.Identifier));
+		for (const auto& TaskDef : ObjDef.Tasks)
+		{
+			TasksCompleted.Add(Loaded->IsTaskCompleted("Q_Ordered", TaskDef.Identifier));
+			TasksFailed.Add(Loaded->IsTaskFailed("Q_Ordered", TaskDef.Identifier));
+			TasksIncomplete.Add(Loaded->IsTaskIncomplete("Q_Ordered", TaskDef.Identifier));
+		}
+	}
+	TestFalse("Branch should not be active", Loaded->IsQuestBranchActive("Q_Ordered", "SomeBranch"));
+	TestTrue("No branch should be active", Loaded->IsQuestBranchActive("Q_Ordered", NAME_None));
+
+	// Nothing which only reads rebuilds a state
+	TestNull("Handle lookup should not rebuild the state", Loaded->GetQuest(Loaded->GetQuestHandle("Q_Ordered")));
+	TestNull("Task state lookup should not rebuild the state", Loaded->GetTaskState("Q_Ordered", "T_3"));
+	TArray<USuqsQuestState*> Archived;
+	Loaded->GetArchivedQuests(Archived);
+	TestEqual("Compact archived quests should not be listed as states", Archived.Num(), 0);
+	TestEqual("Queries shouldn't rebuild states", Loaded->GetNumCompactArchivedQuests(), 2);
+
+	// Records can be read directly
+	const FSuqsArchivedQuestRecord* Record = Loaded->GetArchivedQuestRecord("Q_Ordered");
+	if (TestNotNull("Ordered quest record should exist", Record))
+	{
+		TestEqual("Record should be failed", Record->Status, ESuqsQuestStatus::Failed);
+	}
+	int NumRecords = 0;
+	Loaded->ForEachArchivedQuest([&NumRecords](const FName&, const USuqsQuestState* State, const FSuqsArchivedQuestRecord* Rec)
+	{
+		if (Rec && !State)
+			++NumRecords;
+	});
+	TestEqual("Both records should be visited", NumRecords, 2);
+
+	// Getting the quest by identifier rebuilds it
+	auto Q = Loaded->GetQuest("Q_Ordered");
+	TestEqual("Ordered quest should have been rebuilt", Loaded->GetNumCompactArchivedQuests(), 1);
+	TestNull("Rebuilt quest should have no record", Loaded->GetArchivedQuestRecord("Q_Ordered"));
+	if (TestNotNull("Ordered quest state should exist", Q))
+	{
+		TestEqual("Rebuilt quest should be failed", Q->GetStatus(), ESuqsQuestStatus::Failed);
+		TestFalse("Rebuilt quest should not be waiting to resolve", Q->GetResolveBarrier().bPending);
+		TestEqual("Handle should find the same state", Loaded->GetQuest(Loaded->GetQuestHandle("Q_Ordered")), Q);
+		int ObjIndex = 0, TaskIndex = 0;
+		for (const auto Obj : Q->GetObjectives())
+		{
+			TestEqual("Objective completed should match record", Obj->IsCompleted(), ObjectivesCompleted[ObjIndex]);
+			TestEqual("Objective failed should match record", Obj->IsFailed(), ObjectivesFailed[ObjIndex]);
+			++ObjIndex;
+			for (const auto Task : Obj->GetTasks())
+			{
+				TestEqual("Task completed should match record", Task->IsCompleted(), TasksCompleted[TaskIndex]);
+				TestEqual("Task failed should match record", Task->IsFailed(), TasksFailed[TaskIndex]);
+				TestEqual("Task incomplete should match record", Task->IsIncomplete(), TasksIncomplete[TaskIndex]);
+				++TaskIndex;
+			}
+		}
+	}
+	TestEqual("Rebuilding should not raise events", CallbackCatcher->ProgressionEvents.Num(), 0);
+	TestTrue("Ordered quest should still be failed", Loaded->IsQuestFailed("Q_Ordered"));
+
+	// Compact again; the archive lists only full states, identifiers list everything
+	TestEqual("One quest should be compacted", Loaded->CompactArchivedQuests(), 1);
+	TestEqual("Both archived quests should be compact", Loaded->GetNumCompactArchivedQuests(), 2);
+	Loaded->GetArchivedQuests(Archived);
+	TestEqual("Compact archived quests should not be listed as states", Archived.Num(), 0);
+	Loaded->GetArchivedQuestIdentifiers(ArchivedIDs);
+	TestEqual("Archived identifiers should include compact quests", ArchivedIDs.Num(), 2);
+	TestEqual("Listing the archive shouldn't rebuild states", Loaded->GetNumCompactArchivedQuests(), 2);
+	TestTrue("Task 2 should still be completed", Loaded->IsTaskCompleted("Q_Ordered", "T_2"));
+	TestTrue("Smol task should still be completed", Loaded->IsTaskCompleted("Q_Smol", "T_Smol"));
+
+	// Compact records can be removed and accepted again
+	Loaded->CompactArchivedQuests();
+	Loaded->RemoveQuest("Q_Smol");
+	TestFalse("Removed quest should not be accepted", Loaded->IsQuestAccepted("Q_Smol"));
+	TestNull("Removed quest should have no state", Loaded->GetQuest("Q_Smol"));
+	TestTrue("Accept removed quest should work", Loaded->AcceptQuest("Q_Smol"));
+	TestTrue("Re-accepted quest should be incomplete", Loaded->IsTaskIncomplete("Q_Smol", "T_Smol"));
+	TestTrue("Failed quest can be accepted again", Loaded->AcceptQuest("Q_Ordered"));
+	TestTrue("Reset quest should be active", Loaded->IsQuestActive("Q_Ordered"));
+	TestEqual("Nothing should be compact after re-accepting", Loaded->GetNumCompactArchivedQuests(), 0);
+
+	// Records saved without being rebuilt load the same way
+	USuqsProgression* Reloaded = NewObject<USuqsProgression>();
+	Reloaded->InitWithQuestDataTables(QuestTables);
+	Reloaded->LoadFromData(Resaved);
+	TestTrue("Task 3 should be completed after resave", Reloaded->IsTaskCompleted("Q_Ordered", "T_3"));
+	TestTrue("Ordered quest should be failed after resave", Reloaded->IsQuestFailed("Q_Ordered"));
+	TestEqual("Target number task should keep progress", Reloaded->GetTaskState("Q_TargetNumbers", "T_TargetOf3")->GetNumber(), 2);
+
 	return true;
 }
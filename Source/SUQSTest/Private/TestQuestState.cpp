@@ -1,4 +1,5 @@
 #include "Misc/AutomationTest.h"
+#include "Tests/AutomationCommon.h"
 #include "Engine.h"
 #include "Suqs.h"
 #include "SuqsObjectiveState.h"
@@ -65,6 +66,8 @@ bool FTestQuestAcceptFailedComplete::RunTest(const FString& Parameters)
 	TestEqual("Smol quest should be incomplete again", Progression->GetQuestStatus("Q_Smol"), ESuqsQuestStatus::Incomplete);
 	// remove so we can go again
 	Progression->RemoveQuest("Q_Smol");
+	TestFalse("Smol quest should no longer be accepted", Progression->IsQuestAccepted("Q_Smol"));
+	TestEqual("Smol quest should be unavailable", Progression->GetQuestStatus("Q_Smol"), ESuqsQuestStatus::Unavailable);
 
 	// Test accepting completed
 	TestTrue("Accept smallest quest", Progression->AcceptQuest("Q_Smol"));
@@ -204,6 +207,57 @@ bool FTestQuestOrderedTasks::RunTest(const FString& Parameters)
 	return true;
 }
 
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FTestQuestOrderedTasksReset, "SUQSTest.QuestOrderedTasksReset",
+    EAutomationTestFlags::EditorContext |
+    EAutomationTestFlags::ClientContext |
+    EAutomationTestFlags::ProductFilter)
+
+bool FTestQuestOrderedTasksReset::RunTest(const FString& Parameters)
+{
+	USuqsProgression* Progression = NewObject<USuqsProgression>();
+	Progression->InitWithQuestDataTables(
+        TArray<UDataTable*> {
+            USuqsProgression::MakeQuestDataTableFromJSON(OrderedTasksQuestJson)
+        }
+    );
+
+	TestTrue("Accept quest should work", Progression->AcceptQuest("Q_Ordered"));
+	auto T1 = Progression->GetTaskState("Q_Ordered", "T_1");
+	auto T2 = Progression->GetTaskState("Q_Ordered", "T_2");
+	auto T3 = Progression->GetTaskState("Q_Ordered", "T_3");
+
+	TestEqual("Task 1 should be next", Progression->GetNextMandatoryTask("Q_Ordered"), T1);
+	TestFalse("Task 1 should be visible", T1->GetHidden());
+	TestTrue("Task 2 should be hidden", T2->GetHidden());
+	TestTrue("Task 3 should be hidden", T3->GetHidden());
+
+	TestTrue("Task 1 should complete OK", T1->Complete());
+	TestTrue("Task 2 should complete OK", T2->Complete());
+	TestEqual("Task 3 should be next", Progression->GetNextMandatoryTask("Q_Ordered"), T3);
+	TestTrue("Task 1 should be hidden", T1->GetHidden());
+	TestTrue("Task 2 should be hidden", T2->GetHidden());
+	TestFalse("Task 3 should be visible", T3->GetHidden());
+
+	// Going backwards should make the earlier task next again
+	T1->Reset();
+	TestEqual("Task 1 should be next again", Progression->GetNextMandatoryTask("Q_Ordered"), T1);
+	TestFalse("Task 1 should be visible again", T1->GetHidden());
+	TestTrue("Task 2 should still be hidden", T2->GetHidden());
+	TestTrue("Task 3 should be hidden again", T3->GetHidden());
+	// Suppress the warnings this will raise
+	LogSUQS.SetVerbosity(ELogVerbosity::NoLogging);
+	TestFalse("Should not be allowed to complete task out of order", T3->Complete());
+	LogSUQS.SetVerbosity(ELogVerbosity::Verbose);
+
+	TestTrue("Task 1 should complete OK again", T1->Complete());
+	TestEqual("Task 3 should be next again", Progression->GetNextMandatoryTask("Q_Ordered"), T3);
+	TestFalse("Task 3 should be visible again", T3->GetHidden());
+	TestTrue("Task 3 should complete OK", T3->Complete());
+	TestEqual("Should be on the second objective", Progression->GetQuest("Q_Ordered")->GetCurrentObjective()->GetIdentifier(), FName("O2"));
+
+	return true;
+}
+
 IMPLEMENT_SIMPLE_AUTOMATION_TEST(FTestQuestUnorderedTasks, "SUQSTest.QuestUnorderedTasks",
     EAutomationTestFlags::EditorContext |
     EAutomationTestFlags::ClientContext |
@@ -229,6 +283,46 @@ bool FTestQuestUnorderedTasks::RunTest(const FString& Parameters)
 	return true;
 }
 
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FTestQuestWildcardTasks, "SUQSTest.QuestWildcardTasks",
+    EAutomationTestFlags::EditorContext |
+    EAutomationTestFlags::ClientContext |
+    EAutomationTestFlags::ProductFilter)
+
+bool FTestQuestWildcardTasks::RunTest(const FString& Parameters)
+{
+
+	USuqsProgression* Progression = NewObject<USuqsProgression>();
+	Progression->InitWithQuestDataTables(
+        TArray<UDataTable*> {
+            USuqsProgression::MakeQuestDataTableFromJSON(OrderedTasksQuestJson),
+            USuqsProgression::MakeQuestDataTableFromJSON(UnorderedTasksQuestJson)
+        }
+    );
+
+	TestFalse("Wildcard complete should fail with no active quests", Progression->CompleteTask(NAME_None, "T_1"));
+	TestTrue("Accept quest should work", Progression->AcceptQuest("Q_Ordered"));
+	TestTrue("Accept quest should work", Progression->AcceptQuest("Q_Unordered"));
+
+	// Same task identifiers in both quests
+	TestTrue("Wildcard complete should work", Progression->CompleteTask(NAME_None, "T_1"));
+	TestTrue("Task should be complete in first quest", Progression->IsTaskCompleted("Q_Ordered", "T_1"));
+	TestTrue("Task should be complete in second quest", Progression->IsTaskCompleted("Q_Unordered", "T_1"));
+	Progression->ProgressTask(NAME_None, "T_2", 1);
+	TestTrue("Task should be complete in first quest", Progression->IsTaskCompleted("Q_Ordered", "T_2"));
+	TestTrue("Task should be complete in second quest", Progression->IsTaskCompleted("Q_Unordered", "T_2"));
+	Progression->SetTaskNumberCompleted(NAME_None, "T_3", 1);
+	TestTrue("Second quest should be complete now", Progression->IsQuestCompleted("Q_Unordered"));
+	TestTrue("First quest should still be incomplete", Progression->IsQuestIncomplete("Q_Ordered"));
+
+	// Archived quests should not be affected by wildcards
+	Progression->FailTask(NAME_None, "T_2");
+	TestTrue("First quest should be failed", Progression->IsQuestFailed("Q_Ordered"));
+	TestTrue("Archived quest should not have been affected", Progression->IsQuestCompleted("Q_Unordered"));
+	TestTrue("Archived task should not have been affected", Progression->IsTaskCompleted("Q_Unordered", "T_2"));
+	
+	return true;
+}
+
 IMPLEMENT_SIMPLE_AUTOMATION_TEST(FTestQuestAny2OfTasks, "SUQSTest.QuestAny2OfTasks",
     EAutomationTestFlags::EditorContext |
     EAutomationTestFlags::ClientContext |
@@ -529,3 +623,509 @@ bool FTestContinueOnFailObjective::RunTest(const FString& Parameters)
 
 	return true;	
 }
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FTestQuestStatePool, "SUQSTest.QuestStatePool",
+                                 EAutomationTestFlags::EditorContext |
+                                 EAutomationTestFlags::ClientContext |
+                                 EAutomationTestFlags::ProductFilter)
+
+bool FTestQuestStatePool::RunTest(const FString& Parameters)
+{
+	USuqsProgression* Progression = NewObject<USuqsProgression>();
+	Progression->InitWithQuestDataTables(
+        TArray<UDataTable*> {
+        	USuqsProgression::MakeQuestDataTableFromJSON(SimpleMainQuestJson)
+        }
+    );
+
+	TestTrue("Should be able to accept main quest", Progression->AcceptQuest("Q_Main1"));
+	USuqsQuestState* Q = Progression->GetQuest("Q_Main1");
+	USuqsTaskState* Doobries = Progression->GetTaskState("Q_Main1", "T_CollectDoobries");
+	Progression->CompleteTask("Q_Main1", "T_ReachThePlace");
+	Progression->ProgressTask("Q_Main1", "T_CollectDoobries", 2);
+
+	// Accepting again after removing re-uses the same states, starting from scratch
+	Progression->RemoveQuest("Q_Main1");
+	TestTrue("Should be able to accept main quest again", Progression->AcceptQuest("Q_Main1"));
+	TestEqual("Quest state should be re-used", Progression->GetQuest("Q_Main1"), Q);
+	TestEqual("Task state should be re-used", Progression->GetTaskState("Q_Main1", "T_CollectDoobries"), Doobries);
+	TestEqual("Task number should be reset", Doobries->GetNumber(), 0);
+	TestFalse("Task should be incomplete", Progression->IsTaskCompleted("Q_Main1", "T_ReachThePlace"));
+	TestEqual("Current objective should be the first", Q->GetCurrentObjective()->GetIdentifier(), FName("O1"));
+	TestTrue("First task should be relevant", Progression->IsTaskRelevant("Q_Main1", "T_ReachThePlace"));
+
+	// Loading re-uses the states too
+	Progression->ProgressTask("Q_Main1", "T_CollectDoobries", 3);
+	FSuqsSaveData Data;
+	Progression->SaveToData(Data);
+	Progression->ProgressTask("Q_Main1", "T_CollectDoobries", 1);
+	Progression->LoadFromData(Data);
+	TestEqual("Quest state should be re-used when loading", Progression->GetQuest("Q_Main1"), Q);
+	TestEqual("Task number should be loaded", Doobries->GetNumber(), 3);
+
+	// Nothing is re-used while events may still refer to it
+	Progression->BeginBatch();
+	Progression->RemoveQuest("Q_Main1");
+	TestTrue("Should be able to accept main quest in batch", Progression->AcceptQuest("Q_Main1"));
+	USuqsQuestState* BatchQ = Progression->GetQuest("Q_Main1");
+	TestNotEqual("Quest state should not be re-used in a batch", BatchQ, Q);
+	Progression->EndBatch();
+	TestEqual("New quest state should be registered", Progression->GetQuest("Q_Main1"), BatchQ);
+	Progression->RemoveQuest("Q_Main1");
+	TestTrue("Should be able to accept main quest after batch", Progression->AcceptQuest("Q_Main1"));
+	TestEqual("Latest removed state should be re-used after batch", Progression->GetQuest("Q_Main1"), BatchQ);
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FTestTaskStateStore, "SUQSTest.TaskStateStore",
+                                 EAutomationTestFlags::EditorContext |
+                                 EAutomationTestFlags::ClientContext |
+                                 EAutomationTestFlags::ProductFilter)
+
+bool FTestTaskStateStore::RunTest(const FString& Parameters)
+{
+	USuqsProgression* Progression = NewObject<USuqsProgression>();
+	Progression->InitWithQuestDataTables(
+        TArray<UDataTable*> {
+        	USuqsProgression::MakeQuestDataTableFromJSON(SimpleMainQuestJson)
+        }
+    );
+
+	// Task objects are only created when asked for
+	TestTrue("Should be able to accept main quest", Progression->AcceptQuest("Q_Main1"));
+	USuqsObjectiveState* O1 = Progression->GetQuest("Q_Main1")->GetCurrentObjective();
+	const int NumSlots = Progression->GetTaskStateStore().Num();
+	TestTrue("Accepting should allocate a slot per task", NumSlots > 0);
+	TestFalse("No task object before it's asked for", O1->HasTaskObject(0));
+	Progression->ProgressTask("Q_Main1", "T_CollectDoobries", 2);
+	const FSuqsTaskStateRef Doobries = Progression->FindTask("Q_Main1", "T_CollectDoobries");
+	if (TestEqual("Task should be found without a task object", Doobries.GetObjective(), O1))
+	{
+		TestEqual("Task number should be progressed", O1->GetTaskNumber(Doobries.TaskIndex), 2);
+		TestFalse("Progressing by name shouldn't create a task object", O1->HasTaskObject(Doobries.TaskIndex));
+	}
+	USuqsTaskState* Place = Progression->GetTaskState("Q_Main1", "T_ReachThePlace");
+	TestNotNull("Task object should be created on demand", Place);
+	TestTrue("Task object should be kept", O1->HasTaskObject(0));
+	TestEqual("Same task object should be returned", Progression->GetTaskState("Q_Main1", "T_ReachThePlace"), Place);
+
+	// Slots are re-used, not leaked, when a quest is accepted again
+	Progression->RemoveQuest("Q_Main1");
+	TestTrue("Should be able to accept main quest again", Progression->AcceptQuest("Q_Main1"));
+	TestEqual("Slots should be re-used", Progression->GetTaskStateStore().Num(), NumSlots);
+
+	// Two live states of the same quest don't share task state
+	Progression->CompleteTask("Q_Main1", "T_ReachThePlace");
+	USuqsQuestState* OldQ = Progression->GetQuest("Q_Main1");
+	Progression->BeginBatch();
+	Progression->RemoveQuest("Q_Main1");
+	TestTrue("Should be able to accept main quest in batch", Progression->AcceptQuest("Q_Main1"));
+	USuqsQuestState* NewQ = Progression->GetQuest("Q_Main1");
+	if (TestNotEqual("Should be a new quest state", NewQ, OldQ))
+	{
+		TestTrue("New quest state should start from scratch", NewQ->IsTaskIncomplete("T_ReachThePlace"));
+		TestTrue("Old quest state should keep its own task state", OldQ->IsTaskCompleted("T_ReachThePlace"));
+		TestEqual("Old and new states should have separate slots", Progression->GetTaskStateStore().Num(), NumSlots * 2);
+	}
+	Progression->EndBatch();
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FTestTaskRanges, "SUQSTest.TaskRanges",
+                                 EAutomationTestFlags::EditorContext |
+                                 EAutomationTestFlags::ClientContext |
+                                 EAutomationTestFlags::ProductFilter)
+
+bool FTestTaskRanges::RunTest(const FString& Parameters)
+{
+	USuqsProgression* Progression = NewObject<USuqsProgression>();
+	Progression->InitWithQuestDataTables(
+		TArray<UDataTable*> {
+			USuqsProgression::MakeQuestDataTableFromJSON(OrderedTasksQuestJson),
+			USuqsProgression::MakeQuestDataTableFromJSON(SmallestPossibleQuestJson)
+		}
+	);
+
+	TestTrue("Accept quest should work", Progression->AcceptQuest("Q_Ordered"));
+	TestTrue("Accept quest should work", Progression->AcceptQuest("Q_Smol"));
+	TestTrue("Complete task should work", Progression->CompleteTask("Q_Ordered", "T_1"));
+	auto Obj = Progression->GetQuest("Q_Ordered")->GetObjectives()[0];
+
+	// Ranges must give the same tasks as the array versions, in the same order
+	auto CheckRange = [this](const FString& What, const USuqsObjectiveState::FTaskRange& Range, const TArray<USuqsTaskState*>& Expected)
+	{
+		TArray<USuqsTaskState*> FromRange;
+		for (USuqsTaskState* T : Range)
+		{
+			FromRange.Add(T);
+		}
+		TestEqual(What + " range should match array", FromRange, Expected);
+		TestEqual(What + " range count should match array", Range.Num(), Expected.Num());
+		TestEqual(What + " range emptiness should match array", Range.IsEmpty(), Expected.Num() == 0);
+	};
+	TArray<USuqsTaskState*> Tasks;
+	Obj->GetAllRelevantTasks(Tasks);
+	CheckRange("Relevant", Obj->GetRelevantTasksRange(), Tasks);
+	TestTrue("Next task should be relevant", Tasks.Contains(Progression->GetTaskState("Q_Ordered", "T_2")));
+	Obj->GetIncompleteTasks(Tasks);
+	CheckRange("Incomplete", Obj->GetIncompleteTasksRange(), Tasks);
+	TestEqual("Two tasks should be incomplete", Tasks.Num(), 2);
+	Obj->GetCompletedTasks(Tasks);
+	CheckRange("Completed", Obj->GetCompletedTasksRange(), Tasks);
+	TestEqual("One task should be completed", Tasks.Num(), 1);
+	Obj->GetFailedTasks(Tasks);
+	CheckRange("Failed", Obj->GetFailedTasksRange(), Tasks);
+	TestTrue("No tasks should be failed", Obj->GetFailedTasksRange().IsEmpty());
+	TestEqual("Task view should have all tasks", Obj->GetTasksView().Num(), 3);
+
+	// Ranges see the current state
+	const auto Failed = Obj->GetFailedTasksRange();
+	Progression->FailTask("Q_Ordered", "T_2");
+	TestEqual("Failed range should see the change", Failed.Num(), 1);
+
+	// Quest maps match the arrays; archived identifiers don't need compact quests rebuilt
+	TArray<USuqsQuestState*> Quests;
+	Progression->GetAcceptedQuests(Quests);
+	TestEqual("Accepted map should match array", Progression->GetAcceptedQuestMap().Num(), Quests.Num());
+	TestTrue("Complete task should work", Progression->CompleteTask("Q_Smol", "T_Smol"));
+	Progression->CompactArchivedQuests();
+	int NumArchivedIDs = 0;
+	Progression->ForEachArchivedQuestIdentifier([&NumArchivedIDs](const FName&) { ++NumArchivedIDs; });
+	TestEqual("Both archived quests should be visited", NumArchivedIDs, 2);
+	TestEqual("Archived quests should still be compact", Progression->GetNumCompactArchivedQuests(), 2);
+	TestEqual("Archived map should only have full states", Progression->GetArchivedQuestMap().Num(), 0);
+
+	return true;
+}
+
+/// Quests with 3 objectives of 3 tasks each, for the memory tests
+static UDataTable* MakeGeneratedQuestTable(int NumQuests, int TargetNumber)
+{
+	UDataTable* Table = NewObject<UDataTable>();
+	Table->RowStruct = FSuqsQuest::StaticStruct();
+	for (int i = 0; i < NumQuests; ++i)
+	{
+		FSuqsQuest Quest;
+		Quest.Identifier = FName("Q_Gen", i);
+		Quest.Title = FText::AsNumber(i);
+		for (int o = 0; o < 3; ++o)
+		{
+			FSuqsObjective& Obj = Quest.Objectives.AddDefaulted_GetRef();
+			Obj.Identifier = FName("O", o);
+			for (int t = 0; t < 3; ++t)
+			{
+				FSuqsTask& Task = Obj.Tasks.AddDefaulted_GetRef();
+				Task.Identifier = FName("T", o * 3 + t);
+				Task.TargetNumber = TargetNumber;
+			}
+		}
+		Table->AddRow(Quest.Identifier, Quest);
+	}
+	return Table;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FTestAcceptedQuestMemory, "SUQSTest.Perf.AcceptedQuestMemory",
+								 EAutomationTestFlags::EditorContext |
+								 EAutomationTestFlags::ClientContext |
+								 EAutomationTestFlags::PerfFilter)
+
+bool FTestAcceptedQuestMemory::RunTest(const FString& Parameters)
+{
+	constexpr int NumQuests = 5000;
+
+	USuqsProgression* Progression = NewObject<USuqsProgression>();
+	// Nothing else references the progression, but it has to survive the collections below
+	Progression->AddToRoot();
+
+	Progression->InitWithQuestDataTables(TArray<UDataTable*> { MakeGeneratedQuestTable(NumQuests, 5) });
+	CollectGarbage(GARBAGE_COLLECTION_KEEPFLAGS);
+
+	double StartTime = FPlatformTime::Seconds();
+	CollectGarbage(GARBAGE_COLLECTION_KEEPFLAGS);
+	const double EmptyGCTime = FPlatformTime::Seconds() - StartTime;
+
+	StartTime = FPlatformTime::Seconds();
+	for (int i = 0; i < NumQuests; ++i)
+	{
+		Progression->AcceptQuest(FName("Q_Gen", i));
+		Progression->ProgressTask(FName("Q_Gen", i), FName("T", 0), 1);
+	}
+	const double AcceptTime = FPlatformTime::Seconds() - StartTime;
+
+	TArray<USuqsQuestState*> Accepted;
+	Progression->GetAcceptedQuests(Accepted);
+	TestEqual("All quests should be accepted", Accepted.Num(), NumQuests);
+
+	StartTime = FPlatformTime::Seconds();
+	CollectGarbage(GARBAGE_COLLECTION_KEEPFLAGS);
+	const double GCTime = FPlatformTime::Seconds() - StartTime;
+
+	// State objects; task state lives in the progression's store, task objects are only made when asked for
+	int NumQuestStates = 0, NumObjectiveStates = 0, NumTaskStates = 0;
+	for (TObjectIterator<USuqsQuestState> It; It; ++It) { ++NumQuestStates; }
+	for (TObjectIterator<USuqsObjectiveState> It; It; ++It) { ++NumObjectiveStates; }
+	for (TObjectIterator<USuqsTaskState> It; It; ++It)
+	{
+		if (It->GetRootProgression() == Progression)
+			++NumTaskStates;
+	}
+	TestEqual("No task states should have been created", NumTaskStates, 0);
+	const FSuqsTaskStateStore& Store = Progression->GetTaskStateStore();
+	TestTrue("Every accepted task should have a slot", Store.Num() >= NumQuests * 9);
+	const SIZE_T ObjectSize =
+		NumQuestStates * USuqsQuestState::StaticClass()->GetStructureSize() +
+		NumObjectiveStates * USuqsObjectiveState::StaticClass()->GetStructureSize() +
+		NumTaskStates * USuqsTaskState::StaticClass()->GetStructureSize();
+
+	AddInfo(FString::Printf(TEXT("%d accepted quests: accept %.1fms, GC %.1fms (%.1fms before accepting)"),
+		NumQuests, AcceptTime * 1000.0, GCTime * 1000.0, EmptyGCTime * 1000.0));
+	AddInfo(FString::Printf(TEXT("%d quest, %d objective, %d task states: %.1fKB of objects"),
+		NumQuestStates, NumObjectiveStates, NumTaskStates, ObjectSize / 1024.0));
+	AddInfo(FString::Printf(TEXT("%d task slots: %.1fKB"), Store.Num(), Store.GetAllocatedSize() / 1024.0));
+
+	Progression->RemoveFromRoot();
+	return true;
+}
+
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FTestArchivedQuestMemory, "SUQSTest.Perf.ArchivedQuestMemory",
+								 EAutomationTestFlags::EditorContext |
+								 EAutomationTestFlags::ClientContext |
+								 EAutomationTestFlags::PerfFilter)
+
+bool FTestArchivedQuestMemory::RunTest(const FString& Parameters)
+{
+	constexpr int NumQuests = 5000;
+
+	USuqsProgression* Progression = NewObject<USuqsProgression>();
+	// Nothing else references the progression, but it has to survive the collections below
+	Progression->AddToRoot();
+	Progression->InitWithQuestDataTables(TArray<UDataTable*> { MakeGeneratedQuestTable(NumQuests, 1) });
+
+	for (int i = 0; i < NumQuests; ++i)
+	{
+		Progression->AcceptQuest(FName("Q_Gen", i));
+		Progression->CompleteQuest(FName("Q_Gen", i));
+	}
+	TArray<FName> ArchivedIDs;
+	Progression->GetArchivedQuestIdentifiers(ArchivedIDs);
+	TestEqual("All quests should be archived", ArchivedIDs.Num(), NumQuests);
+
+	auto CountStates = [](int& OutNumQuests, int& OutNumObjectives, int& OutNumTasks) -> SIZE_T
+	{
+		OutNumQuests = OutNumObjectives = OutNumTasks = 0;
+		for (TObjectIterator<USuqsQuestState> It; It; ++It) { ++OutNumQuests; }
+		for (TObjectIterator<USuqsObjectiveState> It; It; ++It) { ++OutNumObjectives; }
+		for (TObjectIterator<USuqsTaskState> It; It; ++It) { ++OutNumTasks; }
+		return OutNumQuests * USuqsQuestState::StaticClass()->GetStructureSize() +
+			OutNumObjectives * USuqsObjectiveState::StaticClass()->GetStructureSize() +
+			OutNumTasks * USuqsTaskState::StaticClass()->GetStructureSize();
+	};
+	int NumQuestStates, NumObjectiveStates, NumTaskStates;
+
+	// Full state trees
+	CollectGarbage(GARBAGE_COLLECTION_KEEPFLAGS);
+	double StartTime = FPlatformTime::Seconds();
+	CollectGarbage(GARBAGE_COLLECTION_KEEPFLAGS);
+	const double StatesGCTime = FPlatformTime::Seconds() - StartTime;
+	const SIZE_T StatesSize = CountStates(NumQuestStates, NumObjectiveStates, NumTaskStates);
+	AddInfo(FString::Printf(TEXT("%d archived quest states: GC %.1fms, %d objects, %.1fKB"),
+		NumQuests, StatesGCTime * 1000.0, NumQuestStates + NumObjectiveStates + NumTaskStates, StatesSize / 1024.0));
+
+	// Compact records
+	StartTime = FPlatformTime::Seconds();
+	TestEqual("All quests should be compacted", Progression->CompactArchivedQuests(), NumQuests);
+	const double CompactTime = FPlatformTime::Seconds() - StartTime;
+	CollectGarbage(GARBAGE_COLLECTION_KEEPFLAGS);
+	StartTime = FPlatformTime::Seconds();
+	CollectGarbage(GARBAGE_COLLECTION_KEEPFLAGS);
+	const double RecordsGCTime = FPlatformTime::Seconds() - StartTime;
+	CountStates(NumQuestStates, NumObjectiveStates, NumTaskStates);
+	TestTrue("Quest states should have been released", NumQuestStates < NumQuests);
+	const SIZE_T RecordsSize = Progression->GetArchivedQuestRecordsAllocatedSize();
+	AddInfo(FString::Printf(TEXT("%d compact archived quests: compact %.1fms, GC %.1fms, %d objects left, %.1fKB of records"),
+		NumQuests, CompactTime * 1000.0, RecordsGCTime * 1000.0, NumQuestStates + NumObjectiveStates + NumTaskStates, RecordsSize / 1024.0));
+
+	// Status queries stay compact, only getting the quest rebuilds
+	StartTime = FPlatformTime::Seconds();
+	for (int i = 0; i < NumQuests; ++i)
+	{
+		TestTrue("Quest should be completed", Progression->IsQuestCompleted(FName("Q_Gen", i)));
+		TestTrue("Task should be completed", Progression->IsTaskCompleted(FName("Q_Gen", i), FName("T", 8)));
+	}
+	const double QueryTime = FPlatformTime::Seconds() - StartTime;
+	TestEqual("Queries shouldn't rebuild states", Progression->GetNumCompactArchivedQuests(), NumQuests);
+	AddInfo(FString::Printf(TEXT("Querying %d compact archived quests: %.1fms"), NumQuests, QueryTime * 1000.0));
+	StartTime = FPlatformTime::Seconds();
+	for (int i = 0; i < NumQuests; ++i)
+	{
+		Progression->GetQuest(FName("Q_Gen", i));
+	}
+	const double HydrateTime = FPlatformTime::Seconds() - StartTime;
+	TestEqual("All archived quests should be rebuilt", Progression->GetArchivedQuestMap().Num(), NumQuests);
+	AddInfo(FString::Printf(TEXT("Rebuilding %d archived quests: %.1fms"), NumQuests, HydrateTime * 1000.0));
+
+	Progression->RemoveFromRoot();
+	return true;
+}
+
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FTestQuestStateGCScaling, "SUQSTest.Perf.QuestStateGCScaling",
+								 EAutomationTestFlags::EditorContext |
+								 EAutomationTestFlags::ClientContext |
+								 EAutomationTestFlags::PerfFilter)
+
+bool FTestQuestStateGCScaling::RunTest(const FString& Parameters)
+{
+	constexpr int MaxQuests = 8000;
+
+	USuqsProgression* Progression = NewObject<USuqsProgression>();
+	// Nothing else references the progression, but it has to survive the collections below
+	Progression->AddToRoot();
+	Progression->InitWithQuestDataTables(TArray<UDataTable*> { MakeGeneratedQuestTable(MaxQuests, 5) });
+
+	auto TimeGC = []()
+	{
+		CollectGarbage(GARBAGE_COLLECTION_KEEPFLAGS);
+		const double StartTime = FPlatformTime::Seconds();
+		CollectGarbage(GARBAGE_COLLECTION_KEEPFLAGS);
+		return FPlatformTime::Seconds() - StartTime;
+	};
+	AddInfo(FString::Printf(TEXT("No quests: GC %.1fms"), TimeGC() * 1000.0));
+
+	// Quest states only reference their objectives, and objectives their tasks; nothing else holds reflected
+	// references to tasks, so each task is reached once
+	Progression->AcceptQuest(FName("Q_Gen", 0));
+	Progression->ProgressTask(FName("Q_Gen", 0), FName("T", 0), 1);
+	TArray<UObject*> Refs;
+	FReferenceFinder QuestRefFinder(Refs);
+	QuestRefFinder.FindReferences(Progression->GetQuest(FName("Q_Gen", 0)));
+	TestEqual("Quest state should only reference its objectives", Refs.Num(), 3);
+
+	// Active quest states are traversed on every collection, compact archived quests aren't objects at all
+	int NumAccepted = 1;
+	for (int NumQuests = 1000; NumQuests <= MaxQuests; NumQuests *= 2)
+	{
+		for (; NumAccepted < NumQuests; ++NumAccepted)
+		{
+			Progression->AcceptQuest(FName("Q_Gen", NumAccepted));
+			Progression->ProgressTask(FName("Q_Gen", NumAccepted), FName("T", 0), 1);
+		}
+		const double ActiveGCTime = TimeGC();
+		AddInfo(FString::Printf(TEXT("%d active quests (%d tasks): GC %.1fms"),
+			NumQuests, NumQuests * 9, ActiveGCTime * 1000.0));
+	}
+
+	for (int i = 0; i < NumAccepted; ++i)
+	{
+		Progression->CompleteQuest(FName("Q_Gen", i));
+	}
+	const double ArchivedGCTime = TimeGC();
+	TestEqual("All quests should be compacted", Progression->CompactArchivedQuests(), NumAccepted);
+	const double CompactGCTime = TimeGC();
+	AddInfo(FString::Printf(TEXT("%d archived quests (%d tasks): GC %.1fms as states, %.1fms compacted"),
+		NumAccepted, NumAccepted * 9, ArchivedGCTime * 1000.0, CompactGCTime * 1000.0));
+
+	Progression->RemoveFromRoot();
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FTestQuestDataAsyncHeldCalls, "SUQSTest.QuestDataAsyncHeldCalls",
+								 EAutomationTestFlags::EditorContext |
+								 EAutomationTestFlags::ClientContext |
+								 EAutomationTestFlags::ProductFilter)
+
+bool FTestQuestDataAsyncHeldCalls::RunTest(const FString& Parameters)
+{
+	// Needs to survive across frames while the tables stream in
+	USuqsProgression* Progression = NewObject<USuqsProgression>();
+	Progression->AddToRoot();
+	UDataTable* Table = USuqsProgression::MakeQuestDataTableFromJSON(SimpleMainQuestJson);
+	Table->AddToRoot();
+
+	Progression->InitWithQuestDataTablesAsync(TArray<TSoftObjectPtr<UDataTable>> { Table });
+	const bool bWasLoading = Progression->IsQuestDataLoading();
+	if (!bWasLoading)
+	{
+		AddInfo("Quest data loaded synchronously, held calls were run straight away");
+	}
+
+	// Completing before accepting should do nothing even though both were held; this raises a warning
+	LogSUQS.SetVerbosity(ELogVerbosity::NoLogging);
+	Progression->CompleteTask("Q_Main1", "T_ReachThePlace");
+	TestTrue("Accept should succeed or be held", Progression->AcceptQuest("Q_Main1"));
+	// Outlives this function if the call is held
+	TSharedRef<int32> NumOwnCallsRun = MakeShared<int32>(0);
+	Progression->CallWhenQuestDataReady([this, Progression, NumOwnCallsRun]()
+	{
+		++*NumOwnCallsRun;
+		TestEqual("Quest should have been accepted by now", Progression->GetQuestStatus("Q_Main1"), ESuqsQuestStatus::Incomplete);
+		TestFalse("Task completed before accept should not be complete", Progression->IsTaskCompleted("Q_Main1", "T_ReachThePlace"));
+		TestFalse("Task completed after this should not be complete yet", Progression->IsTaskCompleted("Q_Main1", "T_DoTheThing"));
+	});
+	Progression->CompleteTask("Q_Main1", "T_DoTheThing");
+	const int Outstanding = Progression->ProgressTask("Q_Main1", "T_CollectDoobries", 2);
+	Progression->SetTaskNumberCompleted("Q_Main1", "T_CollectDoobries", 4);
+	Progression->ProgressTask("Q_Main1", "T_CollectDoobries", -1);
+	Progression->SetGateOpen("G_Door", true);
+	Progression->SetGateOpen("G_Door", false);
+	Progression->SetGlobalQuestBranchActive("GB_One", true);
+	Progression->ResetGlobalQuestBranches();
+	Progression->SetGlobalQuestBranchActive("GB_Two", true);
+
+	// Definition changes are held too, the template doesn't exist until loading has finished
+	FSuqsQuestInstance Instance;
+	Instance.Identifier = "Q_Main1Instance";
+	TestTrue("Create instance should succeed or be held", Progression->CreateQuestInstance("Q_Main1", Instance));
+	Progression->AcceptQuest("Q_Main1Instance");
+	FSuqsQuest Extra;
+	Extra.Identifier = "Q_HeldExtra";
+	FSuqsObjective& ExtraObjective = Extra.Objectives.AddDefaulted_GetRef();
+	ExtraObjective.Identifier = "O_Extra";
+	ExtraObjective.Tasks.AddDefaulted_GetRef().Identifier = "T_Extra";
+	TestTrue("Create definition should succeed or be held", Progression->CreateQuestDefinition(Extra));
+	Progression->AcceptQuest("Q_HeldExtra");
+	TestTrue("Delete definition should succeed or be held", Progression->DeleteQuestDefinition("Q_HeldExtra"));
+
+	if (bWasLoading)
+	{
+		TestNull("Held definition should not exist yet", Progression->GetQuestDefinition("Q_Main1Instance"));
+		TestEqual("Held progress should return -1", Outstanding, -1);
+		TestEqual("Quest should not be accepted while loading", Progression->GetQuestStatus("Q_Main1"), ESuqsQuestStatus::Unavailable);
+		TestEqual("Held calls should not have run", *NumOwnCallsRun, 0);
+	}
+
+	ADD_LATENT_AUTOMATION_COMMAND(FFunctionLatentCommand([this, Progression, Table, NumOwnCallsRun]()
+	{
+		if (Progression->IsQuestDataLoading())
+			return false;
+
+		LogSUQS.SetVerbosity(ELogVerbosity::Verbose);
+		TestEqual("Our own held call should have run once", *NumOwnCallsRun, 1);
+		TestEqual("Quest should be accepted", Progression->GetQuestStatus("Q_Main1"), ESuqsQuestStatus::Incomplete);
+		TestFalse("Task completed before accept should not be complete", Progression->IsTaskCompleted("Q_Main1", "T_ReachThePlace"));
+		TestTrue("Task completed after accept should be complete", Progression->IsTaskCompleted("Q_Main1", "T_DoTheThing"));
+		if (auto T = Progression->GetTaskState("Q_Main1", "T_CollectDoobries"))
+		{
+			TestEqual("Progress calls should have run in order", T->GetNumber(), 3);
+		}
+		else
+		{
+			AddError("Missing task T_CollectDoobries");
+		}
+		TestFalse("Gate should have been opened then closed", Progression->IsGateOpen("G_Door"));
+		TestFalse("Global branch should have been reset", Progression->IsGlobalQuestBranchActive("GB_One"));
+		TestTrue("Global branch set after reset should be active", Progression->IsGlobalQuestBranchActive("GB_Two"));
+		TestEqual("Held instance should be created then accepted", Progression->GetQuestStatus("Q_Main1Instance"), ESuqsQuestStatus::Incomplete);
+		TestNull("Held definition should be created then deleted", Progression->GetQuestDefinition("Q_HeldExtra"));
+		TestEqual("Deleted quest should not be accepted", Progression->GetQuestStatus("Q_HeldExtra"), ESuqsQuestStatus::Unavailable);
+
+		Table->RemoveFromRoot();
+		Progression->RemoveFromRoot();
+		return true;
+	}));
+
+	return true;
+}
@@ -20,8 +20,10 @@ bool FTestQuestTimeLimitSimple::RunTest(const FString& Parameters)
         }
     );
 
+	TestFalse("Nothing should need ticking before any quests are accepted", Progression->IsTickable());
 	TestTrue("Accept quest OK", Progression->AcceptQuest("Q_TimeLimits"));
 	TestTrue("Quest should be incomplete", Progression->IsQuestIncomplete("Q_TimeLimits"));
+	TestTrue("Time limited task should need ticking", Progression->IsTickable());
 
 	// Manually tick
 	Progression->Tick(10);
@@ -36,6 +38,7 @@ bool FTestQuestTimeLimitSimple::RunTest(const FString& Parameters)
 	TestTrue("Quest should have failed due to timeout", Progression->IsQuestFailed("Q_TimeLimits"));
 	TestTrue("Objective should have failed due to timeout", Progression->IsObjectiveFailed("Q_TimeLimits", "O_Single"));
 	TestTrue("Task should have failed due to timeout", Progression->IsTaskFailed("Q_TimeLimits", "T_Single"));
+	TestFalse("Nothing should need ticking once timers have expired", Progression->IsTickable());
 	
 	return true;
 }
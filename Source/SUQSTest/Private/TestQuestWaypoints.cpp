@@ -0,0 +1,76 @@
+#include "Misc/AutomationTest.h"
+#include "Engine.h"
+#include "SuqsProgression.h"
+#include "SuqsTaskState.h"
+#include "SuqsWaypointComponent.h"
+#include "TestQuestData.h"
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FTestQuestWaypointCache, "SUQSTest.QuestWaypointCache",
+								 EAutomationTestFlags::EditorContext |
+								 EAutomationTestFlags::ClientContext |
+								 EAutomationTestFlags::ProductFilter)
+
+bool FTestQuestWaypointCache::RunTest(const FString& Parameters)
+{
+	// Waypoints need a game instance & world to register with
+	UGameInstance* GI = NewObject<UGameInstance>(GEngine);
+	GI->AddToRoot();
+	GI->InitializeStandalone();
+	UWorld* World = GI->GetWorld();
+	if (!TestNotNull("Should have a world", World))
+	{
+		GI->Shutdown();
+		GI->RemoveFromRoot();
+		return false;
+	}
+
+	// Deliberately not linked to the waypoint subsystem with SetProgression, caches must still be kept up to date
+	USuqsProgression* Progression = NewObject<USuqsProgression>(GI);
+	Progression->InitWithQuestDataTables(
+		TArray<UDataTable*> {
+			USuqsProgression::MakeQuestDataTableFromJSON(SimpleMainQuestJson)
+		}
+	);
+	TestTrue("Accept quest", Progression->AcceptQuest("Q_Main1"));
+	auto T1 = Progression->GetTaskState("Q_Main1", "T_ReachThePlace");
+	auto T2 = Progression->GetTaskState("Q_Main1", "T_DoTheThing");
+
+	// Cache the empty lists first
+	TestEqual("No waypoints to start with", T1->GetWaypoints(false).Num(), 0);
+	TestEqual("No waypoints to start with", T2->GetWaypoints(false).Num(), 0);
+
+	AActor* Actor = World->SpawnActor<AActor>();
+	auto W1 = NewObject<USuqsWaypointComponent>(Actor);
+	W1->RegisterComponent();
+	W1->Initialise("Q_Main1", "T_ReachThePlace", 0);
+	TestEqual("Registering should update the cached waypoints", T1->GetWaypoints(false).Num(), 1);
+	TestEqual("Registered waypoint should be returned", T1->GetWaypoint(false), W1);
+	TestEqual("Other task should not have waypoints", T2->GetWaypoints(false).Num(), 0);
+
+	// Re-initialising unregisters from the old task and registers with the new one
+	W1->Initialise("Q_Main1", "T_DoTheThing", 1);
+	TestEqual("Unregistering should update the cached waypoints", T1->GetWaypoints(false).Num(), 0);
+	TestNull("Unregistered waypoint should not be returned", T1->GetWaypoint(false));
+	TestEqual("Newly registered task should have the waypoint", T2->GetWaypoints(false).Num(), 1);
+
+	auto W2 = NewObject<USuqsWaypointComponent>(Actor);
+	W2->RegisterComponent();
+	W2->Initialise("Q_Main1", "T_DoTheThing", 0);
+	const auto Waypoints = T2->GetWaypoints(false);
+	TestEqual("Second waypoint should be added to the cache", Waypoints.Num(), 2);
+	if (Waypoints.Num() == 2)
+	{
+		TestEqual("Waypoints should be in sequence order", Waypoints[0], W2);
+		TestEqual("Waypoints should be in sequence order", Waypoints[1], W1);
+	}
+	W2->SetEnabled(false);
+	TestEqual("Disabled waypoint should be skipped", T2->GetWaypoint(true), W1);
+
+	Actor->Destroy();
+	GI->Shutdown();
+	GEngine->DestroyWorldContext(World);
+	World->DestroyWorld(false);
+	GI->RemoveFromRoot();
+
+	return true;
+}